@@ -343,7 +343,7 @@ void hw_init(void)
 #endif
 }
 
-#ifdef CONFIG_DATAFLASH
+#if defined(CONFIG_DATAFLASH) || defined(CONFIG_BOOT_FALLBACK)
 
 #if defined(CONFIG_QSPI)
 void at91_qspi_hw_init(void)
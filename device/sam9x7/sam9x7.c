@@ -341,7 +341,7 @@ void hw_init(void)
 #endif
 }
 
-#ifdef CONFIG_DATAFLASH
+#if defined(CONFIG_DATAFLASH) || defined(CONFIG_BOOT_FALLBACK)
 
 #if defined(CONFIG_AT91_QSPI_OCTAL)
 void at91_qspi_hw_init(void)
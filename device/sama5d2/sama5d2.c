@@ -2,6 +2,7 @@
 //
 // SPDX-License-Identifier: MIT
 
+#include "backup.h"
 #include "common.h"
 #include "sama5d2_board.h"
 #include "ddramc.h"
@@ -492,8 +493,15 @@ void hw_init(void)
 
 	at91_disable_wdt();
 
+	/*
+	 * Latch the Backup+Self-Refresh state from SECUMOD and SECURAM only
+	 * now, with the backup area powered and the watchdog off.
+	 */
+	backup_resume();
+
 #ifdef CONFIG_LED_ON_BOARD
-	at91_leds_init();
+	if (!backup_resume())
+		at91_leds_init();
 #endif
 
 	pmc_cfg_plla(PLLA_SETTINGS);
@@ -521,8 +529,11 @@ void hw_init(void)
 	timer_init();
 
 #if defined(CONFIG_TWI)
-	flexcoms_init(flexcoms);
-	twi_init();
+	/* Nothing talks to the TWI devices on the way back to Linux */
+	if (!backup_resume()) {
+		flexcoms_init(flexcoms);
+		twi_init();
+	}
 #endif
 
 	ddram_init();
@@ -537,10 +548,12 @@ void hw_init(void)
 #endif
 
 #ifdef CONFIG_BOARD_QUIRK_SAMA5D2_ICP
-	at91_can_stdby_dis();
+	if (!backup_resume()) {
+		at91_can_stdby_dis();
 
-	/* Reset peripherals*/
-	peripherals_hw_reset();
+		/* Reset peripherals*/
+		peripherals_hw_reset();
+	}
 #endif
 }
 
@@ -286,7 +286,7 @@ void hw_init(void)
 #endif
 }
 
-#ifdef CONFIG_DATAFLASH
+#if defined(CONFIG_DATAFLASH) || defined(CONFIG_BOOT_FALLBACK)
 void at91_spi0_hw_init(void)
 {
 	/* Configure PIN for SPI0 */
@@ -566,7 +566,7 @@ static void umctl2_config_state_init()
 #endif
 }
 
-#ifdef CONFIG_DATAFLASH
+#if defined(CONFIG_DATAFLASH) || defined(CONFIG_BOOT_FALLBACK)
 #if defined(CONFIG_QSPI)
 void at91_qspi_hw_init(void)
 {
@@ -1158,6 +1158,13 @@ void hw_init(void)
 #ifdef CONFIG_WDTS
 	at91_disable_wdts();
 #endif
+
+	/*
+	 * Latch the Backup+Self-Refresh state from SECUMOD and SECURAM only
+	 * now, with the backup area powered and the watchdogs off.
+	 */
+	backup_resume();
+
 	/* SMP is needed for L2 cache in cortex A7 */
 	ca7_enable_smp();
 
@@ -1199,7 +1206,8 @@ void hw_init(void)
 
 	flexcoms_init(flexcoms);
 #ifdef CONFIG_LED_ON_BOARD
-	at91_leds_init();
+	if (!backup_resume())
+		at91_leds_init();
 #endif
 
 #if defined(CONFIG_MATRIX)
@@ -1212,7 +1220,9 @@ void hw_init(void)
 	timer_init();
 
 #ifdef CONFIG_TWI
-	twi_init();
+	/* Nothing talks to the TWI devices on the way back to Linux */
+	if (!backup_resume())
+		twi_init();
 #endif
 #if defined(CONFIG_MATRIX)
 	matrix_read_slave_security(AT91C_BASE_MATRIX, MATRIX_SLAVE_MAX);
@@ -1245,19 +1255,24 @@ void hw_init(void)
 	pmc_mck_cfg_set(2, BOARD_PRESCALER_MCK2,
 			AT91C_MCR_DIV | AT91C_MCR_CSS | AT91C_MCR_EN);
 
-	/* Configure & Enable IMG PLL */
-	imgpll_config.mul = 43; /* (43 + 1) * 24 = 1056 */
-	imgpll_config.div = 3;
-	imgpll_config.divio = 3;
-	imgpll_config.count = 0x3f;
-	imgpll_config.fracr = 0x155555; /* (8/24) * 2^22 to get extra 8 MHz */
-	imgpll_config.acr = 0x00070010;
-	/* IMGPLL @ 1064 MHz */
-	pmc_sam9x60_cfg_pll(PLL_ID_IMGPLL, &imgpll_config);
-
-	/* MCK3 @ 266 MHz */
-	pmc_mck_cfg_set(3, BOARD_PRESCALER_MCK3,
-			AT91C_MCR_DIV | AT91C_MCR_CSS | AT91C_MCR_EN);
+	/*
+	 * Configure & Enable IMG PLL. Not on the way back to Linux, which
+	 * restores the clocks it left running, the DDR does not need it.
+	 */
+	if (!backup_resume()) {
+		imgpll_config.mul = 43; /* (43 + 1) * 24 = 1056 */
+		imgpll_config.div = 3;
+		imgpll_config.divio = 3;
+		imgpll_config.count = 0x3f;
+		imgpll_config.fracr = 0x155555; /* (8/24) * 2^22 to get extra 8 MHz */
+		imgpll_config.acr = 0x00070010;
+		/* IMGPLL @ 1064 MHz */
+		pmc_sam9x60_cfg_pll(PLL_ID_IMGPLL, &imgpll_config);
+
+		/* MCK3 @ 266 MHz */
+		pmc_mck_cfg_set(3, BOARD_PRESCALER_MCK3,
+				AT91C_MCR_DIV | AT91C_MCR_CSS | AT91C_MCR_EN);
+	}
 
 	if (!backup_resume())
 		dbg_printf("MCK: mck domains initialization complete.\n");
@@ -1277,7 +1292,8 @@ void hw_init(void)
 	at91_init_can_message_ram();
 
 #ifdef CONFIG_BOARD_QUIRK_SAMA7G5_EK
-	at91_can_stdby_dis();
+	if (!backup_resume())
+		at91_can_stdby_dis();
 #endif
 
 	usb_utmi_clk_fix();
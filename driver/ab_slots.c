@@ -0,0 +1,115 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "common.h"
+#include "hardware.h"
+#include "string.h"
+#include "secure.h"
+#include "debug.h"
+#include "gpbr.h"
+
+/*
+ * The slot to boot and the boots attempted from it are kept in a backup
+ * register, which survives the resets of the watchdog:
+ * - magic in bits 31:24,
+ * - the slot B flag,
+ * - the attempts in bits 7:0, cleared by the OS once it booted well.
+ * A slot whose image does not check is left at once, without being read
+ * again, and a slot which failed to boot too many times is given up.
+ */
+#define AB_REG			(AT91C_BASE_GPBR + 4 * CONFIG_AB_GPBR)
+#define AB_MAGIC		(0xabUL << 24)
+#define AB_MAGIC_MASK		(0xffUL << 24)
+#define AB_SLOT_B		(0x1UL << 8)
+#define AB_ATTEMPTS_MASK	0xffUL
+
+#define AB_SLOT_NAME(slot)	((slot) ? 'B' : 'A')
+
+static void ab_setup_slot(struct image_info *image, unsigned int slot)
+{
+#if defined(CONFIG_DATAFLASH) || defined(CONFIG_NANDFLASH) || defined(CONFIG_FLASH)
+	image->offset = get_image_load_offset(slot ?
+				CONFIG_AB_IMG_ADDRESS_B : IMG_ADDRESS);
+#ifdef CONFIG_OF_LIBFDT
+	image->of_offset = get_image_load_offset(slot ?
+				CONFIG_AB_OF_OFFSET_B : OF_OFFSET);
+#endif
+#endif
+
+#ifdef CONFIG_FATFS
+	strcpy(image->filename, slot ? CONFIG_AB_IMAGE_NAME_B : IMAGE_NAME);
+#endif
+}
+
+/* The loaders checked the uImage header, this needs the whole image */
+static int ab_check_image(struct image_info *image)
+{
+#ifdef CONFIG_SECURE
+	if (secure_check(image->dest))
+		return -1;
+#endif
+
+#ifdef CONFIG_LINUX_IMAGE
+#ifdef CONFIG_SECURE
+	if (kernel_check_data(image->dest + sizeof(at91_secure_header_t)))
+#else
+	if (kernel_check_data(image->dest))
+#endif
+		return -1;
+#endif
+
+	return 0;
+}
+
+static int ab_load_slot(struct image_info *image,
+			load_function load_func,
+			unsigned int slot)
+{
+	int ret;
+
+	dbg_info("A/B: Loading slot %c\n", AB_SLOT_NAME(slot));
+
+	ab_setup_slot(image, slot);
+
+	ret = load_func(image);
+	if (ret)
+		return ret;
+
+	return ab_check_image(image);
+}
+
+int ab_load_image(struct image_info *image)
+{
+	load_function load_func = get_media_load_func();
+	unsigned int state = readl(AB_REG);
+	unsigned int slot = 0;
+	unsigned int attempts = 0;
+	int ret;
+
+	if ((state & AB_MAGIC_MASK) == AB_MAGIC) {
+		slot = (state & AB_SLOT_B) ? 1 : 0;
+		attempts = state & AB_ATTEMPTS_MASK;
+	}
+
+	if (attempts >= CONFIG_AB_MAX_ATTEMPTS) {
+		dbg_info("A/B: Slot %c failed to boot %d times\n",
+			 AB_SLOT_NAME(slot), attempts);
+		slot ^= 1;
+		attempts = 0;
+	}
+
+	ret = ab_load_slot(image, load_func, slot);
+	if (ret == -1) {
+		dbg_info("A/B: Slot %c is bad\n", AB_SLOT_NAME(slot));
+		slot ^= 1;
+		attempts = 0;
+		ret = ab_load_slot(image, load_func, slot);
+	}
+
+	if (!ret)
+		writel(AB_MAGIC | (slot ? AB_SLOT_B : 0) | (attempts + 1),
+		       AB_REG);
+
+	return ret;
+}
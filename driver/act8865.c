@@ -91,7 +91,11 @@ int act8865_set_reg_voltage(unsigned char volt_reg, unsigned char value)
 	    (enable_reg == REG3_2))
 		return 0;
 
-	/* Enable Regulator */
+	/*
+	 * Enable Regulator. The ACT8865 registers are written one per
+	 * transfer, adjacent ones are not merged, as in the I2C disable
+	 * sequence.
+	 */
 	data = 0;
 	ret = act8865_read(enable_reg, &data);
 	if (ret)
@@ -190,6 +194,10 @@ static int act8865_disable_i2c_sequence(unsigned char data)
 {
 	int ret;
 
+	/*
+	 * The errata sequence is three single register writes: registers
+	 * 0x02 and 0x03 are not merged in one auto-increment transfer.
+	 */
 	ret = act8865_write(REGS_0B, data);
 	if (ret)
 		return -1;
@@ -106,41 +106,56 @@ void qspi_writel(u32 value, struct qspi_priv *qspi, u32 reg)
 	writel(value, qspi->reg_base + reg);
 }
 
-int qspi_loadimage(struct image_info *image)
+static struct spi_flash qspi_sf;
+static struct qspi_priv qspi_dev;
+static int qspi_probed;		/* 1: probed, -1: failed */
+
+int qspi_probe(void)
 {
 	const struct spi_flash_hwcaps hwcaps = {
 		.mask = (SFLASH_HWCAPS_READ_MASK |
 			 SFLASH_HWCAPS_PP_MASK),
 	};
-	struct spi_flash flash;
-	struct qspi_priv qspi;
 	int ret;
 
-	memset(&qspi, 0, sizeof(qspi));
-	qspi.reg_base = CONFIG_SYS_BASE_QSPI;
-	qspi.mem = (void *)CONFIG_SYS_BASE_QSPI_MEM;
-	qspi.mmap_size = CONFIG_SYS_QSPI_MEM_SIZE;
+	if (qspi_probed)
+		return (qspi_probed > 0) ? 0 : -1;
+	qspi_probed = -1;
+
+	memset(&qspi_dev, 0, sizeof(qspi_dev));
+	qspi_dev.reg_base = CONFIG_SYS_BASE_QSPI;
+	qspi_dev.mem = (void *)CONFIG_SYS_BASE_QSPI_MEM;
+	qspi_dev.mmap_size = CONFIG_SYS_QSPI_MEM_SIZE;
 
-	memset(&flash, 0, sizeof(flash));
-	flash.ops = &qspi_ops;
-	spi_flash_set_priv(&flash, &qspi);
+	memset(&qspi_sf, 0, sizeof(qspi_sf));
+	qspi_sf.ops = &qspi_ops;
+	spi_flash_set_priv(&qspi_sf, &qspi_dev);
 
 	/* Init the SPI controller. */
-	ret = spi_flash_init(&flash);
+	ret = spi_flash_init(&qspi_sf);
 	if (ret) {
 		dbg_info("SF: Fail to initialize spi\n");
 		return -1;
 	}
 
 	/* Probe the SPI flash memory. */
-	ret = spi_nor_probe(&flash, &hwcaps);
+	ret = spi_nor_probe(&qspi_sf, &hwcaps);
 	if (ret) {
 		dbg_info("SF: Fail to probe SPI flash\n");
-		spi_flash_cleanup(&flash);
+		spi_flash_cleanup(&qspi_sf);
 		return -1;
 	}
 
-	return spi_flash_loadimage(&flash, image);
+	qspi_probed = 1;
+	return 0;
+}
+
+int qspi_loadimage(struct image_info *image)
+{
+	if (qspi_probe())
+		return -1;
+
+	return spi_flash_loadimage(&qspi_sf, image);
 }
 
 int qspi_xip(struct spi_flash *flash, void **mem)
@@ -95,6 +95,23 @@ void mdelay(unsigned int msec)
 	} while (current < delay);
 }
 
+/*
+ * The PIT is programmed with the maximum PIV, so PICNT:CPIV read back
+ * from PIIR behaves as a free running 32-bit counter at MCK / 16.
+ */
+unsigned int timer_get_counter(void)
+{
+	return at91_get_pit_value();
+}
+
+unsigned int timer_get_rate(void)
+{
+	if (pmc_mck_check_h32mxdiv())
+		return (MASTER_CLOCK / 2) / 16;
+	else
+		return MASTER_CLOCK / 16;
+}
+
 /* Init a special timer for slow clock switch function */
 static int timer1_base;
 
@@ -0,0 +1,192 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "common.h"
+#include "hardware.h"
+#include "pmc.h"
+#include "arch/at91_sha.h"
+#include "hash.h"
+#include "string.h"
+
+#ifdef CONFIG_SHA_DMA
+#include "xdmac.h"
+#endif
+
+#define SHA_BLOCK_WORDS		(SHA256_BLOCK_SIZE / 4)
+
+/* Below this, programming the DMA costs more than writing the words */
+#define SHA_DMA_MIN_SIZE	(4 * SHA256_BLOCK_SIZE)
+
+static inline unsigned int sha_readl(unsigned int reg)
+{
+	return readl(AT91C_BASE_SHA + reg);
+}
+
+static inline void sha_writel(unsigned int reg, unsigned int value)
+{
+	writel(value, AT91C_BASE_SHA + reg);
+}
+
+/*
+ * The message is written block by block to IDATAR0, by the CPU or by the
+ * DMA, and the padding is done here: the SHA only sees whole blocks.
+ */
+static struct {
+	unsigned int	count;		/* bytes hashed so far */
+	unsigned int	first;		/* the next block starts the message */
+	unsigned int	busy;		/* a block is being processed */
+	unsigned int	buf[SHA_BLOCK_WORDS];
+} sha;
+
+#ifdef CONFIG_SHA_DMA
+static struct xdmac_hwcfg sha_dma_hwcfg = {
+	.pid = AT91C_ID_SHA,
+	.cid = 1,
+	.src_is_periph = 0,
+	.dst_is_periph = 1,
+	.txif = CONFIG_SHA_DMA_PERID,
+};
+
+static unsigned int sha_dma_busy;
+#endif
+
+static void at91_sha_wait(void)
+{
+#ifdef CONFIG_SHA_DMA
+	if (sha_dma_busy) {
+		xdmac_transfer_wait_for_completion(&sha_dma_hwcfg);
+		xdmac_transfer_stop(&sha_dma_hwcfg);
+		sha_dma_busy = 0;
+	}
+#endif
+
+	if (sha.busy)
+		while (!(sha_readl(SHA_ISR) & SHA_ISR_DATRDY))
+			;
+	sha.busy = 0;
+}
+
+static void at91_sha_start(void)
+{
+	at91_sha_wait();
+
+	if (sha.first) {
+		sha_writel(SHA_CR, SHA_CR_FIRST);
+		sha.first = 0;
+	}
+	sha.busy = 1;
+}
+
+static void at91_sha_write_block(const unsigned int *block)
+{
+	unsigned int i;
+
+	at91_sha_start();
+	for (i = 0; i < SHA_BLOCK_WORDS; i++)
+		sha_writel(SHA_IDATAR0, block[i]);
+}
+
+#ifdef CONFIG_SHA_DMA
+/* Returns without waiting, the blocks are hashed while the CPU goes on */
+static int at91_sha_dma_blocks(const void *data, unsigned int blocks)
+{
+	struct xdmac_cfg cfg;
+	struct xdmac_transfer_cfg transfer_cfg;
+
+	at91_sha_wait();
+
+	cfg.data_width = DMA_DATA_WIDTH_WORD;
+	cfg.chunk_size = DMA_CHUNK_SIZE_16;
+	cfg.burst_size = DMA_MEM_BURST_16;
+	cfg.incr_saddr = 1;
+	cfg.incr_daddr = 0;
+	if (xdmac_configure_transfer(&sha_dma_hwcfg, &cfg))
+		return -1;
+
+	at91_sha_start();
+
+	transfer_cfg.saddr = (void *)data;
+	transfer_cfg.daddr = (void *)(AT91C_BASE_SHA + SHA_IDATAR0);
+	transfer_cfg.len = blocks * SHA_BLOCK_WORDS;
+	xdmac_transfer_start(&sha_dma_hwcfg, &transfer_cfg);
+	sha_dma_busy = 1;
+
+	return 0;
+}
+#endif
+
+void at91_sha_init(void)
+{
+	pmc_enable_periph_clock(AT91C_ID_SHA, PMC_PERIPH_CLK_DIVIDER_NA);
+
+	sha_writel(SHA_CR, SHA_CR_SWRST);
+	sha_writel(SHA_MR, SHA_MR_SMOD_IDATAR0 | SHA_MR_ALGO_SHA256);
+
+	sha.count = 0;
+	sha.first = 1;
+	sha.busy = 0;
+}
+
+void at91_sha_update(const void *data, unsigned int len)
+{
+	const unsigned char *p = data;
+	unsigned int used = sha.count & (SHA256_BLOCK_SIZE - 1);
+	unsigned int n;
+
+	sha.count += len;
+
+	if (used) {
+		n = min(len, SHA256_BLOCK_SIZE - used);
+		memcpy((unsigned char *)sha.buf + used, p, n);
+		p += n;
+		len -= n;
+		if (used + n < SHA256_BLOCK_SIZE)
+			return;
+		at91_sha_write_block(sha.buf);
+	}
+
+#ifdef CONFIG_SHA_DMA
+	if (!((unsigned int)p & 3) && (len >= SHA_DMA_MIN_SIZE)) {
+		n = len & ~(SHA256_BLOCK_SIZE - 1);
+		if (!at91_sha_dma_blocks(p, n / SHA256_BLOCK_SIZE)) {
+			p += n;
+			len -= n;
+		}
+	}
+#endif
+
+	for (; len >= SHA256_BLOCK_SIZE; len -= SHA256_BLOCK_SIZE) {
+		if ((unsigned int)p & 3) {
+			memcpy(sha.buf, p, SHA256_BLOCK_SIZE);
+			at91_sha_write_block(sha.buf);
+		} else {
+			at91_sha_write_block((const unsigned int *)p);
+		}
+		p += SHA256_BLOCK_SIZE;
+	}
+
+	memcpy(sha.buf, p, len);
+}
+
+void at91_sha_final(unsigned char *digest)
+{
+	unsigned int pad[2 * SHA_BLOCK_WORDS];
+	unsigned int used = sha.count & (SHA256_BLOCK_SIZE - 1);
+	unsigned int blocks, i, word;
+
+	memcpy(pad, sha.buf, used);
+	blocks = sha256_pad((unsigned char *)pad, used, sha.count);
+	for (i = 0; i < blocks; i++)
+		at91_sha_write_block(pad + i * SHA_BLOCK_WORDS);
+	at91_sha_wait();
+
+	/* The digest comes out in the byte order of the message */
+	for (i = 0; i < SHA256_DIGEST_SIZE / 4; i++) {
+		word = sha_readl(SHA_ODATAR0 + 4 * i);
+		memcpy(digest + 4 * i, &word, 4);
+	}
+
+	sha_writel(SHA_CR, SHA_CR_SWRST);
+	pmc_disable_periph_clock(AT91C_ID_SHA);
+}
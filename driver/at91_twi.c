@@ -8,6 +8,7 @@
 #include "div.h"
 #include "debug.h"
 #include "pmc.h"
+#include "twi.h"
 
 #if defined(CONFIG_SAMA5D2)
 #define TWI_CLK_OFFSET (3) /* TODO: handle GCK case (offset=0) */
@@ -157,6 +158,127 @@ static void twi_startwrite(unsigned int twi_base, unsigned char device_addr,
 	twi_reg_write(twi_base, TWI_THR, byte);
 };
 
+#ifdef CONFIG_TWI_FIFO
+/*
+ * FIFO transfers use the alternative command: the controller knows the
+ * length, sends the STOP by itself after the last byte and keeps the bus
+ * busy while the CPU moves the bytes as many at a time as the FIFO holds,
+ * instead of one per RXRDY/TXRDY poll.
+ */
+static void twi_fifo_start(unsigned int twi_base, unsigned char device_addr,
+			   unsigned int internal_addr, unsigned char iaddr_size,
+			   unsigned int mread, unsigned int bytes)
+{
+	twi_reg_write(twi_base, TWI_CR, TWI_CR_FIFOEN | TWI_CR_ACMEN);
+	twi_reg_write(twi_base, TWI_CR, TWI_CR_THRCLR | TWI_CR_RHRCLR);
+
+	twi_reg_write(twi_base, TWI_MMR, TWI_MMR_IADRSZ(iaddr_size)
+				| mread
+				| TWI_MMR_DADR(device_addr));
+
+	twi_reg_write(twi_base, TWI_IADR, internal_addr);
+
+	twi_reg_write(twi_base, TWI_ACR, TWI_ACR_DATAL(bytes)
+				| (mread ? TWI_ACR_DIR_READ : 0));
+}
+
+static int twi_fifo_end(unsigned int twi_base)
+{
+	unsigned int status;
+	int timeout = 10000;
+
+	do {
+		status = twi_reg_read(twi_base, TWI_SR);
+	} while (!(status & TWI_SR_TXCOMP) && (--timeout));
+
+	twi_reg_write(twi_base, TWI_CR, TWI_CR_ACMDIS | TWI_CR_FIFODIS);
+
+	if (!timeout) {
+		dbg_loud("twi: timeout to wait TXCOMP bit\n");
+		return -1;
+	}
+
+	return (status & TWI_SR_NACK) ? -1 : 0;
+}
+
+static unsigned int twi_fifo_rx_level(unsigned int twi_base)
+{
+	unsigned int level;
+	int timeout = 10000;
+
+	do {
+		level = TWI_FLR_RXFL(twi_reg_read(twi_base, TWI_FLR));
+		if (level)
+			return level;
+
+		if (twi_reg_read(twi_base, TWI_SR) & TWI_SR_NACK)
+			return 0;
+	} while (--timeout);
+
+	return 0;
+}
+
+static int twi_fifo_read(unsigned int twi_base, unsigned char device_addr,
+			 unsigned int internal_addr, unsigned char iaddr_size,
+			 unsigned char *data, unsigned int bytes)
+{
+	unsigned int level;
+
+	twi_fifo_start(twi_base, device_addr, internal_addr, iaddr_size,
+		       TWI_MMR_MREAD_RD, bytes);
+
+	twi_reg_write(twi_base, TWI_CR, TWI_CR_START);
+
+	while (bytes > 0) {
+		level = twi_fifo_rx_level(twi_base);
+		if (!level) {
+			dbg_loud("twi read: no data received\n");
+			twi_fifo_end(twi_base);
+			return -1;
+		}
+
+		if (level > bytes)
+			level = bytes;
+		bytes -= level;
+
+		while (level--)
+			*data++ = readb(twi_base + TWI_RHR);
+	}
+
+	return twi_fifo_end(twi_base);
+}
+
+static int twi_fifo_write(unsigned int twi_base, unsigned char device_addr,
+			  unsigned int internal_addr, unsigned char iaddr_size,
+			  unsigned char *data, unsigned int bytes)
+{
+	unsigned int status;
+	int timeout;
+
+	twi_fifo_start(twi_base, device_addr, internal_addr, iaddr_size,
+		       TWI_MMR_MREAD_WR, bytes);
+
+	/* The first byte written starts the transfer */
+	while (bytes > 0) {
+		timeout = 10000;
+		do {
+			status = twi_reg_read(twi_base, TWI_SR);
+		} while (!(status & (TWI_SR_TXRDY | TWI_SR_NACK)) && (--timeout));
+
+		if (!timeout || (status & TWI_SR_NACK)) {
+			dbg_loud("twi write: timeout to wait TXRDY bit\n");
+			twi_fifo_end(twi_base);
+			return -1;
+		}
+
+		writeb(*data++, twi_base + TWI_THR);
+		bytes--;
+	}
+
+	return twi_fifo_end(twi_base);
+}
+#endif
+
 int twi_read(unsigned int bus, unsigned char device_addr,
 		unsigned int internal_addr, unsigned char iaddr_size,
 		unsigned char *data, unsigned int bytes)
@@ -170,6 +292,12 @@ int twi_read(unsigned int bus, unsigned char device_addr,
 		return -1;
 	}
 
+#ifdef CONFIG_TWI_FIFO
+	if (bytes && (bytes <= TWI_ACR_DATAL_MAX))
+		return twi_fifo_read(twi_base, device_addr, internal_addr,
+				     iaddr_size, data, bytes);
+#endif
+
 	twi_startread(twi_base, device_addr, internal_addr, iaddr_size);
 
 	while (bytes > 0) {
@@ -211,6 +339,12 @@ int twi_write(unsigned int bus, unsigned char device_addr,
 	if (!twi_base)
 		return -1;
 
+#ifdef CONFIG_TWI_FIFO
+	if (bytes && (bytes <= TWI_ACR_DATAL_MAX))
+		return twi_fifo_write(twi_base, device_addr, internal_addr,
+				      iaddr_size, data, bytes);
+#endif
+
 	twi_startwrite(twi_base, device_addr,
 				internal_addr, iaddr_size, *data++);
 	bytes--;
@@ -8,6 +8,9 @@
 #include "rstc.h"
 #include "arch/at91_sfrbu.h"
 #include "usart.h"
+#ifdef CONFIG_BACKUP_RESUME_LATENCY
+#include "pmc.h"
+#endif
 
 #undef DEBUG_BKP_SR_INIT
 #if defined(DEBUG_BKP_SR_INIT)
@@ -119,6 +122,39 @@ unsigned long backup_mode_resume(void)
 	return pm_bu->resume;
 }
 
+#ifdef CONFIG_BACKUP_RESUME_LATENCY
+/*
+ * The resume latency is counted on the slow clock, which the PLL and
+ * master clock setup of hw_init() leaves alone, by the first channel of
+ * TC1: TC0 is the one Linux takes as clock source.
+ */
+#define TC_CCR			0x00
+#define		TC_CCR_CLKEN	(0x1 << 0)
+#define		TC_CCR_CLKDIS	(0x1 << 1)
+#define		TC_CCR_SWTRG	(0x1 << 2)
+#define TC_CMR			0x04
+#define		TC_CMR_SLCK	(0x4 << 0)	/* TIMER_CLOCK5 */
+#define TC_CV			0x10
+
+void backup_latency_start(void)
+{
+	pmc_enable_periph_clock(AT91C_ID_TC1, PMC_PERIPH_CLK_DIVIDER_NA);
+	writel(TC_CMR_SLCK, AT91C_BASE_TC1 + TC_CMR);
+	writel(TC_CCR_CLKEN | TC_CCR_SWTRG, AT91C_BASE_TC1 + TC_CCR);
+}
+
+/* Stop the count, return it in us: 1000000 / 32768 = 15625 / 512 */
+unsigned int backup_latency_stop(void)
+{
+	unsigned int ticks = readl(AT91C_BASE_TC1 + TC_CV);
+
+	writel(TC_CCR_CLKDIS, AT91C_BASE_TC1 + TC_CCR);
+	pmc_disable_periph_clock(AT91C_ID_TC1);
+
+	return (ticks * 15625) >> 9;
+}
+#endif
+
 #ifdef CONFIG_PUBL
 void backup_get_calibration_data(unsigned int *data, unsigned int len)
 {
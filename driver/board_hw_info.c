@@ -64,6 +64,9 @@ typedef struct board_hw_info {
 	unsigned char week;
 } board_info_t;
 
+/* Both maps end with the revision mapping, the last byte parsed */
+#define HW_INFO_PARSED_SIZE	sizeof(hw_info_map_t)
+
 static unsigned int sn;
 static unsigned int rev;
 static unsigned char buffer[HW_INFO_TOTAL_SIZE];
@@ -586,6 +589,42 @@ unsigned int get_ek_sn(void)
 	return (sn  >> EK_SN_OFFSET) & SN_MASK;
 }
 
+/*
+ * The board id is at most SN_MASK, its tens are counted rather than
+ * divided. The revision is up to REV_MASK, past 'z' it is read as 'z'.
+ */
+static void board_overlay_id(char *id, const char *type,
+			     unsigned int board_id, unsigned int revision)
+{
+	unsigned int tens = 0;
+
+	while (board_id >= 10) {
+		board_id -= 10;
+		tens++;
+	}
+
+	if (revision > 'z' - 'a')
+		revision = 'z' - 'a';
+
+	id[0] = type[0];
+	id[1] = type[1];
+	id[2] = '0' + tens;
+	id[3] = '0' + board_id;
+	id[4] = '-';
+	id[5] = 'a' + revision;
+	id[6] = '\0';
+}
+
+void get_board_overlay_ids(char ids[][BOARD_OVERLAY_ID_LEN])
+{
+	board_overlay_id(ids[0], "cm", get_cm_sn(),
+			 (rev >> CM_REV_OFFSET) & REV_MASK);
+	board_overlay_id(ids[1], "dm", get_dm_sn(),
+			 (rev >> DM_REV_OFFSET) & REV_MASK);
+	board_overlay_id(ids[2], "ek", get_ek_sn(),
+			 (rev >> EK_REV_OFFSET) & REV_MASK);
+}
+
 #if defined(CONFIG_LOAD_ONE_WIRE)
 static int load_1wire_info(unsigned char *buff, unsigned int size,
 			   unsigned int *psn, unsigned int *prev)
@@ -668,7 +707,7 @@ static int load_eeprom_info(unsigned char *buff, unsigned int size,
 
 void load_board_hw_info(void)
 {
-	unsigned int size = HW_INFO_TOTAL_SIZE;
+	unsigned int size = HW_INFO_PARSED_SIZE;
 	int ret;
 
 #if defined(CONFIG_LOAD_ONE_WIRE)
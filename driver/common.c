@@ -9,6 +9,8 @@
 #include "flash.h"
 #include "string.h"
 #include "usart.h"
+#include "timer.h"
+#include "debug.h"
 
 #ifdef CONFIG_LOAD_SW
 load_function load_image;
@@ -27,9 +29,102 @@ char cmdline_args[CMDLINE_BUF_LEN];
 
 #ifdef CONFIG_LOAD_SW
 
+#ifdef CONFIG_BOOT_FALLBACK
+/*
+ * The media are tried in order, the first one which loads an image wins.
+ * A medium is identified while the ones before it wait on their hardware
+ * (see boot_media_delay()), so that it is ready if they have no image.
+ */
+struct boot_medium {
+	const char *name;
+	int (*probe)(void);
+	int (*load)(struct image_info *image);
+	int probed;		/* 1: ready, -1: absent */
+};
+
+static int load_dataflash_fallback(struct image_info *image)
+{
+#if !defined(CONFIG_LOAD_LINUX) && !defined(CONFIG_LOAD_ANDROID)
+	image->length = IMG_SIZE;
+#endif
+	image->offset = IMG_ADDRESS;
+#ifdef CONFIG_OF_LIBFDT
+	image->of_offset = OF_OFFSET;
+#endif
+
+	return load_dataflash(image);
+}
+
+static struct boot_medium boot_media[] = {
+	{ "SD/MMC: ", NULL, load_sdcard },
+	{ "SF: ", dataflash_probe, load_dataflash_fallback },
+};
+
+static struct boot_medium *boot_medium = boot_media;
+
+static void boot_medium_probe(struct boot_medium *medium)
+{
+	if (medium->probed)
+		return;
+
+	if (medium->probe && medium->probe())
+		medium->probed = -1;
+	else
+		medium->probed = 1;
+}
+
+/* Called instead of udelay() by the media drivers while identifying */
+void boot_media_delay(unsigned int usec)
+{
+	unsigned int start = timer_get_counter();
+	unsigned int spent;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(boot_media); i++) {
+		if (!boot_media[i].probed && boot_media[i].probe) {
+			boot_medium_probe(&boot_media[i]);
+			break;
+		}
+	}
+
+	spent = timer_ticks_to_usec(timer_get_counter() - start);
+	if (spent < usec)
+		udelay(usec - spent);
+}
+
+static int load_boot_media(struct image_info *image)
+{
+	unsigned int i;
+	int ret = -1;
+
+	for (i = 0; i < ARRAY_SIZE(boot_media); i++) {
+		boot_medium = &boot_media[i];
+
+		boot_medium_probe(boot_medium);
+		if (boot_medium->probed < 0)
+			continue;
+
+		ret = boot_medium->load(image);
+		if (ret == 0 || ret == -2)	/* loaded, or flash recovered */
+			break;
+
+		dbg_info("%sNo image, trying the next medium\n",
+			 boot_medium->name);
+	}
+
+	return ret;
+}
+#endif /* CONFIG_BOOT_FALLBACK */
+
+#ifdef CONFIG_AB_SLOTS
+load_function get_media_load_func(void)
+#else
 load_function get_image_load_func(void)
+#endif
 {
-#if defined(CONFIG_DATAFLASH)
+#if defined(CONFIG_BOOT_FALLBACK)
+	return &load_boot_media;
+#elif defined(CONFIG_DATAFLASH)
 	return &load_dataflash;
 #elif defined(CONFIG_FLASH)
 	return &load_norflash;
@@ -42,6 +137,13 @@ load_function get_image_load_func(void)
 #endif
 }
 
+#ifdef CONFIG_AB_SLOTS
+load_function get_image_load_func(void)
+{
+	return &ab_load_image;
+}
+#endif
+
 #if defined(CONFIG_DATAFLASH) || defined(CONFIG_NANDFLASH) || defined(CONFIG_FLASH)
 unsigned int get_image_load_offset(unsigned int addr)
 {
@@ -76,6 +178,19 @@ void init_load_image(struct image_info *image)
 	image->of_offset = get_image_load_offset(OF_OFFSET);
 #endif
 
+#endif
+
+#ifdef CONFIG_SDCARD_RAW
+#if !defined(CONFIG_LOAD_LINUX) && !defined(CONFIG_LOAD_ANDROID)
+	image->length = IMG_SIZE;
+#endif
+
+#ifndef CONFIG_SDCARD_RAW_GPT
+	image->offset = CONFIG_SDCARD_RAW_IMG_BLOCK;
+#ifdef CONFIG_OF_LIBFDT
+	image->of_offset = CONFIG_SDCARD_RAW_OF_BLOCK;
+#endif
+#endif
 #endif
 
 	image->dest = (unsigned char *)JUMP_ADDR;
@@ -83,7 +198,12 @@ void init_load_image(struct image_info *image)
 	image->of_dest = (unsigned char *)OF_ADDRESS;
 #endif
 
-#ifdef CONFIG_SDCARD
+#ifdef CONFIG_LOAD_OPTEE
+	image->optee_filename = CONFIG_OPTEE_IMAGE_NAME;
+	image->optee_dest = (unsigned char *)CONFIG_OPTEE_JUMP_ADDR;
+#endif
+
+#ifdef CONFIG_FATFS
 	image->filename = filename;
 	strcpy(image->filename, IMAGE_NAME);
 #ifdef CONFIG_OF_LIBFDT
@@ -110,6 +230,8 @@ void load_image_done(int retval)
 
 #ifndef CONFIG_LOAD_SW
 	media = "NONE: ";
+#elif defined(CONFIG_BOOT_FALLBACK)
+	media = (char *)boot_medium->name;
 #elif defined(CONFIG_FLASH)
 	media = "FLASH: ";
 #elif defined(CONFIG_NANDFLASH)
@@ -5,6 +5,17 @@
 #include "common.h"
 #include "spi_flash.h"
 #include "qspi_flash.h"
+#include "dataflash.h"
+
+/* Identify the flash ahead of loading, only the QSPI flash needs it */
+int dataflash_probe(void)
+{
+#ifdef CONFIG_QSPI
+	return qspi_probe();
+#else
+	return 0;
+#endif
+}
 
 int load_dataflash(struct image_info *image)
 {
@@ -0,0 +1,203 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "hardware.h"
+#include "board.h"
+#include "common.h"
+#include "debug.h"
+#include "div.h"
+#include "timer.h"
+#include "ddr_bench.h"
+
+#ifdef CONFIG_UMCTL2
+#include "umctl2.h"
+#else
+#include "ddramc.h"
+#endif
+
+#ifdef CONFIG_CACHES
+#include "l1cache.h"
+#include "mmu.h"
+#endif
+
+#define BENCH_PASSES		4
+
+/* Distance between two nodes of the pointer chasing chain */
+#define CHASE_STRIDE		256
+#define CHASE_MAX_NODES		16384
+#define CHASE_ACCESSES		(256 * 1024)
+
+static volatile unsigned int bench_sink;
+
+static void bench_write(unsigned int *p, unsigned int words)
+{
+	unsigned int *end = p + words;
+
+	while (p < end) {
+		p[0] = 0x5a5a5a5a;
+		p[1] = 0x5a5a5a5a;
+		p[2] = 0x5a5a5a5a;
+		p[3] = 0x5a5a5a5a;
+		p[4] = 0x5a5a5a5a;
+		p[5] = 0x5a5a5a5a;
+		p[6] = 0x5a5a5a5a;
+		p[7] = 0x5a5a5a5a;
+		p += 8;
+	}
+}
+
+static void bench_read(const unsigned int *p, unsigned int words)
+{
+	const unsigned int *end = p + words;
+	unsigned int sum = 0;
+
+	while (p < end) {
+		sum += p[0] ^ p[1] ^ p[2] ^ p[3];
+		sum += p[4] ^ p[5] ^ p[6] ^ p[7];
+		p += 8;
+	}
+
+	bench_sink = sum;
+}
+
+static void bench_copy(unsigned int *dst,
+		       const unsigned int *src,
+		       unsigned int words)
+{
+	unsigned int *end = dst + words;
+
+	while (dst < end) {
+		dst[0] = src[0];
+		dst[1] = src[1];
+		dst[2] = src[2];
+		dst[3] = src[3];
+		dst[4] = src[4];
+		dst[5] = src[5];
+		dst[6] = src[6];
+		dst[7] = src[7];
+		dst += 8;
+		src += 8;
+	}
+}
+
+/*
+ * Link the window into a single random cycle (Sattolo's algorithm), so
+ * that neither the prefetcher nor the open DRAM rows help the chase.
+ */
+static void bench_chase_setup(unsigned int *base, unsigned int nodes)
+{
+	unsigned int stride = CHASE_STRIDE / sizeof(unsigned int);
+	unsigned int seed = 0x12345678;
+	unsigned int i, j, tmp;
+
+	for (i = 0; i < nodes; i++)
+		base[i * stride] = i;
+
+	for (i = nodes - 1; i > 0; i--) {
+		seed = seed * 1664525 + 1013904223;
+		j = mod(seed >> 8, i);
+		tmp = base[i * stride];
+		base[i * stride] = base[j * stride];
+		base[j * stride] = tmp;
+	}
+
+	/* Turn the permutation into pointers */
+	for (i = 0; i < nodes; i++)
+		base[i * stride] = (unsigned int)&base[base[i * stride] * stride];
+}
+
+static void bench_chase(unsigned int *base, unsigned int accesses)
+{
+	unsigned int *p = base;
+
+	while (accesses) {
+		p = (unsigned int *)*p;
+		p = (unsigned int *)*p;
+		p = (unsigned int *)*p;
+		p = (unsigned int *)*p;
+		accesses -= 4;
+	}
+
+	bench_sink = (unsigned int)p;
+}
+
+static void bench_report(const char *name,
+			 unsigned int bytes,
+			 unsigned int ticks)
+{
+	unsigned int usec = timer_ticks_to_usec(ticks);
+
+	if (!usec)
+		usec = 1;
+
+	/* One byte per microsecond is one MB/s */
+	dbg_info("DDR bench: %s: %d MB/s\n", name, div(bytes, usec));
+}
+
+void ddram_benchmark(void)
+{
+	unsigned int base = AT91C_BASE_DDRCS + CONFIG_DDR_BENCHMARK_OFFSET;
+	unsigned int size = CONFIG_DDR_BENCHMARK_SIZE;
+	unsigned int half = size >> 1;
+	unsigned int nodes;
+	unsigned int start, ticks;
+	unsigned int i;
+
+	if (CONFIG_DDR_BENCHMARK_OFFSET + size > get_ddram_size()) {
+		dbg_info("DDR bench: window out of DRAM, skipped\n");
+		return;
+	}
+
+#ifdef CONFIG_CACHES
+	mmu_tlb_init((unsigned int *)MMU_TABLE_BASE_ADDR);
+	mmu_configure((unsigned int *)MMU_TABLE_BASE_ADDR);
+	mmu_enable();
+	icache_enable();
+	dcache_enable();
+#endif
+
+	dbg_info("DDR bench: window %x, size %x, caches %s\n",
+		 base, size,
+#ifdef CONFIG_CACHES
+		 "on"
+#else
+		 "off"
+#endif
+		 );
+
+	start = timer_get_counter();
+	for (i = 0; i < BENCH_PASSES; i++)
+		bench_write((unsigned int *)base, size >> 2);
+	ticks = timer_get_counter() - start;
+	bench_report("write", size * BENCH_PASSES, ticks);
+
+	start = timer_get_counter();
+	for (i = 0; i < BENCH_PASSES; i++)
+		bench_read((unsigned int *)base, size >> 2);
+	ticks = timer_get_counter() - start;
+	bench_report("read ", size * BENCH_PASSES, ticks);
+
+	/* Copy bandwidth counts both the bytes read and the bytes written */
+	start = timer_get_counter();
+	for (i = 0; i < BENCH_PASSES; i++)
+		bench_copy((unsigned int *)(base + half),
+			   (unsigned int *)base, half >> 2);
+	ticks = timer_get_counter() - start;
+	bench_report("copy ", size * BENCH_PASSES, ticks);
+
+	nodes = min(size / CHASE_STRIDE, CHASE_MAX_NODES);
+	bench_chase_setup((unsigned int *)base, nodes);
+
+	start = timer_get_counter();
+	bench_chase((unsigned int *)base, CHASE_ACCESSES);
+	ticks = timer_get_counter() - start;
+	dbg_info("DDR bench: latency: %d ns per access\n",
+		 div(timer_ticks_to_usec(ticks) * 1000, CHASE_ACCESSES));
+
+#ifdef CONFIG_CACHES
+	icache_disable();
+	dcache_disable();
+	mmu_disable();
+#endif
+}
@@ -0,0 +1,204 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "hardware.h"
+#include "board.h"
+#include "common.h"
+#include "debug.h"
+#include "string.h"
+#include "timer.h"
+#include "memtest.h"
+
+#ifdef CONFIG_UMCTL2
+#include "umctl2.h"
+#else
+#include "ddramc.h"
+#endif
+
+#ifdef CONFIG_DDR_MEMTEST_DMA
+#include "xdmac.h"
+#endif
+
+/*
+ * The window is processed in blocks so that, with DMA, the XDMAC fills
+ * block n + 1 while the CPU verifies block n.
+ */
+#define MEMTEST_BLOCK_SIZE	0x100000
+
+static const unsigned int memtest_patterns[] = {
+	0x00000000,
+	0xffffffff,
+	0xaaaaaaaa,
+	0x55555555,
+};
+
+#ifdef CONFIG_DDR_MEMTEST_DMA
+/* Non incremented DMA source, a double word wide for 64-bit bursts */
+static unsigned int dma_pattern[2] __attribute__((aligned(8)));
+
+static struct xdmac_hwcfg dma_hwcfg = {
+	.pid = 0xFF,
+	.cid = 0,
+	.src_is_periph = 0,
+	.dst_is_periph = 0,
+};
+
+static int memtest_dma_fill_start(unsigned int *start, unsigned int size)
+{
+	struct xdmac_cfg cfg;
+	struct xdmac_transfer_cfg transfer_cfg;
+
+	cfg.data_width = DMA_DATA_WIDTH_DWORD;
+	cfg.chunk_size = DMA_CHUNK_SIZE_1;
+	cfg.burst_size = DMA_MEM_BURST_16;
+	cfg.incr_saddr = 0;
+	cfg.incr_daddr = 1;
+	if (xdmac_configure_transfer(&dma_hwcfg, &cfg))
+		return -1;
+
+	transfer_cfg.saddr = (void *)dma_pattern;
+	transfer_cfg.daddr = (void *)start;
+	transfer_cfg.len = size >> 3;
+
+	return xdmac_transfer_start(&dma_hwcfg, &transfer_cfg);
+}
+
+static int memtest_dma_fill_wait(void)
+{
+	int ret;
+
+	ret = xdmac_transfer_wait_for_completion(&dma_hwcfg);
+	xdmac_transfer_stop(&dma_hwcfg);
+
+	return ret;
+}
+
+/* Fill with DMA one block ahead of the CPU verifying the previous one */
+static int memtest_pattern_pass(unsigned int base, unsigned int size,
+				unsigned int pattern,
+				struct memtest_result *res)
+{
+	unsigned int addr, next;
+	int ret;
+
+	dma_pattern[0] = pattern;
+	dma_pattern[1] = pattern;
+
+	if (memtest_dma_fill_start((unsigned int *)base,
+				   min(size, MEMTEST_BLOCK_SIZE)))
+		return -1;
+
+	for (addr = base; addr < base + size; addr = next) {
+		next = addr + MEMTEST_BLOCK_SIZE;
+
+		ret = memtest_dma_fill_wait();
+		if (ret)
+			return ret;
+
+		if (next < base + size) {
+			ret = memtest_dma_fill_start((unsigned int *)next,
+					min(base + size - next,
+					    MEMTEST_BLOCK_SIZE));
+			if (ret)
+				return ret;
+		}
+
+		memtest_verify((unsigned int *)addr,
+			       min(base + size - addr, MEMTEST_BLOCK_SIZE) >> 2,
+			       pattern, res);
+	}
+
+	return 0;
+}
+#else
+static int memtest_pattern_pass(unsigned int base, unsigned int size,
+				unsigned int pattern,
+				struct memtest_result *res)
+{
+	memtest_fill((unsigned int *)base, size >> 2, pattern);
+	memtest_verify((unsigned int *)base, size >> 2, pattern, res);
+
+	return 0;
+}
+#endif
+
+static void memtest_report(const char *name,
+			   unsigned int start,
+			   struct memtest_result *res,
+			   unsigned int *msec)
+{
+	unsigned int pass_msec;
+
+	pass_msec = timer_ticks_to_usec(timer_get_counter() - start) / 1000;
+	*msec += pass_msec;
+
+	if (res->errors)
+		dbg_info("MEMTEST: %s: %d errors, first at %x: exp %x got %x\n",
+			 name, res->errors, res->first_addr,
+			 res->expected, res->actual);
+	else
+		dbg_info("MEMTEST: %s: OK (%d ms)\n", name, pass_msec);
+}
+
+/*
+ * Called before the caches are enabled: the verification passes read the
+ * DRAM itself, and the DMA fills need no cache maintenance.
+ */
+int ddram_memtest(void)
+{
+	struct memtest_result res;
+	unsigned int base = AT91C_BASE_DDRCS + CONFIG_DDR_MEMTEST_OFFSET;
+	unsigned int size = CONFIG_DDR_MEMTEST_SIZE;
+	unsigned int start;
+	unsigned int msec = 0;
+	unsigned int errors = 0;
+	unsigned int i;
+
+	if (!size)
+		size = get_ddram_size() - CONFIG_DDR_MEMTEST_OFFSET;
+	size &= ~0xf;
+
+	dbg_info("MEMTEST: %x bytes at %x\n", size, base);
+
+	memset(&res, 0, sizeof(res));
+	start = timer_get_counter();
+	memtest_walking_ones((unsigned int *)base, &res);
+	memtest_addr_lines((unsigned int *)base, size, &res);
+	memtest_report("walking ones", start, &res, &msec);
+	errors += res.errors;
+
+	for (i = 0; i < ARRAY_SIZE(memtest_patterns); i++) {
+		memset(&res, 0, sizeof(res));
+		start = timer_get_counter();
+		if (memtest_pattern_pass(base, size,
+					 memtest_patterns[i], &res)) {
+			dbg_info("MEMTEST: DMA error\n");
+			return -1;
+		}
+		memtest_report("fixed patterns", start, &res, &msec);
+		errors += res.errors;
+	}
+
+	/* Memory holds the last pattern, sweep its inverse both ways */
+	memset(&res, 0, sizeof(res));
+	start = timer_get_counter();
+	i = memtest_patterns[ARRAY_SIZE(memtest_patterns) - 1];
+	memtest_invert_up((unsigned int *)base, size >> 2, i, &res);
+	memtest_invert_down((unsigned int *)base, size >> 2, ~i, &res);
+	memtest_report("moving inversions", start, &res, &msec);
+	errors += res.errors;
+
+	memset(&res, 0, sizeof(res));
+	start = timer_get_counter();
+	memtest_addr_fill((unsigned int *)base, size >> 2);
+	memtest_addr_invert((unsigned int *)base, size >> 2, &res);
+	memtest_addr_verify_inv((unsigned int *)base, size >> 2, &res);
+	memtest_report("address in address", start, &res, &msec);
+	errors += res.errors;
+
+	dbg_info("MEMTEST: %s, %d errors in %d ms\n",
+		 errors ? "FAILED" : "passed", errors, msec);
+
+	return errors ? -1 : 0;
+}
@@ -13,6 +13,7 @@ COBJS-$(CONFIG_DEBUG)		+= $(DRIVERS_SRC)/debug.o
 COBJS-$(CONFIG_CPU_HAS_SCKC)	+= $(DRIVERS_SRC)/at91_slowclk.o
 
 COBJS-y				+= $(DRIVERS_SRC)/common.o
+COBJS-$(CONFIG_AB_SLOTS)		+= $(DRIVERS_SRC)/ab_slots.o
 COBJS-$(CONFIG_PIO)		+= $(DRIVERS_SRC)/at91_pio.o
 COBJS-$(CONFIG_PMC_COMMON)	+= $(DRIVERS_SRC)/pmc/clk-common.o
 COBJS-$(CONFIG_PMC_PERIPH_CLK_SAM9X5)	+= $(DRIVERS_SRC)/pmc/periph-clk-sam9x5.o
@@ -37,6 +38,8 @@ COBJS-$(CONFIG_SDDRC)		+= $(DRIVERS_SRC)/sddrc.o
 COBJS-$(CONFIG_DDRC)		+= $(DRIVERS_SRC)/ddramc.o
 COBJS-$(CONFIG_UMCTL2)		+= $(DRIVERS_SRC)/umctl2.o
 COBJS-$(CONFIG_PUBL)		+= $(DRIVERS_SRC)/publ.o
+COBJS-$(CONFIG_DDR_BENCHMARK)	+= $(DRIVERS_SRC)/ddr_bench.o
+COBJS-$(CONFIG_DDR_MEMTEST)	+= $(DRIVERS_SRC)/ddr_memtest.o
 
 COBJS-$(CONFIG_AT91_MCI)	+= $(DRIVERS_SRC)/at91_mci.o
 COBJS-$(CONFIG_SDHC)		+= $(DRIVERS_SRC)/sdhc.o
@@ -47,6 +50,7 @@ COBJS-$(CONFIG_SDCARD)		+= $(DRIVERS_SRC)/sdcard.o
 COBJS-$(CONFIG_NANDFLASH)	+= $(DRIVERS_SRC)/nandflash.o
 COBJS-$(CONFIG_USE_PMECC)	+= $(DRIVERS_SRC)/pmecc.o
 COBJS-$(CONFIG_ENABLE_SW_ECC) 	+= $(DRIVERS_SRC)/hamming.o
+COBJS-$(CONFIG_NAND_ON_DIE_ECC_CACHE_READ)	+= $(DRIVERS_SRC)/nand_ondie_ecc.o
 
 COBJS-$(CONFIG_SPI_FLASH)	+= $(DRIVERS_SRC)/spi_flash/spi_flash.o
 COBJS-$(CONFIG_SPI_FLASH)	+= $(DRIVERS_SRC)/spi_flash/sfdp.o
@@ -66,6 +70,7 @@ COBJS-y				+= $(DRIVERS_SRC)/at91-qspi/qspi.o
 endif
 endif
 COBJS-$(CONFIG_DATAFLASH)	+= $(DRIVERS_SRC)/dataflash.o
+COBJS-$(CONFIG_BOOT_FALLBACK)	+= $(DRIVERS_SRC)/dataflash.o
 
 COBJS-$(CONFIG_FLASH)		+= $(DRIVERS_SRC)/flash.o
 
@@ -102,6 +107,9 @@ COBJS-$(CONFIG_WM8904)	+= $(DRIVERS_SRC)/wm8904.o
 COBJS-$(CONFIG_TZC400)  += $(DRIVERS_SRC)/tzc400.o
 
 COBJS-$(CONFIG_AES)		+= $(DRIVERS_SRC)/at91_aes.o
+COBJS-$(CONFIG_SHA)		+= $(DRIVERS_SRC)/at91_sha.o
+COBJS-$(CONFIG_HASH)		+= $(DRIVERS_SRC)/hash.o
+COBJS-$(CONFIG_MEASURED_BOOT)	+= $(DRIVERS_SRC)/measure.o
 COBJS-$(CONFIG_SECURE)		+= $(DRIVERS_SRC)/secure.o
 
 COBJS-$(CONFIG_BACKUP_MODE)	+= $(DRIVERS_SRC)/backup.o
@@ -114,3 +122,14 @@ COBJS-$(CONFIG_SFRBU)		+= $(DRIVERS_SRC)/sfrbu.o
 COBJS-$(CONFIG_CACHES)		+= $(DRIVERS_SRC)/l1cache.o
 COBJS-$(CONFIG_MMU)		+= $(DRIVERS_SRC)/mmu.o
 COBJS-$(CONFIG_XDMAC)	+= $(DRIVERS_SRC)/at91_xdmac.o
+
+# Image loading path, built for speed with CONFIG_OPTIMIZE_HOT_PATHS
+HOTOBJS-$(CONFIG_AT91_MCI)	+= $(DRIVERS_SRC)/at91_mci.o
+HOTOBJS-$(CONFIG_SDHC)		+= $(DRIVERS_SRC)/sdhc.o
+HOTOBJS-$(CONFIG_SDCARD)	+= $(DRIVERS_SRC)/mci_media.o
+HOTOBJS-$(CONFIG_NANDFLASH)	+= $(DRIVERS_SRC)/nandflash.o
+HOTOBJS-$(CONFIG_USE_PMECC)	+= $(DRIVERS_SRC)/pmecc.o
+HOTOBJS-$(CONFIG_SPI_FLASH)	+= $(DRIVERS_SRC)/spi_flash/spi_nor.o
+HOTOBJS-$(CONFIG_SPI)		+= $(DRIVERS_SRC)/at91_spi.o
+HOTOBJS-$(CONFIG_SPI)		+= $(DRIVERS_SRC)/spi_flash.o
+HOTOBJS-$(CONFIG_QSPI)		+= $(DRIVERS_SRC)/at91-qspi/qspi-common.o
@@ -147,6 +147,11 @@ CPPFLAGS += -DAT91C_SPI_CLK=$(SPI_CLK)
 CPPFLAGS += -DAT91C_SPI_PCS_DATAFLASH=$(SPI_BOOT) 
 endif
 
+ifeq ($(CONFIG_BOOT_FALLBACK),y)
+CPPFLAGS += -DAT91C_SPI_CLK=$(SPI_CLK)
+CPPFLAGS += -DAT91C_SPI_PCS_DATAFLASH=$(SPI_BOOT)
+endif
+
 # NAND flash support
 
 
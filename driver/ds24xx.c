@@ -9,6 +9,7 @@
 #include "arch/at91_pio.h"
 #include "debug.h"
 #include "timer.h"
+#include "div.h"
 
 /* Commands */
 #define ROM_COMMAND_READ		0x33
@@ -24,16 +25,28 @@
 #define MEMORY_COMMAND_CSCRATCHPAD	0x55
 #define MEMORY_COMMAND_READMEMORY	0xF0
 
-/* Timing */
-#define tSLOT				65
-#define tRSTL				480
-#define tPDH				60
-#define tPDL				240
-#define tWOL				60
-#define tW1L				5
-#define tRL				5
-#define tMSR				10
-#define tPROG				13000
+/*
+ * Timing, in tenths of microsecond from the start of the slot, at standard
+ * and overdrive speed. The wire is released and sampled at deadlines of the
+ * free running timer, so the GPIO accesses do not stretch the slots.
+ */
+#define tRSTL				4800
+#define tMSP				5500	/* presence sample */
+#define tRSTH				9600
+#define tW0L				600
+#define tW1L				60
+#define tRL				60
+#define tMSR				100	/* read sample */
+#define tSLOT				700
+
+#define tRSTL_OD			700
+#define tMSP_OD				785
+#define tRSTH_OD			1180
+#define tW0L_OD				75
+#define tW1L_OD				10
+#define tRL_OD				10
+#define tMSR_OD				15
+#define tSLOT_OD			120
 
 #define MAX_RETRY			10
 #define MAX_BUF_LEN			256
@@ -54,6 +67,24 @@ static unsigned char LastDeviceFlag;
 static unsigned char buf[MAX_BUF_LEN];
 static unsigned char cmp[MAX_BUF_LEN];
 
+/* Slot deadlines in timer ticks */
+struct ds24xx_timing {
+	unsigned int rstl;
+	unsigned int msp;
+	unsigned int rsth;
+	unsigned int w0l;
+	unsigned int w1l;
+	unsigned int rl;
+	unsigned int msr;
+	unsigned int slot;
+};
+
+static struct ds24xx_timing timing_std;
+#ifdef CONFIG_ONE_WIRE_OVERDRIVE
+static struct ds24xx_timing timing_od;
+#endif
+static const struct ds24xx_timing *timing = &timing_std;
+
 #if defined(CONFIG_ONE_WIRE_ON_PIOA)
 	#define DS24XX_PIO AT91C_PIN_PA(CONFIG_ONE_WIRE_PIN)
 #elif defined(CONFIG_ONE_WIRE_ON_PIOB)
@@ -105,49 +136,56 @@ static unsigned char docrc8(unsigned char crc8, unsigned char value)
 	return dscrc_table[crc8 ^ value];
 }
 
+static inline void wait_until(unsigned int start, unsigned int ticks)
+{
+	while ((timer_get_counter() - start) < ticks)
+		;
+}
+
 static int ds24xx_reset(void)
 {
+	unsigned int start;
 	int i;
 
 	set_wire_low();
-	udelay(tRSTL);
+	start = timer_get_counter();
+	wait_until(start, timing->rstl);
 
 	set_wire_input();
-	udelay(tPDH);
+	wait_until(start, timing->msp);
 
 	i = read_wire_bit();
-	udelay(tPDL);
+	wait_until(start, timing->rsth);
 
 	return i ^ 1;
 }
 
 static void ds24xx_write_bit(int bit)
 {
-	if (bit == 1) {
-		set_wire_low();
-		udelay(tW1L);
-		set_wire_input();
-		udelay(tSLOT-tW1L);
-	} else {
-		set_wire_low();
-		udelay(tWOL);
-		set_wire_input();
-		udelay(tSLOT-tWOL);
-	}
+	unsigned int start;
+
+	set_wire_low();
+	start = timer_get_counter();
+	wait_until(start, (bit == 1) ? timing->w1l : timing->w0l);
+
+	set_wire_input();
+	wait_until(start, timing->slot);
 }
 
 static int ds24xx_read_bit()
 {
+	unsigned int start;
 	int status;
 
 	set_wire_low();
-	udelay(tRL);
+	start = timer_get_counter();
+	wait_until(start, timing->rl);
 
 	set_wire_input();
-	udelay(tMSR / 2);
+	wait_until(start, timing->msr);
 
 	status = read_wire_bit();
-	udelay(tSLOT-tRL-tMSR);
+	wait_until(start, timing->slot);
 
 	return status;
 }
@@ -331,8 +369,40 @@ static int ds24xx_find_next()
 	return ds24xx_search_rom();
 }
 
+static unsigned int ds24xx_ticks(unsigned int tenth_usec)
+{
+	return div(tenth_usec * div(timer_get_rate(), 1000), 10000) + 1;
+}
+
+static void ds24xx_timing_init(struct ds24xx_timing *t,
+			       const unsigned int *tenth_usec)
+{
+	t->rstl = ds24xx_ticks(tenth_usec[0]);
+	t->msp = ds24xx_ticks(tenth_usec[1]);
+	t->rsth = ds24xx_ticks(tenth_usec[2]);
+	t->w0l = ds24xx_ticks(tenth_usec[3]);
+	t->w1l = ds24xx_ticks(tenth_usec[4]);
+	t->rl = ds24xx_ticks(tenth_usec[5]);
+	t->msr = ds24xx_ticks(tenth_usec[6]);
+	t->slot = ds24xx_ticks(tenth_usec[7]);
+}
+
 void one_wire_hw_init(void)
 {
+	static const unsigned int std[] = {
+		tRSTL, tMSP, tRSTH, tW0L, tW1L, tRL, tMSR, tSLOT,
+	};
+#ifdef CONFIG_ONE_WIRE_OVERDRIVE
+	static const unsigned int od[] = {
+		tRSTL_OD, tMSP_OD, tRSTH_OD, tW0L_OD,
+		tW1L_OD, tRL_OD, tMSR_OD, tSLOT_OD,
+	};
+
+	ds24xx_timing_init(&timing_od, od);
+#endif
+	ds24xx_timing_init(&timing_std, std);
+	timing = &timing_std;
+
 	const struct pio_desc one_wire_pio[] = {
 		{"1-Wire", DS24XX_PIO, 1, PIO_DEFAULT, PIO_OUTPUT},
 		{(char *)0, 0, 0, PIO_DEFAULT, PIO_PERIPH_A},
@@ -396,10 +466,18 @@ int ds24xx_read_memory(int chip_index, unsigned char addrh,
 
 retry:
 	for (round = 0; round < 2; round++) {
+		/* A standard speed reset gets all the chips back to it */
+		timing = &timing_std;
 		if (!ds24xx_reset())
 			dbg_info("1-Wire: reset failed\n");
 
+#ifdef CONFIG_ONE_WIRE_OVERDRIVE
+		/* The chip goes overdrive after the command byte */
+		ds24xx_write_byte(ROM_COMMAND_OMATCH);
+		timing = &timing_od;
+#else
 		ds24xx_write_byte(ROM_COMMAND_MATCH);
+#endif
 		for(i = 0; i < 8; i++)
 			ds24xx_write_byte(device_id_array[chip_index][i]);
 
@@ -410,6 +488,7 @@ retry:
 		for(i = 0; i < len; i++)
 			pbuf[round][i] = ds24xx_read_byte();
 	}
+	timing = &timing_std;
 
 
 	/* Compare the buffer, if all the same, return 0 */
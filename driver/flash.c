@@ -8,6 +8,7 @@
 #include "string.h"
 #include "debug.h"
 #include "fdt.h"
+#include "measure.h"
 
 #include "debug.h"
 
@@ -37,6 +38,24 @@ static int update_image_length(unsigned int offset,
 }
 #endif
 
+#ifdef CONFIG_MEASURED_BOOT
+/* By chunks, each one hashed while it is still in the cache */
+static void norflash_copy(unsigned char *dest, const char *src,
+			  unsigned int len)
+{
+	unsigned int chunk;
+
+	for (; len; len -= chunk, src += chunk, dest += chunk) {
+		chunk = min(len, MEASURE_CHUNK_SIZE);
+
+		memcpy(dest, src, chunk);
+		measure_update(dest, chunk);
+	}
+}
+#else
+#define norflash_copy(dest, src, len)	memcpy(dest, src, len)
+#endif
+
 int load_norflash(struct image_info *image)
 {
 	int length = 0;
@@ -54,7 +73,9 @@ int load_norflash(struct image_info *image)
 	dbg_info("FLASH: copy %x bytes from %x to %x\n",
 		 image->length, image->offset, image->dest);
 
-	memcpy(image->dest, (const char *)image->offset, image->length);
+	measure_begin(MEASURE_IMAGE);
+	norflash_copy(image->dest, (const char *)image->offset, image->length);
+	measure_end();
 
 #ifdef CONFIG_OF_LIBFDT
 	length = update_image_length(image->of_offset,
@@ -63,12 +84,18 @@ int load_norflash(struct image_info *image)
 		return -1;
 
 	image->of_length = length;
+#ifdef CONFIG_OF_OVERLAY
+	/* the overlays follow the blob, read them in the same pass */
+	image->of_length = OF_ALIGN(length) + CONFIG_OF_OVERLAY_AREA_SIZE;
+#endif
 
 	dbg_info("FLASH: dt blob: Copy %x bytes from %x to %x\n",
 		image->of_length, image->of_offset, image->of_dest);
 
-	memcpy(image->of_dest,
-	       (const char *)image->of_offset, image->of_length);
+	measure_begin(MEASURE_DTB);
+	norflash_copy(image->of_dest,
+		      (const char *)image->of_offset, image->of_length);
+	measure_end();
 #endif
 	return 0;
 }
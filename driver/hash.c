@@ -0,0 +1,36 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "hash.h"
+
+#ifndef CONFIG_SHA
+static struct sha256_ctx hash_ctx;
+#endif
+
+void hash_init(void)
+{
+#ifdef CONFIG_SHA
+	at91_sha_init();
+#else
+	sha256_init(&hash_ctx);
+#endif
+}
+
+void hash_update(const void *data, unsigned int len)
+{
+#ifdef CONFIG_SHA
+	at91_sha_update(data, len);
+#else
+	sha256_update(&hash_ctx, data, len);
+#endif
+}
+
+void hash_final(unsigned char *digest)
+{
+#ifdef CONFIG_SHA
+	at91_sha_final(digest);
+#else
+	sha256_final(&hash_ctx, digest);
+#endif
+}
@@ -20,6 +20,9 @@
 #include "mon.h"
 #include "tz_utils.h"
 #include "secure.h"
+#include "crc32.h"
+#include "measure.h"
+#include "timer.h"
 
 #include "debug.h"
 
@@ -28,13 +31,103 @@ static char *bootargs;
 
 #ifdef CONFIG_OF_LIBFDT
 
+#ifdef CONFIG_LOAD_HW_INFO
+static char serial_number[9];
+
+static void setup_serial_number(unsigned int sn)
+{
+	int i;
+
+	for (i = 7; i >= 0; i--, sn >>= 4)
+		serial_number[i] = "0123456789abcdef"[sn & 0xf];
+	serial_number[8] = '\0';
+}
+#endif
+
+#ifdef CONFIG_OF_OVERLAY
+static int overlay_selected(void *overlay)
+{
+#ifdef CONFIG_LOAD_HW_INFO
+	char ids[BOARD_OVERLAY_IDS][BOARD_OVERLAY_ID_LEN];
+	unsigned int i;
+
+	get_board_overlay_ids(ids);
+	for (i = 0; i < BOARD_OVERLAY_IDS; i++)
+		if (of_overlay_match(overlay, ids[i]))
+			return 1;
+
+	return 0;
+#else
+	return of_overlay_match(overlay, NULL);
+#endif
+}
+
+/*
+ * The overlays were loaded in the area right after the blob, which grows
+ * over them when they are applied: the selected ones are moved to the
+ * overlays buffer first. The blob may grow up to the buffer.
+ */
+static int setup_dt_overlays(void *blob)
+{
+	char *buffer = (char *)blob + CONFIG_OF_OVERLAY_BUFFER_OFFSET;
+	char *area = (char *)of_next_blob(blob) + CONFIG_OF_OVERLAY_AREA_SIZE;
+	char *end = buffer;
+	char *overlay;
+	unsigned int count = 0;
+
+	if (area > buffer) {
+		dbg_info("DT: the overlays area overlaps the overlays buffer\n");
+		return -1;
+	}
+
+	for (overlay = of_next_blob(blob);
+	     (overlay < area) && !check_dt_blob_valid(overlay);
+	     overlay = of_next_blob(overlay)) {
+		if (of_get_dt_total_size(overlay)
+				> (unsigned int)(area - overlay)) {
+			dbg_info("DT: the overlay at %x overflows its area\n",
+				 (unsigned int)overlay);
+			break;
+		}
+
+		if (!overlay_selected(overlay))
+			continue;
+
+		memmove(end, overlay, of_get_dt_total_size(overlay));
+		end = of_next_blob(end);
+	}
+
+	for (overlay = buffer; overlay < end; overlay = of_next_blob(overlay)) {
+		if (of_overlay_apply(blob, CONFIG_OF_OVERLAY_BUFFER_OFFSET,
+				     overlay)) {
+			dbg_info("DT: failed to apply the overlay at %x\n",
+				 (unsigned int)overlay);
+			return -1;
+		}
+		count++;
+	}
+
+	if (count)
+		dbg_info("DT: %d overlays applied\n", count);
+
+	return 0;
+}
+#endif
+
 static int setup_dt_blob(void *blob)
 {
+	struct of_fixups fixups;
 	int ret;
+#ifdef CONFIG_LOAD_HW_INFO
+	unsigned int revision;
+#endif
+#if defined(CONFIG_PIT) || defined(CONFIG_PIT64B)
+	unsigned int boot_time;
+#endif
 #if !defined(CONFIG_LOAD_OPTEE)
 	unsigned int mem_bank = AT91C_BASE_DDRCS;
-	unsigned int mem_bank2 = 0;
 	unsigned int mem_size = 0;
+	unsigned int reg[2];
 #if defined(CONFIG_SDRAM)
 	mem_size = get_sdram_size();
 #elif defined(CONFIG_DDRC) || defined(CONFIG_UMCTL2)
@@ -52,6 +145,15 @@ static int setup_dt_blob(void *blob)
 	dbg_info("DT: Using device tree in place at %x\n",
 						(unsigned int)blob);
 
+#ifdef CONFIG_OF_OVERLAY
+	if (setup_dt_overlays(blob))
+		return -1;
+#endif
+
+	/* All the fixups are collected, then applied in one pass */
+	of_fixups_init(&fixups);
+	ret = 0;
+
 	/* no point in fixing if we do not have configured bootargs */
 	if (bootargs && *bootargs) {
 		char *p;
@@ -63,9 +165,8 @@ static int setup_dt_blob(void *blob)
 		if (*p == '\0')
 			return -1;
 
-		ret = fixup_chosen_node(blob, p);
-		if (ret)
-			return ret;
+		ret |= of_fixup_add(&fixups, "chosen", "bootargs",
+				    p, strlen(p) + 1);
 	}
 
 /*
@@ -76,11 +177,54 @@ static int setup_dt_blob(void *blob)
  * already correctly configured.
  */
 #if !defined(CONFIG_LOAD_OPTEE)
-	ret = fixup_memory_node(blob, &mem_bank, &mem_bank2, &mem_size);
-	if (ret)
-		return ret;
+	reg[0] = swap_uint32(mem_bank);
+	reg[1] = swap_uint32(mem_size);
+	ret |= of_fixup_add(&fixups, "memory",
+			    "device_type", "memory", sizeof("memory"));
+	ret |= of_fixup_add(&fixups, "memory", "reg", reg, sizeof(reg));
+#endif
+
+#ifdef CONFIG_LOAD_HW_INFO
+	/* The board serial number and revision, as the ATAG path passes them */
+	setup_serial_number(get_sys_sn());
+	ret |= of_fixup_add(&fixups, "", "serial-number",
+			    serial_number, sizeof(serial_number));
+
+	revision = swap_uint32(get_sys_rev());
+	ret |= of_fixup_add(&fixups, "chosen", "at91bootstrap,board-revision",
+			    &revision, sizeof(revision));
+#endif
+
+#if defined(CONFIG_PIT) || defined(CONFIG_PIT64B)
+	/* The boot time so far, from the timer start in hw_init() */
+	boot_time = swap_uint32(timer_ticks_to_usec(timer_get_counter()));
+	ret |= of_fixup_add(&fixups, "chosen", "at91bootstrap,boot-time-us",
+			    &boot_time, sizeof(boot_time));
 #endif
 
+#ifdef CONFIG_MEASURED_BOOT
+	{
+		const void *log;
+		unsigned int len = measure_get_log(&log);
+
+		if (len)
+			ret |= of_fixup_add(&fixups, "chosen",
+					"at91bootstrap,measurements", log, len);
+	}
+#endif
+
+	/* A fixup which does not fit would be silently left out */
+	if (ret) {
+		dbg_info("DT: fail to collect fixups\n");
+		return ret;
+	}
+
+	ret = of_fixups_apply(blob, &fixups);
+	if (ret) {
+		dbg_info("DT: fail to apply fixups\n");
+		return ret;
+	}
+
 	return 0;
 }
 #else
@@ -223,6 +367,11 @@ int kernel_size(unsigned char *add)
 	return 0;
 }
 
+int kernel_check_data(unsigned char *addr)
+{
+	return 0;
+}
+
 static int boot_image_setup(unsigned char *addr, unsigned int *entry)
 {
 	*entry = (unsigned int)addr;
@@ -256,6 +405,23 @@ struct linux_zimage_header {
 	unsigned int	end;
 };
 
+#ifdef CONFIG_UIMAGE_CRC
+/* The header CRC is computed with its own field cleared */
+static int uimage_check_header(struct linux_uimage_header *uimage_header)
+{
+	struct linux_uimage_header header = *uimage_header;
+
+	header.header_crc = 0;
+	if (crc32(0, &header, sizeof(header))
+	    != swap_uint32(uimage_header->header_crc)) {
+		dbg_info("KERNEL: uImage header CRC error\n");
+		return -1;
+	}
+
+	return 0;
+}
+#endif
+
 int kernel_size(unsigned char *addr)
 {
 	struct linux_uimage_header *uimage_header
@@ -266,9 +432,15 @@ int kernel_size(unsigned char *addr)
 	unsigned int size = -1;
 	unsigned int magic = swap_uint32(uimage_header->magic);
 
-	if (magic == LINUX_UIMAGE_MAGIC)
+	if (magic == LINUX_UIMAGE_MAGIC) {
+#ifdef CONFIG_UIMAGE_CRC
+		/* a corrupted header is rejected before the image is read */
+		if (uimage_check_header(uimage_header))
+			return -1;
+#endif
 		size = swap_uint32(uimage_header->size)
 			+ sizeof(struct linux_uimage_header);
+	}
 
 	if (zimage_header->magic == LINUX_ZIMAGE_MAGIC)
 		size = zimage_header->end - zimage_header->start;
@@ -279,6 +451,26 @@ int kernel_size(unsigned char *addr)
 	return (int)size;
 }
 
+/* Only a uImage carries a checksum of its payload */
+int kernel_check_data(unsigned char *addr)
+{
+#ifdef CONFIG_UIMAGE_CRC
+	struct linux_uimage_header *uimage_header
+			= (struct linux_uimage_header *)addr;
+
+	if (swap_uint32(uimage_header->magic) != LINUX_UIMAGE_MAGIC)
+		return 0;
+
+	if (crc32(0, addr + sizeof(struct linux_uimage_header),
+		  swap_uint32(uimage_header->size))
+	    != swap_uint32(uimage_header->data_crc)) {
+		dbg_info("KERNEL: uImage data CRC error\n");
+		return -1;
+	}
+#endif
+	return 0;
+}
+
 static int boot_image_setup(unsigned char *addr, unsigned int *entry)
 {
 	struct linux_zimage_header *zimage_header
@@ -307,6 +499,11 @@ static int boot_image_setup(unsigned char *addr, unsigned int *entry)
 			return -1;
 		}
 
+#ifdef CONFIG_UIMAGE_CRC
+		if (uimage_check_header(uimage_header))
+			return -1;
+#endif
+
 		size = swap_uint32(uimage_header->size);
 		dest = swap_uint32(uimage_header->load);
 		src = (unsigned int)addr + sizeof(struct linux_uimage_header);
@@ -314,7 +511,16 @@ static int boot_image_setup(unsigned char *addr, unsigned int *entry)
 
 		dbg_info("KERNEL: Relocating image dest=%x, src=%x\n", dest, src);
 
+#if defined(CONFIG_UIMAGE_CRC) && !defined(CONFIG_AB_SLOTS)
+		/* checked as it is relocated, the payload is read once */
+		if (crc32_copy(0, (void *)dest, (void *)src, size)
+		    != swap_uint32(uimage_header->data_crc)) {
+			dbg_info("KERNEL: uImage data CRC error\n");
+			return -1;
+		}
+#else
 		memcpy((void *)dest, (void *)src, size);
+#endif
 
 		dbg_info("KERNEL: %x bytes relocated\n", size);
 
@@ -421,9 +627,12 @@ int load_kernel(struct image_info *image)
 	bootargs = board_override_cmd_line_ext(image->cmdline_args);
 #endif
 #if defined(CONFIG_SECURE)
+#ifndef CONFIG_AB_SLOTS
+	/* the A/B slots check the image as it is loaded */
 	ret = secure_check(image->dest);
 	if (ret)
 		return ret;
+#endif
 	image->dest += sizeof(at91_secure_header_t);
 #endif
 
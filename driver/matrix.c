@@ -8,6 +8,7 @@
 #include "pmc.h"
 #include "arch/tz_matrix.h"
 #include "debug.h"
+#include "string.h"
 
 #define SECURITY_TYPE_AS	1
 #define SECURITY_TYPE_NS	2
@@ -19,6 +20,14 @@ struct peri_security {
 	unsigned int	security_type;
 };
 
+#ifdef CONFIG_SAMA5D4
+/* One bit per non secure peripheral, built once the security is set */
+static unsigned int peri_ns_bitmap[(AT91C_ID_COUNTS + 31) / 32];
+static unsigned int peri_ns_bitmap_valid;
+
+static void peri_ns_bitmap_build(void);
+#endif
+
 static const struct peri_security peri_security_array[] = {
 #ifdef CONFIG_SAMA5D4
 	{
@@ -452,7 +461,7 @@ static int matrix_set_peri_security(unsigned int matrix_base, unsigned peri_id)
 	if (idx > 3)
 		return -1;
 
-	bit = (0x01 << (peri_id % 32));
+	bit = (0x01U << (peri_id % 32));
 
 	spselr = matrix_read(matrix_base, MATRIX_SPSELR(idx));
 	spselr |= bit;
@@ -484,18 +493,15 @@ int matrix_configure_peri_security(unsigned int *peri_id, unsigned int size)
 			return -1;
 	}
 
+#ifdef CONFIG_SAMA5D4
+	peri_ns_bitmap_build();
+#endif
+
 	return 0;
 }
 
 #ifdef CONFIG_SAMA5D4
-/*
- * is_peripheral_secure - tell if the peripheral is in secure mode
- * @periph_id: the peripheral id that is checked
- *
- * Check security of a particular peripheral by providing its ID.
- * Note that a wrong preripheral ID leads to the "true" return code.
- */
-int is_peripheral_secure(unsigned int periph_id)
+static int peri_security_read(unsigned int periph_id)
 {
 	struct peri_security *peripheral_sec;
 	unsigned int mask;
@@ -515,7 +521,7 @@ int is_peripheral_secure(unsigned int periph_id)
 		if (!peripheral_sec->matrix_base)
 			return -1;
 
-		mask = 1 << (periph_id % 32);
+		mask = 1U << (periph_id % 32);
 		if (matrix_read(peripheral_sec->matrix_base,
 				MATRIX_SPSELR(periph_id / 32)) & mask)
 			return 0;
@@ -524,6 +530,40 @@ int is_peripheral_secure(unsigned int periph_id)
 	return 1;
 }
 
+/*
+ * The security of the peripherals does not change once configured, the
+ * clock SMCs of the Normal World test it from the bitmap.
+ */
+static void peri_ns_bitmap_build(void)
+{
+	unsigned int i;
+
+	memset(peri_ns_bitmap, 0, sizeof(peri_ns_bitmap));
+	for (i = 0; i < AT91C_ID_COUNTS; i++)
+		if (!peri_security_read(i))
+			peri_ns_bitmap[i / 32] |= 1U << (i % 32);
+
+	peri_ns_bitmap_valid = 1;
+}
+
+/*
+ * is_peripheral_secure - tell if the peripheral is in secure mode
+ * @periph_id: the peripheral id that is checked
+ *
+ * Check security of a particular peripheral by providing its ID.
+ * Note that a wrong preripheral ID leads to the "true" return code.
+ */
+int is_peripheral_secure(unsigned int periph_id)
+{
+	if (!peri_ns_bitmap_valid)
+		return peri_security_read(periph_id);
+
+	if (periph_id >= AT91C_ID_COUNTS)
+		return 1;
+
+	return !(peri_ns_bitmap[periph_id / 32] & (1U << (periph_id % 32)));
+}
+
 int is_sys_clk_secure(unsigned int sys_mask)
 {
 	unsigned int periph_id = sys_mask_to_per_id(sys_mask);
@@ -10,6 +10,13 @@
 #include "sdhc.h"
 #include "debug.h"
 
+/* The next boot media are identified while the card is busy */
+#ifdef CONFIG_BOOT_FALLBACK
+#define identification_delay(usec)	boot_media_delay(usec)
+#else
+#define identification_delay(usec)	udelay(usec)
+#endif
+
 #define DEFAULT_SD_BLOCK_LEN		512
 
 static struct sdcard_register	sdcard_register;
@@ -80,6 +87,8 @@ static int sd_cmd_send_app_cmd(struct sd_card *sdcard)
 /* Host Capacity Support / Card Capacity Status */
 #define OCR_HCR_CCS		(0x01 << 30)
 #define OCR_BUSY_STATUS		(0x01 << 31)
+/* Switching to 1.8V Request / Accepted */
+#define OCR_S18R_S18A		(0x01 << 24)
 static int sd_cmd_app_sd_send_op_cmd(struct sd_card *sdcard,
 				unsigned int capacity_support,
 				unsigned int *reponse)
@@ -94,6 +103,10 @@ static int sd_cmd_app_sd_send_op_cmd(struct sd_card *sdcard,
 				& OCR_VOLTAGE_27_36_MASK;
 	if (capacity_support)
 		command->argu |= OCR_HCR_CCS;
+#ifdef CONFIG_SDHC_UHS
+	if (capacity_support && host->caps_1v8)
+		command->argu |= OCR_S18R_S18A;
+#endif
 
 	ret = host->ops->send_command(command, 0);
 	if (ret)
@@ -129,7 +142,7 @@ static int sd_check_operational_condition(struct sd_card *sdcard,
 		if (response & OCR_BUSY_STATUS)
 			break;
 
-		udelay(1000);
+		identification_delay(1000);
 	};
 
 	if (i == retries)
@@ -140,6 +153,38 @@ static int sd_check_operational_condition(struct sd_card *sdcard,
 	return 0;
 }
 
+#ifdef CONFIG_SDHC_UHS
+/*
+ * Refer to Physical Layer Specification Version 3.01
+ * 4.2.4.2 Initialization Sequence for UHS-I
+ */
+static int sd_switch_voltage_1v8(struct sd_card *sdcard)
+{
+	struct sd_host *host = sdcard->host;
+	struct sd_command *command = sdcard->command;
+	int ret;
+
+	if (!host->ops->set_signal_voltage_1v8)
+		return -1;
+
+	command->cmd = SD_CMD_VOLTAGE_SWITCH;
+	command->resp_type = SD_RESP_TYPE_R1;
+	command->argu = 0;
+
+	ret = host->ops->send_command(command, 0);
+	if (ret)
+		return ret;
+
+	ret = host->ops->set_signal_voltage_1v8(sdcard);
+	if (ret)
+		return ret;
+
+	sdcard->uhs_support = 1;
+
+	return 0;
+}
+#endif
+
 static int sd_cmd_all_send_cid(struct sd_card *sdcard)
 {
 	struct sd_host *host = sdcard->host;
@@ -350,6 +395,7 @@ static int sd_set_bus_width(struct sd_card *sdcard,
 #define	SD_SWITCH_FUNC_SDR50		0x02
 #define SD_SWITCH_FUNC_SDR104		0x03
 #define SD_SWITCH_FUNC_DDR50		0x04
+#define SD_SWITCH_FUNC_CURRENT		0x0f
 
 static int sd_cmd_switch_fun(struct sd_card *sdcard,
 				unsigned int mode,
@@ -486,6 +532,83 @@ static int sd_card_set_bus_width(struct sd_card *sdcard)
 	return 0;
 }
 
+#ifdef CONFIG_SDHC_UHS
+/*
+ * Select the fastest UHS-I bus speed mode supported by the card and the
+ * host, on the 4-bit bus, then tune the sampling clock if needed.
+ */
+static int sd_uhs_initialization(struct sd_card *sdcard)
+{
+	struct sd_host *host = sdcard->host;
+	unsigned int switch_func_status[16];
+	unsigned int support;
+	unsigned int func;
+	unsigned int clock;
+	int ret;
+
+	ret = sd_card_set_bus_width(sdcard);
+	if (ret)
+		return ret;
+
+	/* Mode 0 operation: read the functions supported by the card */
+	ret = sd_cmd_switch_fun(sdcard,
+				SD_SWITCH_MODE_CHECK,
+				SD_SWITCH_GRP_ACCESS_MODE,
+				SD_SWITCH_FUNC_CURRENT,
+				switch_func_status);
+	if (ret)
+		return ret;
+
+	support = swap_uint32(switch_func_status[3]) >> 16;
+
+	if ((support & (0x01 << SD_SWITCH_FUNC_SDR104)) && host->caps_sdr104) {
+		func = SD_SWITCH_FUNC_SDR104;
+		clock = 208000000;
+	} else if ((support & (0x01 << SD_SWITCH_FUNC_SDR50)) &&
+		   host->caps_sdr50) {
+		func = SD_SWITCH_FUNC_SDR50;
+		clock = 100000000;
+	} else {
+		func = SD_SWITCH_FUNC_HS_SDR25;
+		clock = 50000000;
+	}
+
+	/* Mode 1 operation: set function */
+	ret = sd_cmd_switch_fun(sdcard,
+				SD_SWITCH_MODE_SET,
+				SD_SWITCH_GRP_ACCESS_MODE,
+				func,
+				switch_func_status);
+	if (ret)
+		return ret;
+
+	if (((swap_uint32(switch_func_status[4]) >> 24) & 0x0f) != func)
+		return -1;
+
+	/* The SD_SWITCH_FUNC_* values of group 1 match the UHS-I timings */
+	ret = host->ops->set_timing(sdcard, func);
+	if (ret)
+		return ret;
+
+	host->ops->set_clock(sdcard, clock);
+	sdcard->highspeed_card = 1;
+
+	if ((func == SD_SWITCH_FUNC_SDR104) ||
+	    ((func == SD_SWITCH_FUNC_SDR50) && host->caps_tune_sdr50)) {
+		ret = host->ops->execute_tuning(sdcard,
+						SD_CMD_SEND_TUNING_BLOCK);
+		if (ret)
+			return ret;
+	}
+
+	dbg_info("SD: UHS-I %s mode\n",
+		 (func == SD_SWITCH_FUNC_SDR104) ? "SDR104" :
+		 (func == SD_SWITCH_FUNC_SDR50) ? "SDR50" : "SDR25");
+
+	return 0;
+}
+#endif
+
 /*-----------------------------------------------------------------*/
 #define OCR_VOLTAGE_WIN_27_36	0x00FF8000
 #define OCR_ACCESS_MODE		0x60000000
@@ -537,7 +660,7 @@ static int mmc_verify_operating_condition(struct sd_card *sdcard)
 		if (command->resp[0]  & (0x01 << 31))
 			break;
 
-		udelay(1000);
+		identification_delay(1000);
 	};
 
 	if (i == retries)
@@ -605,6 +728,7 @@ static int mmc_cmd_send_ext_csd(struct sd_card *sdcard, char *ext_csd)
 #define MMC_EXT_CSD_ACCESS_CLEAR_BITS	0x02
 #define MMC_EXT_CSD_ACCESS_WRITE_BYTE	0x03
 
+#define EXT_CSD_BYTE_PARTITION_CONFIG	179
 #define EXT_CSD_BYTE_BUS_WIDTH		183
 #define EXT_CSD_BYTE_HS_TIMING		185
 #define EXT_CSD_BYTE_POWER_CLASS	187
@@ -613,6 +737,30 @@ static int mmc_cmd_send_ext_csd(struct sd_card *sdcard, char *ext_csd)
 #define EXT_CSD_BYTE_EXT_CSD_REV	192
 #define EXT_CSD_BYTE_CSD_STRUCTURE	194
 #define EXT_CSD_BYTE_CARD_TYPE		196
+#define EXT_CSD_BYTE_SEC_COUNT		212
+
+/* EXT_CSD_BYTE_CARD_TYPE */
+#define EXT_CSD_CARD_TYPE_HS200_1V8	(0x01 << 4)
+
+/* EXT_CSD_BYTE_HS_TIMING */
+#define EXT_CSD_TIMING_HS		1
+#define EXT_CSD_TIMING_HS200		2
+
+/* EXT_CSD_BYTE_PARTITION_CONFIG */
+#define EXT_CSD_PART_ACCESS_MASK	0x07
+#define EXT_CSD_PART_ENABLE(config)	(((config) >> 3) & 0x07)
+#define EXT_CSD_PART_USER		0
+#define EXT_CSD_PART_BOOT0		1
+#define EXT_CSD_PART_BOOT1		2
+#define EXT_CSD_PART_ENABLE_USER	7
+
+static unsigned int ext_csd_sec_count(const char *ext_csd)
+{
+	const unsigned char *p = (const unsigned char *)ext_csd
+					+ EXT_CSD_BYTE_SEC_COUNT;
+
+	return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+}
 
 static int mmc_card_identify(struct sd_card *sdcard)
 {
@@ -658,17 +806,66 @@ static int mmc_card_identify(struct sd_card *sdcard)
 		dbg_printf("MMC: unknown revision\n");
 	};
 
+	sdcard->ext_csd_rev = ext_csd[EXT_CSD_BYTE_EXT_CSD_REV];
+	sdcard->sec_count = ext_csd_sec_count(ext_csd);
+	sdcard->partition_config = ext_csd[EXT_CSD_BYTE_PARTITION_CONFIG];
+
 	sdcard->highspeed_card = !!(cardtype & 0x02);
 	sdcard->ddr_support = !!(cardtype & 0x04);
+	sdcard->hs200_support = !!(ext_csd[EXT_CSD_BYTE_CARD_TYPE]
+				   & EXT_CSD_CARD_TYPE_HS200_1V8);
 
 	if (sdcard->highspeed_card)
 		dbg_printf("MMC: highspeed supported\n");
 	if (sdcard->ddr_support)
 		dbg_printf("MMC: Dual Data Rate supported\n");
+	if (sdcard->hs200_support)
+		dbg_printf("MMC: HS200 supported\n");
 
 	return 0;
 }
 
+#ifndef CONFIG_EMMC_USER_AREA
+/*
+ * Refer to JEDEC JESD84-B51
+ * 6.2.5 Access partitions: the following block reads are served from
+ * the boot partition, the boot configuration bits are kept.
+ */
+static int mmc_select_partition(struct sd_card *sdcard)
+{
+	unsigned int config = sdcard->partition_config;
+	unsigned int part;
+	int ret;
+
+#if defined(CONFIG_EMMC_BOOT0)
+	part = EXT_CSD_PART_BOOT0;
+#elif defined(CONFIG_EMMC_BOOT1)
+	part = EXT_CSD_PART_BOOT1;
+#else
+	/* The partition the ROM code boots from */
+	part = EXT_CSD_PART_ENABLE(config);
+	if (part == EXT_CSD_PART_ENABLE_USER || part > EXT_CSD_PART_BOOT1)
+		part = EXT_CSD_PART_USER;
+#endif
+
+	if ((config & EXT_CSD_PART_ACCESS_MASK) == part)
+		return 0;
+
+	config = (config & ~EXT_CSD_PART_ACCESS_MASK) | part;
+	ret = mmc_cmd_switch_fun(sdcard,
+			MMC_EXT_CSD_ACCESS_WRITE_BYTE,
+			EXT_CSD_BYTE_PARTITION_CONFIG,
+			config);
+	if (ret)
+		return ret;
+
+	sdcard->partition_config = config;
+	dbg_info("MMC: reading from hardware partition %d\n", part);
+
+	return 0;
+}
+#endif
+
 static int mmc_switch_high_speed(struct sd_card *sdcard)
 {
 	char ext_csd[DEFAULT_SD_BLOCK_LEN];
@@ -677,7 +874,7 @@ static int mmc_switch_high_speed(struct sd_card *sdcard)
 	ret = mmc_cmd_switch_fun(sdcard,
 			MMC_EXT_CSD_ACCESS_WRITE_BYTE,
 			EXT_CSD_BYTE_HS_TIMING,
-			1);
+			EXT_CSD_TIMING_HS);
 	if (ret)
 		return ret;
 
@@ -691,6 +888,58 @@ static int mmc_switch_high_speed(struct sd_card *sdcard)
 	return 0;
 }
 
+#ifdef CONFIG_SDHC_HS200
+/*
+ * Refer to JEDEC JESD84-B51
+ * 6.6.5 Bus timing and HS200 mode selection, on the bus width already
+ * selected. On tuning failure the device is put back in high speed.
+ */
+static int mmc_switch_hs200(struct sd_card *sdcard)
+{
+	struct sd_host *host = sdcard->host;
+	int ret;
+
+	if (!host->ops->set_signal_voltage_1v8 || !host->ops->set_timing ||
+	    !host->ops->execute_tuning)
+		return -1;
+
+	ret = host->ops->set_signal_voltage_1v8(sdcard);
+	if (ret)
+		return ret;
+
+	ret = mmc_cmd_switch_fun(sdcard,
+			MMC_EXT_CSD_ACCESS_WRITE_BYTE,
+			EXT_CSD_BYTE_HS_TIMING,
+			EXT_CSD_TIMING_HS200);
+	if (ret)
+		return ret;
+
+	ret = host->ops->set_timing(sdcard, MMC_TIMING_HS200);
+	if (ret)
+		goto fallback;
+
+	host->ops->set_clock(sdcard, 200000000);
+
+	ret = host->ops->execute_tuning(sdcard, MMC_CMD_SEND_TUNING_BLOCK);
+	if (ret)
+		goto fallback;
+
+	dbg_info("MMC: HS200 mode\n");
+
+	return 0;
+
+fallback:
+	host->ops->set_timing(sdcard, SD_TIMING_LEGACY);
+	host->ops->set_clock(sdcard, 26000000);
+	mmc_cmd_switch_fun(sdcard,
+			MMC_EXT_CSD_ACCESS_WRITE_BYTE,
+			EXT_CSD_BYTE_HS_TIMING,
+			EXT_CSD_TIMING_HS);
+
+	return ret;
+}
+#endif
+
 static int mmc_cmd_bustest_w(struct sd_card *sdcard,
 				unsigned int buswidth,
 				unsigned char *buffer)
@@ -793,6 +1042,42 @@ static int mmc_bus_width_select(struct sd_card *sdcard, unsigned int buswidth,
 	return 0;
 }
 
+/*
+ * Select the widest bus of the host, and read EXT_CSD over it: when the
+ * identification fields come back unchanged, all the data lines work and
+ * the bus test is not needed.
+ */
+static int mmc_select_host_buswidth(struct sd_card *sdcard)
+{
+	struct sd_host *host = sdcard->host;
+	char ext_csd[DEFAULT_SD_BLOCK_LEN];
+	unsigned int busw;
+	int ret;
+
+	if (host->caps_bus_width & BUS_WIDTH_8_BIT)
+		busw = 8;
+	else if (host->caps_bus_width & BUS_WIDTH_4_BIT)
+		busw = 4;
+	else
+		return -1;
+
+	ret = mmc_bus_width_select(sdcard, busw, 0);
+	if (ret)
+		return ret;
+
+	ret = mmc_cmd_send_ext_csd(sdcard, ext_csd);
+	if (ret)
+		return ret;
+
+	if ((ext_csd[EXT_CSD_BYTE_EXT_CSD_REV] != sdcard->ext_csd_rev) ||
+	    (ext_csd_sec_count(ext_csd) != sdcard->sec_count))
+		return -1;
+
+	dbg_info("MMC: %d-bit bus width selected\n", busw);
+
+	return 0;
+}
+
 static int mmc_detect_buswidth(struct sd_card *sdcard)
 {
 	unsigned char data_8bits[8] = {0x55, 0xaa, 0, 0, 0, 0, 0, 0};
@@ -854,13 +1139,13 @@ static int sdcard_identification(struct sd_card *sdcard)
 {
 	int ret;
 
-	udelay(3000);
+	identification_delay(3000);
 
 	ret = sd_cmd_go_idle_state(sdcard);
 	if (ret)
 		return ret;
 
-	udelay(2000);
+	identification_delay(2000);
 
 	ret = mmc_verify_operating_condition(sdcard);
 	if (ret == 0) {
@@ -887,6 +1172,17 @@ static int sdcard_identification(struct sd_card *sdcard)
 		}
 
 		sdcard->card_type = CARD_TYPE_SD;
+
+#ifdef CONFIG_SDHC_UHS
+		/* CMD11 has to follow ACMD41, before the card sends its CID */
+		if (sdcard->reg->ocr & OCR_S18R_S18A) {
+			ret = sd_switch_voltage_1v8(sdcard);
+			if (ret) {
+				dbg_info("SD: 1.8V signaling switch failed\n");
+				return ret;
+			}
+		}
+#endif
 	} else if (ret == ERROR_UNUSABLE_CARD) {
 		/*
 		 * Non-compatible voltage range
@@ -989,6 +1285,11 @@ static int sd_initialization(struct sd_card *sdcard)
 		dbg_info("1.0 and 1.01\n");
 	}
 
+#ifdef CONFIG_SDHC_UHS
+	if (sdcard->uhs_support)
+		return sd_uhs_initialization(sdcard);
+#endif
+
 	if (host->caps_high_speed) {
 		if (sdcard->sd_spec_version != SD_VERSION_1_0) {
 			ret = sd_switch_func_high_speed(sdcard);
@@ -1058,6 +1359,14 @@ static int mmc_initialization(struct sd_card *sdcard)
 	if (ret)
 		return ret;
 
+#ifndef CONFIG_EMMC_USER_AREA
+	if (sdcard->sd_spec_version >= MMC_VERSION_4) {
+		ret = mmc_select_partition(sdcard);
+		if (ret)
+			return ret;
+	}
+#endif
+
 	if (sdcard->host->caps_high_speed) {
 		if (sdcard->sd_spec_version >= MMC_VERSION_4) {
 			ret = mmc_switch_high_speed(sdcard);
@@ -1069,7 +1378,8 @@ static int mmc_initialization(struct sd_card *sdcard)
 	/* Bustest does not work below 26 Mhz */
 	host->ops->set_clock(sdcard, 26000000);
 
-	if (sdcard->sd_spec_version >= MMC_VERSION_4) {
+	if (sdcard->sd_spec_version >= MMC_VERSION_4 &&
+	    mmc_select_host_buswidth(sdcard)) {
 		ret = mmc_detect_buswidth(sdcard);
 		if (ret) {
 			console_printf("MMC: Bustest failed !\n");
@@ -1077,6 +1387,17 @@ static int mmc_initialization(struct sd_card *sdcard)
 		}
 	}
 
+#ifdef CONFIG_SDHC_HS200
+	if (sdcard->hs200_support && host->caps_sdr104 && host->caps_1v8 &&
+	    (sdcard->configured_bus_w != 1)) {
+		ret = mmc_switch_hs200(sdcard);
+		if (ret == 0)
+			return 0;
+
+		console_printf("MMC: HS200 mode could not be enabled: %d\n", ret);
+	}
+#endif
+
 	/* Now we can go to cruise speed */
 	if (host->ops->set_clock) {
 		if (sdcard->highspeed_card) {
@@ -1242,7 +1563,6 @@ static int sd_cmd_read_single_block(struct sd_card *sdcard,
 	return 1;
 }
 
-#define SUPPORT_MAX_BLOCKS	16
 unsigned int sdcard_block_read(unsigned int start,
 				unsigned int block_count,
 				void *buf)
@@ -1267,8 +1587,8 @@ unsigned int sdcard_block_read(unsigned int start,
 	}
 
 	for (blocks_todo = block_count; blocks_todo > 0; ) {
-		blocks = (blocks_todo > SUPPORT_MAX_BLOCKS) ?
-					SUPPORT_MAX_BLOCKS : blocks_todo;
+		blocks = (blocks_todo > SD_READ_MAX_BLOCKS) ?
+					SD_READ_MAX_BLOCKS : blocks_todo;
 
 		if (blocks > 1) {
 			blocks_read = sd_cmd_read_multiple_block(sdcard,
@@ -184,6 +184,43 @@ unsigned int mcp16502_regulator_get_enable(unsigned int regid)
 	return !!(val & MCP16502_EN);
 }
 
+/**
+ * mcp16502_regulator_setup()	- set regulator voltage and enable status
+ *
+ * @regid:	regulator identifier
+ * @uV:		regulator voltage (in microvolts)
+ * @enable:	new regulator status (0 - disable, 1 - enable)
+ *
+ * Both live in the same register, which is updated by a single read and
+ * a single write.
+ *
+ * Returns:	0 on success, negative number in case of failure
+ */
+static int mcp16502_regulator_setup(unsigned int regid, unsigned int uV,
+				    unsigned int enable)
+{
+	unsigned char steps, val;
+	int ret;
+
+	if (regid < MCP16502_MIN || regid > MCP16502_MAX ||
+	    uV < regulators[regid].min_uV || uV > regulators[regid].max_uV)
+		return -1;
+
+	ret = twi_read(mcp16502.busid, mcp16502.addr, MCP16502_BASE(regid),
+		       1, &val, 1);
+	if (ret)
+		return ret;
+
+	steps = div((uV - regulators[regid].min_uV), regulators[regid].step_uV);
+	val &= ~(MCP16502_VSEL | MCP16502_EN);
+	val |= (MCP16502_LOW_SEL + steps) & MCP16502_VSEL;
+	if (enable)
+		val |= MCP16502_EN;
+
+	return twi_write(mcp16502.busid, mcp16502.addr, MCP16502_BASE(regid),
+			 1, &val, 1);
+}
+
 /**
  * mcp16502_init()		- init MCP16502 PMIC
  *
@@ -214,18 +251,10 @@ int mcp16502_init(int busid, int addr, const struct pio_desc *lpm_desc,
 		if (!cfgs[i].uV)
 			continue;
 
-		ret = mcp16502_regulator_set_voltage(cfgs[i].regulator,
-						     cfgs[i].uV);
-		if (ret) {
-			dbg_very_loud("regulator (%d) set voltage failed\n",
-					cfgs[i].regulator);
-			return ret;
-		}
-
-		ret = mcp16502_regulator_set_enable(cfgs[i].regulator,
-						    cfgs[i].enable);
+		ret = mcp16502_regulator_setup(cfgs[i].regulator, cfgs[i].uV,
+					       cfgs[i].enable);
 		if (ret) {
-			dbg_very_loud("regulator (%d) enable failed\n",
+			dbg_very_loud("regulator (%d) setup failed\n",
 				      cfgs[i].regulator);
 			return ret;
 		}
@@ -0,0 +1,81 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "common.h"
+#include "hash.h"
+#include "measure.h"
+#include "string.h"
+#include "debug.h"
+
+#define MEASURE_NAME_LEN	8
+
+/*
+ * One entry per image loaded, in the order they were loaded: its name,
+ * zero padded, then its SHA-256 digest. The array is the value of the
+ * "at91bootstrap,measurements" property of /chosen.
+ */
+struct measurement {
+	char		name[MEASURE_NAME_LEN];
+	unsigned char	digest[HASH_SIZE];
+};
+
+static const char * const measure_names[MEASURE_COUNT] = {
+	"image",
+	"dtb",
+	"optee",
+};
+
+static struct measurement measure_log[MEASURE_COUNT];
+static unsigned int measure_count;
+static int measure_id = -1;
+
+void measure_begin(unsigned int id)
+{
+	measure_id = id;
+	hash_init();
+}
+
+/* Outside of a measurement, the data is not part of an image */
+void measure_update(const void *data, unsigned int len)
+{
+	if (measure_id >= 0)
+		hash_update(data, len);
+}
+
+void measure_end(void)
+{
+	struct measurement *entry;
+	char hex[2 * HASH_SIZE + 1];
+	unsigned int i;
+
+	if (measure_id < 0)
+		return;
+
+	/* A reload, after a failed A/B slot, replaces the entry */
+	for (i = 0; i < measure_count; i++)
+		if (!strcmp(measure_log[i].name, measure_names[measure_id]))
+			break;
+	if (i == measure_count)
+		measure_count++;
+
+	entry = &measure_log[i];
+	memset(entry->name, 0, MEASURE_NAME_LEN);
+	strcpy(entry->name, measure_names[measure_id]);
+	hash_final(entry->digest);
+	measure_id = -1;
+
+	for (i = 0; i < HASH_SIZE; i++) {
+		hex[2 * i] = "0123456789abcdef"[entry->digest[i] >> 4];
+		hex[2 * i + 1] = "0123456789abcdef"[entry->digest[i] & 0xf];
+	}
+	hex[2 * HASH_SIZE] = '\0';
+	dbg_info("MEASURE: %s: %s\n", entry->name, hex);
+}
+
+unsigned int measure_get_log(const void **log)
+{
+	*log = measure_log;
+
+	return measure_count * sizeof(struct measurement);
+}
@@ -0,0 +1,34 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "nand.h"
+
+/* As the Micron driver of Linux decodes it, for 4-bit and 8-bit parts */
+int nand_ondie_ecc_status(unsigned char status, unsigned int strength)
+{
+	if (status & STATUS_ERROR)
+		return -1;
+
+	if (strength == 4) {
+		/* The page is to rewrite, up to the strength corrected */
+		if (status & STATUS_ECC_4_REWRITE)
+			return 4;
+
+		return 0;
+	}
+
+	switch (status & STATUS_ECC_8_MASK) {
+	case 0:
+		return 0;
+	case STATUS_ECC_8_1_3_CORRECTED:
+		return 3;
+	case STATUS_ECC_8_4_6_CORRECTED:
+		return 6;
+	case STATUS_ECC_8_7_8_CORRECTED:
+		return 8;
+	default:
+		/* Uncorrectable, alone or with undefined count bits */
+		return -1;
+	}
+}
@@ -496,6 +496,14 @@ static int nand_init_on_die_ecc(void)
 }
 #endif /* #ifdef CONFIG_USE_ON_DIE_ECC_SUPPORT */
 
+#ifdef CONFIG_NAND_ON_DIE_ECC_CACHE_READ
+/* The On-Die ECC status of the cache reads is decoded as Micron reports it */
+#define NAND_MFR_MICRON		0x2c
+
+static unsigned int nand_cache_read;
+static unsigned int nand_ondie_ecc_bits;	/* 4 or 8 */
+#endif
+
 static void nandflash_read_id(unsigned char *manf_id, unsigned char *dev_id)
 {
 	nand_cs_enable();
@@ -901,6 +909,19 @@ static int nandflash_get_type(struct nand_info *nand)
 		return -1;
 #endif
 
+#ifdef CONFIG_NAND_ON_DIE_ECC_CACHE_READ
+	{
+		unsigned char manf_id, dev_id;
+
+		nandflash_read_id(&manf_id, &dev_id);
+		nand_ondie_ecc_bits = chip->eccbits;
+		nand_cache_read = (manf_id == NAND_MFR_MICRON) &&
+				  ((chip->eccbits == 4) || (chip->eccbits == 8));
+		if (!nand_cache_read)
+			dbg_info("NAND: No Micron 4/8-bit On-Die ECC, no cache reads\n");
+	}
+#endif
+
 	return nand_info_init(nand, chip);
 }
 
@@ -933,7 +954,8 @@ static void write_row_address(struct nand_info *nand,
 	}
 }
 
-static int nand_read_status(void)
+/* Wait for the device to be ready, return its status or -1 on timeout */
+static int nand_wait_status(void)
 {
 	unsigned int timeout = 1000;
 	unsigned char status;
@@ -949,6 +971,17 @@ static int nand_read_status(void)
 	if (!timeout)
 		return -1;
 
+	return status;
+}
+
+static int nand_read_status(void)
+{
+	int status;
+
+	status = nand_wait_status();
+	if (status < 0)
+		return -1;
+
 #ifdef CONFIG_ON_DIE_ECC
 	if (status & STATUS_ERROR) {
 		dbg_info("WARNING: Read On-Die ECC error\n");
@@ -993,6 +1026,112 @@ dma_stop:
 }
 #endif
 
+#ifdef CONFIG_NAND_ON_DIE_ECC_CACHE_READ
+static struct {
+	unsigned int pages;	/* pages with corrected bits */
+	unsigned int bits;	/* upper bound of the corrected bits */
+	unsigned int max;	/* worst page */
+} ondie_ecc_stats;
+
+static int nand_ondie_ecc_check(unsigned char status, unsigned int row_address)
+{
+	int bits;
+
+	bits = nand_ondie_ecc_status(status, nand_ondie_ecc_bits);
+	if (bits < 0) {
+		dbg_info("NAND: On-Die ECC uncorrectable error, page %x\n",
+			 row_address);
+		return -1;
+	}
+	if (!bits)
+		return 0;
+
+	dbg_loud("NAND: On-Die ECC corrected up to %d bits, page %x\n",
+		 bits, row_address);
+
+	ondie_ecc_stats.pages++;
+	ondie_ecc_stats.bits += bits;
+	if (bits > ondie_ecc_stats.max)
+		ondie_ecc_stats.max = bits;
+
+	return 0;
+}
+
+static void nand_read_data(struct nand_info *nand,
+			   unsigned char *buffer,
+			   unsigned int len)
+{
+	unsigned int i;
+
+	if (nand->buswidth) {
+		for (i = 0; i < len / 2; i++) {
+			*((short *)buffer) = read_word();
+			buffer += 2;
+		}
+	} else {
+#ifdef CONFIG_NAND_DMA_SUPPORT
+		nand_read_with_dma(buffer, len);
+#else
+		for (i = 0; i < len; i++)
+			*buffer++ = read_byte();
+#endif
+	}
+}
+
+/*
+ * Read consecutive pages of a block with the cache read sequence: once
+ * a page is moved to the cache register by 31h (or 3Fh for the last
+ * one), the device loads the next page into its data register while the
+ * current page is output. The status read after 31h/3Fh holds the
+ * On-Die ECC result of the page moved to the cache register.
+ */
+static int nand_read_pages_cached(struct nand_info *nand,
+				  unsigned int row_address,
+				  unsigned int numpages,
+				  unsigned char *buffer)
+{
+	unsigned int i;
+	int status;
+	int ret = 0;
+
+	nand_cs_enable();
+
+	nand->command(CMD_READ_1);
+	write_column_address(nand, 0);
+	write_row_address(nand, row_address);
+	nand->command(CMD_READ_2);
+
+	if (nand_wait_status() < 0) {
+		ret = -1;
+		goto out;
+	}
+
+	for (i = 0; i < numpages; i++) {
+		if (i == numpages - 1)
+			nand->command(CMD_READ_CACHE_END);
+		else
+			nand->command(CMD_READ_CACHE_SEQ);
+
+		status = nand_wait_status();
+		if ((status < 0) ||
+		    nand_ondie_ecc_check(status, row_address + i)) {
+			ret = -1;
+			break;
+		}
+
+		/* Back to data output after the status read */
+		nand->command(CMD_READ_1);
+		nand_read_data(nand, buffer, nand->pagesize);
+		buffer += nand->pagesize;
+	}
+
+out:
+	nand_cs_disable();
+
+	return ret;
+}
+#endif /* #ifdef CONFIG_NAND_ON_DIE_ECC_CACHE_READ */
+
 #ifdef CONFIG_NANDFLASH_SMALL_BLOCKS
 static int nand_read_sector(struct nand_info *nand, 
 			unsigned int row_address,
@@ -1312,6 +1451,16 @@ static int nand_loadimage(struct nand_info *nand,
 		}
 
 		/* read pages of a block */
+#ifdef CONFIG_NAND_ON_DIE_ECC_CACHE_READ
+		if (nand_cache_read) {
+			ret = nand_read_pages_cached(nand,
+					block * nand->pages_block + start_page,
+					end_page - start_page, buffer);
+			if (ret)
+				return -1;
+			buffer += numpages * nand->pagesize;
+		} else
+#endif
 		for (page = start_page; page < end_page; page++) {
 
 			ret = nand_read_page(nand, block, page,
@@ -1397,6 +1546,14 @@ int load_nandflash(struct image_info *image)
 	if (ret)
 		return ret;
 
+#ifdef CONFIG_NAND_ON_DIE_ECC_CACHE_READ
+	if (ondie_ecc_stats.pages)
+		dbg_info("NAND: On-Die ECC corrected %d pages, " \
+			 "up to %d bits, worst page %d bits\n",
+			 ondie_ecc_stats.pages, ondie_ecc_stats.bits,
+			 ondie_ecc_stats.max);
+#endif
+
 #ifdef CONFIG_OF_LIBFDT
 	length = update_image_length(&nand,
 			image->of_offset, image->of_dest, DT_BLOB);
@@ -1404,6 +1561,10 @@ int load_nandflash(struct image_info *image)
 		return -1;
 
 	image->of_length = length;
+#ifdef CONFIG_OF_OVERLAY
+	/* the overlays follow the blob, read them in the same pass */
+	image->of_length = OF_ALIGN(length) + CONFIG_OF_OVERLAY_AREA_SIZE;
+#endif
 
 	dbg_info("NAND: dt blob: Copy %x bytes from %x to %x\n",
 		image->of_length, image->of_offset, image->of_dest);
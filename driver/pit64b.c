@@ -90,6 +90,17 @@ void mdelay(unsigned int msec)
 	} while (current < end);
 }
 
+/* Lower 32 bits of the free running counter, at the PIT64B clock rate */
+unsigned int timer_get_counter(void)
+{
+	return pit64b_readl(MCHP_PIT64B_TLSBR);
+}
+
+unsigned int timer_get_rate(void)
+{
+	return clk_rate;
+}
+
 /* Init a special timer for slow clock switch function */
 static u64 timer1_base;
 
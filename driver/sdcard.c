@@ -9,16 +9,356 @@
 
 #include "string.h"
 
+#ifdef CONFIG_SDCARD_RAW
+#include "media.h"
+#ifdef CONFIG_SDCARD_RAW_GPT
+#include "crc32.h"
+#endif
+#else
 #include "ff.h"
+#endif
 
+#include "measure.h"
 #include "debug.h"
 
-#define CHUNK_SIZE	0x40000
+#if defined(CONFIG_OF_OVERLAY) || \
+	(defined(CONFIG_SDCARD_RAW) && defined(CONFIG_OF_LIBFDT))
+#include "fdt.h"
+#endif
+#ifdef CONFIG_LOAD_HW_INFO
+#include "board_hw_info.h"
+#endif
+#ifdef CONFIG_LOAD_OPTEE
+#include "optee.h"
+#endif
+
+static void sdcard_hw_init(void)
+{
+	static bool initialized = false;
+
+	if (initialized)
+		return;
+
+#ifdef CONFIG_AT91_MCI
+#if defined(CONFIG_AT91_MCI0)
+	at91_mci0_hw_init();
+#elif defined(CONFIG_AT91_MCI1)
+	at91_mci1_hw_init();
+#elif defined(CONFIG_AT91_MCI2)
+	at91_mci2_hw_init();
+#endif
+#endif
+
+#ifdef CONFIG_SDHC
+	at91_sdhc_hw_init();
+#endif
+	initialized = true;
+}
+
+#ifdef CONFIG_SDCARD_RAW
+#define SD_BLOCK_LEN	512
+
+#ifdef CONFIG_SDCARD_RAW_GPT
+#define GPT_HEADER_BLOCK	1
+#define GPT_SIGNATURE		"EFI PART"
+#define GPT_NAME_LEN		36
+
+/* As created by the usual tools: the entries take 16 KiB at most */
+#define GPT_MAX_ENTRIES		128
+#define GPT_ENTRY_SIZE		128
+
+/* The 64-bit block numbers are split, cards are below 2^32 blocks */
+struct gpt_header {
+	unsigned char	signature[8];
+	unsigned int	revision;
+	unsigned int	header_size;
+	unsigned int	header_crc32;
+	unsigned int	reserved;
+	unsigned int	my_lba[2];
+	unsigned int	alternate_lba[2];
+	unsigned int	first_usable_lba[2];
+	unsigned int	last_usable_lba[2];
+	unsigned char	disk_guid[16];
+	unsigned int	entries_lba[2];
+	unsigned int	num_entries;
+	unsigned int	entry_size;
+	unsigned int	entries_crc32;
+};
+
+struct gpt_entry {
+	unsigned char	type_guid[16];
+	unsigned char	unique_guid[16];
+	unsigned int	first_lba[2];
+	unsigned int	last_lba[2];
+	unsigned int	attributes[2];
+	unsigned short	name[GPT_NAME_LEN];	/* UTF-16LE */
+};
+
+static int gpt_name_match(const struct gpt_entry *entry, const char *name)
+{
+	unsigned int i;
+
+	for (i = 0; i < GPT_NAME_LEN; i++) {
+		if (entry->name[i] != (unsigned char)name[i])
+			return 0;
+		if (!name[i])
+			return 1;
+	}
+
+	return !name[i];
+}
+
+/*
+ * Read the partition table in one go into the buffer, the image area
+ * which is loaded next, and find the first block and the number of
+ * blocks of the named partitions.
+ */
+static int sdcard_gpt_find(unsigned char *buf, const char **names,
+			   unsigned int *start, unsigned int *count,
+			   unsigned int nparts)
+{
+	struct gpt_header *header = (struct gpt_header *)buf;
+	struct gpt_entry *entry;
+	unsigned char *entries = buf + SD_BLOCK_LEN;
+	unsigned int size, blocks;
+	unsigned int crc;
+	unsigned int i, j;
+	int found = 0;
+
+	if (sdcard_block_read(GPT_HEADER_BLOCK, 1, buf) != 1)
+		return -1;
+
+	if (memcmp(header->signature, GPT_SIGNATURE, 8)
+	    || (header->header_size < sizeof(struct gpt_header))
+	    || (header->header_size > SD_BLOCK_LEN)) {
+		dbg_info("SD/MMC: no GPT found\n");
+		return -1;
+	}
+
+	crc = header->header_crc32;
+	header->header_crc32 = 0;
+	if (crc32(0, header, header->header_size) != crc) {
+		dbg_info("SD/MMC: bad GPT header CRC\n");
+		return -1;
+	}
+
+	/* The entries are read into the image area, their size is bounded */
+	if (header->entries_lba[1]
+	    || (header->num_entries > GPT_MAX_ENTRIES)
+	    || (header->entry_size != GPT_ENTRY_SIZE)) {
+		dbg_info("SD/MMC: unsupported GPT entries\n");
+		return -1;
+	}
+
+	size = header->num_entries * header->entry_size;
+	blocks = (size + SD_BLOCK_LEN - 1) / SD_BLOCK_LEN;
+	if (sdcard_block_read(header->entries_lba[0],
+			      blocks, entries) != blocks)
+		return -1;
+
+	if (crc32(0, entries, size) != header->entries_crc32) {
+		dbg_info("SD/MMC: bad GPT entries CRC\n");
+		return -1;
+	}
+
+	for (i = 0; i < header->num_entries; i++) {
+		entry = (struct gpt_entry *)(entries + i * header->entry_size);
+		if (entry->first_lba[1] || entry->last_lba[1])
+			continue;
+
+		for (j = 0; j < nparts; j++) {
+			if (count[j] || !gpt_name_match(entry, names[j]))
+				continue;
+
+			start[j] = entry->first_lba[0];
+			count[j] = entry->last_lba[0] - entry->first_lba[0] + 1;
+			found++;
+		}
+	}
+
+	for (j = 0; j < nparts; j++)
+		if (!count[j])
+			dbg_info("SD/MMC: GPT partition %s not found\n",
+				 names[j]);
+
+	return (found == nparts) ? 0 : -1;
+}
+#endif
+
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+static int update_image_length(unsigned int start,
+				unsigned char *dest,
+				unsigned char flag)
+{
+	int ret;
+
+	if (sdcard_block_read(start, 1, dest) != 1)
+		return -1;
+
+	if (flag == KERNEL_IMAGE)
+		return kernel_size(dest);
+#ifdef CONFIG_OF_LIBFDT
+	else {
+		ret = check_dt_blob_valid((void *)dest);
+		if (!ret)
+			return of_get_dt_total_size((void *)dest);
+	}
+#endif
+	return -1;
+}
+#endif
+
+static int sdcard_raw_read(unsigned int start, unsigned int length,
+			   unsigned int limit, unsigned char *dest)
+{
+	unsigned int blocks = (length + SD_BLOCK_LEN - 1) / SD_BLOCK_LEN;
+
+	if (blocks > limit) {
+		dbg_info("SD/MMC: %x bytes do not fit in the partition\n",
+			 length);
+		return -1;
+	}
+
+#ifdef CONFIG_MEASURED_BOOT
+	/* by chunks, each one hashed while it is still in the cache */
+	while (blocks) {
+		unsigned int count = min(blocks,
+					 MEASURE_CHUNK_SIZE / SD_BLOCK_LEN);
+
+		if (sdcard_block_read(start, count, dest) != count)
+			return -1;
+		measure_update(dest, min(length, count * SD_BLOCK_LEN));
+
+		start += count;
+		blocks -= count;
+		dest += count * SD_BLOCK_LEN;
+		length -= min(length, count * SD_BLOCK_LEN);
+	}
+#else
+	if (sdcard_block_read(start, blocks, dest) != blocks)
+		return -1;
+#endif
+
+	return 0;
+}
+
+int load_sdcard(struct image_info *image)
+{
+	unsigned int limit[2] = {-1, -1};	/* partition blocks */
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	int length;
+#endif
+
+	sdcard_hw_init();
+
+	if (sdcard_initialize()) {
+		dbg_info("SD/MMC: card initialization error\n");
+		return -1;
+	}
+
+#ifdef CONFIG_SDCARD_RAW_GPT
+	{
+		const char *names[2] = {
+			CONFIG_SDCARD_RAW_IMG_PART,
+#ifdef CONFIG_OF_LIBFDT
+			CONFIG_SDCARD_RAW_OF_PART,
+#endif
+		};
+		unsigned int start[2];
+		unsigned int nparts = 1;
+
+#ifdef CONFIG_OF_LIBFDT
+		if (image->of_dest)
+			nparts = 2;
+#endif
+		memset(limit, 0, sizeof(limit));
+		if (sdcard_gpt_find(image->dest, names, start, limit, nparts))
+			return -1;
+
+		image->offset = start[0];
+#ifdef CONFIG_OF_LIBFDT
+		image->of_offset = start[1];
+#endif
+	}
+#endif
+
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	length = update_image_length(image->offset, image->dest, KERNEL_IMAGE);
+	if (length == -1)
+		return -1;
+
+	image->length = length;
+#endif
+
+	dbg_info("SD/MMC: Image: Read %x bytes from block %x to %x\n",
+		 image->length, image->offset, image->dest);
+
+	measure_begin(MEASURE_IMAGE);
+	if (sdcard_raw_read(image->offset, image->length,
+			    limit[0], image->dest))
+		return -1;
+	measure_end();
+
+#ifdef CONFIG_OF_LIBFDT
+	if (image->of_dest) {
+		length = update_image_length(image->of_offset,
+					     image->of_dest, DT_BLOB);
+		if (length == -1)
+			return -1;
+
+		image->of_length = length;
+#ifdef CONFIG_OF_OVERLAY
+		/* the overlays follow the blob, read them in the same pass */
+		image->of_length = OF_ALIGN(length)
+					+ CONFIG_OF_OVERLAY_AREA_SIZE;
+#endif
+
+		dbg_info("SD/MMC: dt blob: Read %x bytes from block %x to %x\n",
+			 image->of_length, image->of_offset, image->of_dest);
+
+		measure_begin(MEASURE_DTB);
+		if (sdcard_raw_read(image->of_offset, image->of_length,
+				    limit[1], image->of_dest))
+			return -1;
+		measure_end();
+	}
+#endif
+
+	return 0;
+}
+#else /* CONFIG_SDCARD_RAW */
+#ifdef CONFIG_MEASURED_BOOT
+/*
+ * By chunks, each one hashed while it is still in the cache. The chunks
+ * are whole sectors, the clusters are still read many sectors at once.
+ */
+static FRESULT sdcard_read(FIL *file, BYTE *dest, UINT size, UINT *byte_read)
+{
+	FRESULT	fret;
+	UINT	chunk;
+
+	for (*byte_read = 0; *byte_read < size; *byte_read += chunk) {
+		fret = f_read(file, dest + *byte_read,
+			      min(size - *byte_read, MEASURE_CHUNK_SIZE),
+			      &chunk);
+		if (fret != FR_OK)
+			return fret;
+		if (!chunk)
+			break;
+
+		measure_update(dest + *byte_read, chunk);
+	}
+
+	return FR_OK;
+}
+#else
+#define sdcard_read(file, dest, size, byte_read) \
+	f_read(file, dest, size, byte_read)
+#endif
 
 static int sdcard_loadimage(char *filename, BYTE *dest)
 {
 	FIL 	file;
-	UINT	byte_to_read = CHUNK_SIZE;
 	UINT	byte_read;
 	FRESULT	fret;
 	int	ret;
@@ -30,13 +370,9 @@ static int sdcard_loadimage(char *filename, BYTE *dest)
 		goto open_fail;
 	}
 
-	do {
-		byte_read = 0;
-		fret = f_read(&file, (void *)(dest), byte_to_read, &byte_read);
-		dest += byte_to_read;
-	} while (byte_read >= byte_to_read);
-
-	if (fret != FR_OK) {
+	/* In one go, so that the contiguous clusters make a single read */
+	fret = sdcard_read(&file, dest, file.fsize, &byte_read);
+	if ((fret != FR_OK) || (byte_read != file.fsize)) {
 		dbg_info("*** FATFS: f_read: error\n");
 		 ret = -1;
 		goto read_fail;
@@ -51,6 +387,120 @@ open_fail:
 
 }
 
+#if defined(CONFIG_AB_SLOTS) && defined(CONFIG_LINUX_IMAGE) \
+	&& !defined(CONFIG_SECURE)
+/* The kernel header alone, so that a bad A/B slot is not read in full */
+static int sdcard_check_kernel_header(char *filename, BYTE *dest)
+{
+	FIL	file;
+	UINT	byte_read;
+	FRESULT	fret;
+	int	ret = -1;
+
+	fret = f_open(&file, filename, FA_OPEN_EXISTING | FA_READ);
+	if (fret != FR_OK) {
+		dbg_info("*** FATFS: f_open, filename: [%s]: error\n", filename);
+		return -1;
+	}
+
+	fret = f_read(&file, (void *)dest, 512, &byte_read);
+	if ((fret == FR_OK) && (byte_read == 512) && (kernel_size(dest) > 0))
+		ret = 0;
+
+	(void)f_close(&file);
+
+	return ret;
+}
+#endif
+
+#ifdef CONFIG_LOAD_OPTEE
+/* The header is read apart, so that the payload lands at its run address */
+static int sdcard_load_optee(char *filename, unsigned char *dest)
+{
+	struct optee_header hdr;
+	FIL	file;
+	UINT	byte_read;
+	FRESULT	fret;
+	int	size;
+	int	ret = -1;
+
+	fret = f_open(&file, filename, FA_OPEN_EXISTING | FA_READ);
+	if (fret != FR_OK) {
+		dbg_info("*** FATFS: f_open, filename: [%s]: error\n", filename);
+		return -1;
+	}
+
+	fret = f_read(&file, &hdr, sizeof(hdr), &byte_read);
+	if ((fret != FR_OK) || (byte_read != sizeof(hdr)))
+		goto read_fail;
+
+	size = optee_header_check(&hdr, file.fsize);
+	if (size < 0)
+		goto read_fail;
+	measure_update(&hdr, sizeof(hdr));
+
+	fret = sdcard_read(&file, dest, size, &byte_read);
+	if ((fret == FR_OK) && (byte_read == (UINT)size))
+		ret = 0;
+
+read_fail:
+	if (ret)
+		dbg_info("*** FATFS: OP-TEE f_read: error\n");
+	(void)f_close(&file);
+
+	return ret;
+}
+#endif
+
+#ifdef CONFIG_OF_OVERLAY
+/*
+ * Load the overlays named after the boards right after the base blob,
+ * a board without an overlay file has none.
+ */
+static void sdcard_load_overlays(void *blob)
+{
+	unsigned char *dest = of_next_blob(blob);
+#ifdef CONFIG_LOAD_HW_INFO
+	unsigned char *area = dest + CONFIG_OF_OVERLAY_AREA_SIZE;
+	char ids[BOARD_OVERLAY_IDS][BOARD_OVERLAY_ID_LEN];
+	char filename[BOARD_OVERLAY_ID_LEN + 5];
+	FIL	file;
+	UINT	byte_read;
+	FRESULT	fret;
+	unsigned int i;
+
+	get_board_overlay_ids(ids);
+	for (i = 0; i < BOARD_OVERLAY_IDS; i++) {
+		strcpy(filename, ids[i]);
+		strcat(filename, ".dtbo");
+
+		fret = f_open(&file, filename, FA_OPEN_EXISTING | FA_READ);
+		if (fret != FR_OK)
+			continue;
+
+		/* the word after the last overlay ends the list */
+		if (OF_ALIGN(file.fsize) + 4 > (unsigned int)(area - dest)) {
+			dbg_info("SD/MMC: dt overlay: %s too big, skipped\n",
+				 filename);
+			(void)f_close(&file);
+			continue;
+		}
+
+		fret = f_read(&file, dest, file.fsize, &byte_read);
+		(void)f_close(&file);
+		if ((fret != FR_OK) || check_dt_blob_valid(dest)
+				|| (of_get_dt_total_size(dest) > byte_read))
+			continue;
+
+		dbg_info("SD/MMC: dt overlay: Read file %s to %x\n",
+			 filename, dest);
+		dest = of_next_blob(dest);
+	}
+#endif
+	*(unsigned int *)dest = 0;
+}
+#endif
+
 #ifdef CONFIG_OVERRIDE_CMDLINE_FROM_EXT_FILE
 static int sdcard_read_cmd(char *cmdline_file, char *cmdline_args)
 {
@@ -98,24 +548,8 @@ int load_sdcard(struct image_info *image)
 	FATFS	fs;
 	FRESULT	fret;
 	int	ret;
-	static bool initialized = false;
 
-	if (!initialized) {
-#ifdef CONFIG_AT91_MCI
-#if defined(CONFIG_AT91_MCI0)
-		at91_mci0_hw_init();
-#elif defined(CONFIG_AT91_MCI1)
-		at91_mci1_hw_init();
-#elif defined(CONFIG_AT91_MCI2)
-		at91_mci2_hw_init();
-#endif
-#endif
-
-#ifdef CONFIG_SDHC
-		at91_sdhc_hw_init();
-#endif
-		initialized = true;
-	}
+	sdcard_hw_init();
 
 	/* mount fs */
 	fret = f_mount(0, &fs);
@@ -124,14 +558,41 @@ int load_sdcard(struct image_info *image)
 		return -1;
 	}
 
+#ifdef CONFIG_LOAD_OPTEE
+	if (image->optee_dest) {
+		dbg_info("SD/MMC: OP-TEE: Read file %s to %x\n",
+			 image->optee_filename, image->optee_dest);
+
+		measure_begin(MEASURE_OPTEE);
+		ret = sdcard_load_optee(image->optee_filename,
+					image->optee_dest);
+		if (ret) {
+			(void)f_mount(0, NULL);
+			return ret;
+		}
+		measure_end();
+	}
+#endif
+
+#if defined(CONFIG_AB_SLOTS) && defined(CONFIG_LINUX_IMAGE) \
+	&& !defined(CONFIG_SECURE)
+	ret = sdcard_check_kernel_header(image->filename, image->dest);
+	if (ret) {
+		(void)f_mount(0, NULL);
+		return ret;
+	}
+#endif
+
 	dbg_info("SD/MMC: Image: Read file %s to %x\n",
 					image->filename, image->dest);
 
+	measure_begin(MEASURE_IMAGE);
 	ret = sdcard_loadimage(image->filename, image->dest);
 	if (ret) {
 		(void)f_mount(0, NULL);
 		return ret;
 	}
+	measure_end();
 
 #ifdef CONFIG_OF_LIBFDT
 	if (image->of_dest) {
@@ -144,11 +605,18 @@ int load_sdcard(struct image_info *image)
 		dbg_info("SD/MMC: dt blob: Read file %s to %x\n",
 				image->of_filename, image->of_dest);
 
+		measure_begin(MEASURE_DTB);
 		ret = sdcard_loadimage(image->of_filename, image->of_dest);
 		if (ret) {
 			(void)f_mount(0, NULL);
 			return ret;
 		}
+		measure_end();
+
+#ifdef CONFIG_OF_OVERLAY
+		if (!check_dt_blob_valid(image->of_dest))
+			sdcard_load_overlays(image->of_dest);
+#endif
 	}
 
 #endif
@@ -176,3 +644,4 @@ int load_sdcard(struct image_info *image)
 
 	return 0;
 }
+#endif /* CONFIG_SDCARD_RAW */
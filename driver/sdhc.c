@@ -249,6 +249,18 @@
 #define	SDMMC_HC1R_CARDDTL	(0x1 << 6)	/* Card Detect Test Level */
 #define	SDMMC_HC1R_CARDDSEL	(0x1 << 7)	/* Card Detect Signal Selection */
 
+/* SDMMC_HC2R */
+#define	SDMMC_HC2R_UHSMS	(0x7 << 0)	/* UHS Mode Select */
+#define	SDMMC_HC2R_VS18EN	(0x1 << 3)	/* 1.8V Signaling Enable */
+#define	SDMMC_HC2R_DRVSEL	(0x3 << 4)	/* Driver Strength Select */
+#define	SDMMC_HC2R_EXTUN	(0x1 << 6)	/* Execute Tuning */
+#define	SDMMC_HC2R_SLCKSEL	(0x1 << 7)	/* Sampling Clock Select */
+#define	SDMMC_HC2R_ASINTEN	(0x1 << 14)	/* Asynchronous Interrupt Enable */
+#define	SDMMC_HC2R_PVALEN	(0x1 << 15)	/* Preset Value Enable */
+
+/* Maximum number of tuning commands, from the SD Host Controller spec */
+#define	SDHC_TUNING_RETRIES	40
+
 /*---------------------------------------------------------------*/
 
 static struct sd_host sdhc_host;
@@ -428,6 +440,135 @@ static int sdhc_set_ddr(struct sd_card *sdcard)
 	return 0;
 }
 
+#if defined(CONFIG_SDHC_UHS) || defined(CONFIG_SDHC_HS200)
+static int sdhc_set_signal_voltage_1v8(struct sd_card *sdcard)
+{
+	int ret = 0;
+
+	if (!sdcard->host->caps_1v8)
+		return -1;
+
+	/* The SD card holds DAT[3:0] low until the switch is done */
+	sdhc_writew(SDMMC_CCR, sdhc_readw(SDMMC_CCR) & ~SDMMC_CCR_SDCLKEN);
+
+	if ((sdcard->card_type == CARD_TYPE_SD) &&
+	    (sdhc_readl(SDMMC_PSR) & SDMMC_PSR_DATLL)) {
+		ret = -1;
+		goto out;
+	}
+
+	sdhc_writew(SDMMC_HC2R, sdhc_readw(SDMMC_HC2R) | SDMMC_HC2R_VS18EN);
+
+	/* The 1.8V regulator output shall be stable within 5ms */
+	udelay(5000);
+	if (!(sdhc_readw(SDMMC_HC2R) & SDMMC_HC2R_VS18EN))
+		ret = -1;
+
+out:
+	sdhc_writew(SDMMC_CCR, sdhc_readw(SDMMC_CCR) | SDMMC_CCR_SDCLKEN);
+	if (ret)
+		return ret;
+
+	/* The SD card releases DAT[3:0] within 1ms of the clock restart */
+	udelay(1000);
+	if ((sdcard->card_type == CARD_TYPE_SD) &&
+	    ((sdhc_readl(SDMMC_PSR) & SDMMC_PSR_DATLL) != SDMMC_PSR_DATLL))
+		return -1;
+
+	return 0;
+}
+
+static int sdhc_set_timing(struct sd_card *sdcard, unsigned int timing)
+{
+	struct sd_host *host = sdcard->host;
+	unsigned int uhsms = timing;
+
+	/* HS200 uses the SDR104 setting of the UHS Mode Select field */
+	if (timing == MMC_TIMING_HS200)
+		uhsms = SD_TIMING_SDR104;
+	else if (timing > SD_TIMING_DDR50)
+		return -1;
+
+	if (((uhsms == SD_TIMING_SDR104) && !host->caps_sdr104) ||
+	    ((uhsms == SD_TIMING_SDR50) && !host->caps_sdr50))
+		return -1;
+
+	sdhc_writew(SDMMC_CCR, sdhc_readw(SDMMC_CCR) & ~SDMMC_CCR_SDCLKEN);
+	sdhc_writew(SDMMC_HC2R,
+		    (sdhc_readw(SDMMC_HC2R) & ~SDMMC_HC2R_UHSMS) | uhsms);
+	sdhc_writew(SDMMC_CCR, sdhc_readw(SDMMC_CCR) | SDMMC_CCR_SDCLKEN);
+
+	sdcard->timing = timing;
+
+	return 0;
+}
+
+/*
+ * Refer to SD Host Controller Simplified Specification Version 3.00
+ * Figure 2-29: Sampling Clock Tuning Procedure
+ * The tuning block is only used by the tuning circuit, it is not read.
+ */
+static int sdhc_execute_tuning(struct sd_card *sdcard, unsigned int cmd)
+{
+	unsigned short blocksize = 64;
+	unsigned short normal_status;
+	unsigned short hc2r = 0;
+	unsigned int timeout;
+	unsigned int i;
+
+	if ((cmd == MMC_CMD_SEND_TUNING_BLOCK) &&
+	    (sdcard->configured_bus_w == 8))
+		blocksize = 128;
+
+	sdhc_writew(SDMMC_HC2R, sdhc_readw(SDMMC_HC2R) | SDMMC_HC2R_EXTUN);
+
+	for (i = 0; i < SDHC_TUNING_RETRIES; i++) {
+		timeout = 100000;
+		while ((--timeout) && (sdhc_readl(SDMMC_PSR)
+				& (SDMMC_PSR_CMDINHC | SDMMC_PSR_CMDINHD)))
+			;
+
+		sdhc_writew(SDMMC_BSR, blocksize);
+		sdhc_writew(SDMMC_TMR, SDMMC_TMR_DTDSEL_READ);
+		sdhc_writel(SDMMC_ARG1R, 0);
+		sdhc_writew(SDMMC_CR, SDMMC_CR_CMDIDX_(cmd)
+					| SDMMC_CR_RESPTYP_RL48
+					| SDMMC_CR_CMDCCEN
+					| SDMMC_CR_CMDICEN
+					| SDMMC_CR_DPSEL);
+
+		timeout = 1000;
+		do {
+			normal_status = sdhc_readw(SDMMC_NISTR);
+			if (normal_status & SDMMC_NISTR_BRDRDY)
+				break;
+			udelay(10);
+		} while (--timeout);
+
+		sdhc_writew(SDMMC_NISTR, normal_status);
+
+		hc2r = sdhc_readw(SDMMC_HC2R);
+		if (!(hc2r & SDMMC_HC2R_EXTUN))
+			break;
+	}
+
+	if ((hc2r & SDMMC_HC2R_EXTUN) || !(hc2r & SDMMC_HC2R_SLCKSEL)) {
+		/* Back to the fixed sampling clock */
+		sdhc_writew(SDMMC_HC2R, sdhc_readw(SDMMC_HC2R)
+				& ~(SDMMC_HC2R_EXTUN | SDMMC_HC2R_SLCKSEL));
+		sdhc_software_reset_cmd();
+		sdhc_software_reset_dat();
+		sdhc_writew(SDMMC_EISTR, sdhc_readw(SDMMC_EISTR));
+		dbg_info("SDHC: Tuning failed after %d commands\n", i);
+		return -1;
+	}
+
+	dbg_loud("SDHC: Tuning done after %d commands\n", i + 1);
+
+	return 0;
+}
+#endif
+
 static int sdhc_host_capability(struct sd_card *sdcard)
 {
 	struct sd_host *host = sdcard->host;
@@ -444,6 +585,9 @@ static int sdhc_host_capability(struct sd_card *sdcard)
 
 	host->caps_high_speed = 0;
 	host->caps_ddr = 0;
+	host->caps_sdr50 = 0;
+	host->caps_sdr104 = 0;
+	host->caps_tune_sdr50 = 0;
 	host->caps_adma2 = 0;
 	if (caps & SDMMC_CA0R_HSSUP)
 		host->caps_high_speed = 1;
@@ -462,6 +606,7 @@ static int sdhc_host_capability(struct sd_card *sdcard)
 		host->caps_voltages |= SD_OCR_VDD_29_30 | SD_OCR_VDD_30_31;
 	if (caps & SDMMC_CA0R_V18VSUP)
 		host->caps_voltages |= SD_OCR_VDD_165_195;
+	host->caps_1v8 = !!(caps & SDMMC_CA0R_V18VSUP);
 
 	caps = sdhc_readl(SDMMC_CA1R);
 
@@ -469,6 +614,12 @@ static int sdhc_host_capability(struct sd_card *sdcard)
 						& SDMMC_CA1R_CLKMULT_MSK;
 	if (caps & SDMMC_CA1R_DDR50SUP)
 		host->caps_ddr = 1;
+	if (caps & SDMMC_CA1R_SDR50SUP)
+		host->caps_sdr50 = 1;
+	if (caps & SDMMC_CA1R_SDR104SUP)
+		host->caps_sdr104 = 1;
+	if (caps & SDMMC_CA1R_TSDR50)
+		host->caps_tune_sdr50 = 1;
 
 	return 0;
 }
@@ -649,14 +800,23 @@ sdhc_read_data_reset:
 	return -1;
 }
 
+/*
+ * A descriptor moves at most the largest multiple of 512 bytes its 16-bit
+ * length holds, the table covers the longest read.
+ */
+#define SDHC_ADMA_MAX_LEN	0xfe00
+#define SDHC_ADMA_DESCS		((SD_READ_MAX_BLOCKS * 512 + SDHC_ADMA_MAX_LEN - 1) \
+					/ SDHC_ADMA_MAX_LEN)
+
+static struct adma_desc dma_desc[SDHC_ADMA_DESCS];
+
 static int sdhc_send_command(struct sd_command *sd_cmd, struct sd_data *data)
 {
 	unsigned int normal_status, error_status, normal_status_mask;
 	unsigned int cmd_reg, mode;
-	unsigned int i;
+	unsigned int i, len, addr, chunk;
 	int ret;
 	unsigned int timeout;
-	struct adma_desc dma_desc[16] = {0};
 
 	timeout = 100000;
 	while ((--timeout) &&
@@ -693,6 +853,12 @@ static int sdhc_send_command(struct sd_command *sd_cmd, struct sd_data *data)
 	}
 
 	if (data) {
+		if (data->blocks * data->blocksize >
+		    SDHC_ADMA_DESCS * SDHC_ADMA_MAX_LEN) {
+			dbg_printf("too many blocks requested at once, error\n");
+			return -1;
+		}
+
 		if (sdhc_host.caps_adma2 && (sd_cmd->cmd == SD_CMD_READ_SINGLE_BLOCK ||
 		    sd_cmd->cmd == SD_CMD_READ_MULTIPLE_BLOCK)) {
 			/* for CMD17 and CMD18 we use ADMA2 */
@@ -721,18 +887,23 @@ static int sdhc_send_command(struct sd_command *sd_cmd, struct sd_data *data)
 		if (sdhc_host.caps_adma2 && (sd_cmd->cmd == SD_CMD_READ_SINGLE_BLOCK ||
 		    sd_cmd->cmd == SD_CMD_READ_MULTIPLE_BLOCK)) {
 			/* prepare descriptor table */
-			if (data->blocks > 16 )
-				dbg_printf("too many blocks requested at once, error\n");
+			len = data->blocks * data->blocksize;
+			addr = (unsigned int)data->buff;
+			for (i = 0; len; i++) {
+				chunk = (len > SDHC_ADMA_MAX_LEN) ?
+						SDHC_ADMA_MAX_LEN : len;
 
-			for (i = 0; i < data->blocks; i++) {
 				/* last descriptor must have the end bit */
-				if (i == data->blocks - 1)
+				if (chunk == len)
 					dma_desc[i].cmd = 0x23;
 				else
 					dma_desc[i].cmd = 0x21;
 
-				dma_desc[i].len = data->blocksize;
-				dma_desc[i].addr = (unsigned int)(data->buff + data->blocksize * i);
+				dma_desc[i].len = chunk;
+				dma_desc[i].addr = addr;
+
+				addr += chunk;
+				len -= chunk;
 			}
 		/* address of the first descriptor goes here */
 		sdhc_writel(SDMMC_ASAR0, (unsigned int) &dma_desc[0]);
@@ -774,7 +945,7 @@ static int sdhc_send_command(struct sd_command *sd_cmd, struct sd_data *data)
 		} else if (data && sdhc_host.caps_adma2) {
 			/* otherwise, ADMA will carry the data for us */
 			/* Let's wait for ADMA to finish transferring */
-			timeout = 1000000;
+			timeout = 1000000 + data->blocks * 100;
 			do {
 				normal_status = sdhc_readw(SDMMC_NISTR);
 				udelay(1);
@@ -809,6 +980,11 @@ static struct host_ops sdhc_ops = {
 	.set_clock = sdhc_set_clock,
 	.set_bus_width = sdhc_set_bus_width,
 	.set_ddr = sdhc_set_ddr,
+#if defined(CONFIG_SDHC_UHS) || defined(CONFIG_SDHC_HS200)
+	.set_signal_voltage_1v8 = sdhc_set_signal_voltage_1v8,
+	.set_timing = sdhc_set_timing,
+	.execute_tuning = sdhc_execute_tuning,
+#endif
 };
 
 int sdcard_register_sdhc(struct sd_card *sdcard)
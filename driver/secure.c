@@ -5,6 +5,8 @@
 #include "common.h"
 #include "secure.h"
 #include "aes.h"
+#include "hash.h"
+#include "p256.h"
 #include "debug.h"
 #include "string.h"
 #include "hardware.h"
@@ -26,6 +28,7 @@ static unsigned int cipher_key[8] = {
 #endif
 };
 
+#ifdef CONFIG_SECURE_CMAC
 static unsigned int cmac_key[8] = {
 	CONFIG_AES_CMAC_KEY_WORD0,
 	CONFIG_AES_CMAC_KEY_WORD1,
@@ -40,6 +43,28 @@ static unsigned int cmac_key[8] = {
 	CONFIG_AES_CMAC_KEY_WORD7,
 #endif
 };
+#endif
+
+#ifdef CONFIG_SECURE_ECDSA
+static const unsigned int ecdsa_key[16] = {
+	CONFIG_ECDSA_KEY_X_WORD0,
+	CONFIG_ECDSA_KEY_X_WORD1,
+	CONFIG_ECDSA_KEY_X_WORD2,
+	CONFIG_ECDSA_KEY_X_WORD3,
+	CONFIG_ECDSA_KEY_X_WORD4,
+	CONFIG_ECDSA_KEY_X_WORD5,
+	CONFIG_ECDSA_KEY_X_WORD6,
+	CONFIG_ECDSA_KEY_X_WORD7,
+	CONFIG_ECDSA_KEY_Y_WORD0,
+	CONFIG_ECDSA_KEY_Y_WORD1,
+	CONFIG_ECDSA_KEY_Y_WORD2,
+	CONFIG_ECDSA_KEY_Y_WORD3,
+	CONFIG_ECDSA_KEY_Y_WORD4,
+	CONFIG_ECDSA_KEY_Y_WORD5,
+	CONFIG_ECDSA_KEY_Y_WORD6,
+	CONFIG_ECDSA_KEY_Y_WORD7,
+};
+#endif
 
 static unsigned int iv[AT91_AES_IV_SIZE_WORD] = {
 	CONFIG_AES_IV_WORD0,
@@ -69,12 +94,52 @@ void ocms_enable(void)
 
 #endif /* #if defined(CONFIG_OCMS_STATIC) */
 
-static int secure_decrypt(void *data, unsigned int data_length, int is_signed)
+#ifdef CONFIG_SECURE_ECDSA
+/* The signature follows the encrypted file, which is signed as it is */
+static int secure_authenticate(void *data, unsigned int data_length,
+			       at91_aes_key_size_t key_size)
+{
+	unsigned char key[P256_KEY_SIZE];
+	unsigned char digest[HASH_SIZE];
+	unsigned int fixed_length = at91_aes_roundup(data_length);
+	unsigned int i;
+
+	for (i = 0; i < P256_KEY_SIZE; i++)
+		key[i] = ecdsa_key[i / 4] >> (8 * (3 - (i % 4)));
+
+	hash_init();
+	hash_update(data, fixed_length);
+	hash_final(digest);
+
+	return p256_ecdsa_verify(key, digest,
+				 (unsigned char *)data + fixed_length);
+}
+#else
+static int secure_authenticate(void *data, unsigned int data_length,
+			       at91_aes_key_size_t key_size)
 {
-	at91_aes_key_size_t key_size;
 	unsigned int computed_cmac[AT91_AES_BLOCK_SIZE_WORD];
 	unsigned int fixed_length;
 	const unsigned int *cmac;
+
+	/* Compute the CMAC */
+	if (at91_aes_cmac(data_length, data, computed_cmac,
+			  key_size, cmac_key))
+		return -1;
+
+	/* Check the CMAC */
+	fixed_length = at91_aes_roundup(data_length);
+	cmac = (const unsigned int *)((char *)data + fixed_length);
+	if (!consttime_memequal(cmac, computed_cmac, AT91_AES_BLOCK_SIZE_BYTE))
+		return -1;
+
+	return 0;
+}
+#endif
+
+static int secure_decrypt(void *data, unsigned int data_length, int is_signed)
+{
+	at91_aes_key_size_t key_size;
 	int rc = -1;
 
 #if defined(CONFIG_AES_KEY_SIZE_128)
@@ -91,18 +156,8 @@ static int secure_decrypt(void *data, unsigned int data_length, int is_signed)
 	at91_aes_init();
 
 	/* Check signature if required */
-	if (is_signed) {
-		/* Compute the CMAC */
-		if (at91_aes_cmac(data_length, data, computed_cmac,
-				  key_size, cmac_key))
-			goto exit;
-
-		/* Check the CMAC */
-		fixed_length = at91_aes_roundup(data_length);
-		cmac = (const unsigned int *)((char *)data + fixed_length);
-		if (!consttime_memequal(cmac, computed_cmac, AT91_AES_BLOCK_SIZE_BYTE))
-			goto exit;
-	}
+	if (is_signed && secure_authenticate(data, data_length, key_size))
+		goto exit;
 
 	/* Decrypt the whole file */
 	if (at91_aes_cbc(data_length, data, data, 0,
@@ -120,7 +175,9 @@ exit:
 static void __attribute__((optimize("O0"))) wipe_keys()
 {
 	/* Reset keys */
+#ifdef CONFIG_SECURE_CMAC
 	memset(cmac_key, 0, sizeof(cmac_key));
+#endif
 	memset(cipher_key, 0, sizeof(cipher_key));
 	memset(iv, 0, sizeof(iv));
 }
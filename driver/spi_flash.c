@@ -697,6 +697,10 @@ int spi_flash_loadimage(struct image_info *image)
 		return -1;
 
 	image->of_length = length;
+#ifdef CONFIG_OF_OVERLAY
+	/* the overlays follow the blob, read them in the same pass */
+	image->of_length = OF_ALIGN(length) + CONFIG_OF_OVERLAY_AREA_SIZE;
+#endif
 
 	dbg_info("SF: dt blob: Copy %x bytes from %x to %x\n",
 		image->of_length, image->of_offset, image->of_dest);
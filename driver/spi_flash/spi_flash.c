@@ -10,6 +10,7 @@
 #include "timer.h"
 #include "div.h"
 #include "fdt.h"
+#include "measure.h"
 
 int spi_flash_read_reg(struct spi_flash *flash, u8 inst, u8 *buf, size_t len)
 {
@@ -220,6 +221,29 @@ static int update_image_length(struct spi_flash *flash,
 int qspi_xip(struct spi_flash *flash, void **mem);
 #endif
 
+#ifdef CONFIG_MEASURED_BOOT
+/* By chunks, each one hashed while it is still in the cache */
+static int spi_flash_read_image(struct spi_flash *flash, size_t from,
+				size_t len, u8 *buf)
+{
+	size_t chunk;
+	int ret;
+
+	for (; len; len -= chunk, from += chunk, buf += chunk) {
+		chunk = min(len, MEASURE_CHUNK_SIZE);
+
+		ret = spi_flash_read(flash, from, chunk, buf);
+		if (ret)
+			return ret;
+		measure_update(buf, chunk);
+	}
+
+	return 0;
+}
+#else
+#define spi_flash_read_image	spi_flash_read
+#endif
+
 #ifdef CONFIG_DATAFLASH_RECOVERY
 int spi_flash_recovery(struct spi_flash *flash)
 {
@@ -311,18 +335,24 @@ int spi_flash_loadimage(struct spi_flash *flash, struct image_info *image)
 	}
 
 	image->of_length = length;
+#ifdef CONFIG_OF_OVERLAY
+	/* the overlays follow the blob, read them in the same pass */
+	image->of_length = OF_ALIGN(length) + CONFIG_OF_OVERLAY_AREA_SIZE;
+#endif
 
 	dbg_info("SF: dt blob: Copy %x bytes from %x to %x\n",
 		 image->of_length, image->of_offset, image->of_dest);
-	ret = spi_flash_read(flash,
-			     image->of_offset,
-			     image->of_length,
-			     image->of_dest);
+	measure_begin(MEASURE_DTB);
+	ret = spi_flash_read_image(flash,
+				   image->of_offset,
+				   image->of_length,
+				   image->of_dest);
 	if (ret) {
 		dbg_info("** SF: DT: Serial flash read error**\n");
 		ret = -1;
 		goto err_exit;
 	}
+	measure_end();
 #endif /* CONFIG_OF_LIBFDT */
 
 #ifdef CONFIG_QSPI_XIP
@@ -352,15 +382,17 @@ int spi_flash_loadimage(struct spi_flash *flash, struct image_info *image)
 
 	dbg_info("SF: Copy %x bytes from %x to %x\n",
 		 image->length, image->offset, image->dest);
-	ret = spi_flash_read(flash,
-			     image->offset,
-			     image->length,
-			     image->dest);
+	measure_begin(MEASURE_IMAGE);
+	ret = spi_flash_read_image(flash,
+				   image->offset,
+				   image->length,
+				   image->dest);
 	if (ret) {
 		dbg_info("** SF: Serial flash read error**\n");
 		ret = -1;
 		goto err_exit;
 	}
+	measure_end();
 #endif /* !CONFIG_QSPI_XIP */
 
 err_exit:
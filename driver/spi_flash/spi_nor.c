@@ -7,10 +7,16 @@
 #include "board.h"
 #include "timer.h"
 
+#ifdef CONFIG_SPI_NOR_PROBE_CACHE
+#include "hardware.h"
+#include "gpbr.h"
+#endif
+
 static const struct spi_nor_info *spi_nor_read_id(struct spi_flash *flash)
 {
 	const struct spi_nor_info *info;
 	char id_str[8], *p;
+	unsigned int lo, hi, mid;
 	int i, ret;
 
 	ret = spi_flash_read_reg(flash, SFLASH_INST_READ_ID,
@@ -29,7 +35,21 @@ static const struct spi_nor_info *spi_nor_read_id(struct spi_flash *flash)
 	*p = '\0';
 	dbg_info("SF: Got Manufacturer and Device ID: %s\n", id_str);
 
-	for (info = spi_nor_ids; info->name; info++) {
+	/* Binary search of the first entry with the JEDEC ID */
+	lo = 0;
+	hi = spi_nor_ids_count;
+	while (lo < hi) {
+		mid = (lo + hi) >> 1;
+		if (memcmp(spi_nor_ids[mid].id, flash->id, 3) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	/* The entries sharing it differ by their extended ID */
+	for (info = &spi_nor_ids[lo]; info->name; info++) {
+		if (memcmp(info->id, flash->id, 3))
+			break;
 		if (!memcmp(info->id, flash->id, info->id_len))
 			return info;
 	}
@@ -181,7 +201,8 @@ static int macronix_octa_enable(struct spi_flash *flash)
 
 static int spi_nor_init_params(struct spi_flash *flash,
 			       const struct spi_nor_info *info,
-			       struct spi_flash_parameters *params)
+			       struct spi_flash_parameters *params,
+			       bool sfdp)
 {
 	struct spi_flash_erase_map *map = &flash->erase_map;
 	u32 erase_mask = 0;
@@ -271,7 +292,7 @@ set_erase_map:
 #endif
 
 	/* Override the parameters with data read from SFDP tables. */
-	if (!info || !(info->flags & SNOR_SKIP_SFDP))
+	if (sfdp)
 		spi_flash_parse_sfdp(flash, params);
 	return 0;
 }
@@ -353,11 +374,156 @@ static int sst26_unlock_block_protection(struct spi_flash *flash)
 	return rc ? rc : spi_flash_wait_till_ready(flash);
 }
 
+#ifdef CONFIG_SPI_NOR_PROBE_CACHE
+/*
+ * The read settings negotiated from the SFDP tables are kept in three
+ * backup registers, so that the next boots with the same memory skip the
+ * SFDP parsing:
+ * - magic with the layout version, and JEDEC ID,
+ * - read opcode, wait states, mode cycles and address width,
+ * - read protocol, quad enable method, log2 of the size, and a check byte.
+ * The check byte hashes the three registers and the capabilities of the
+ * controller: the cache is dropped when a bootstrap built for another
+ * controller setup, or another layout, finds it.
+ */
+#define SNOR_CACHE_REG(i)	(AT91C_BASE_GPBR + \
+				 4 * (CONFIG_SPI_NOR_PROBE_CACHE_GPBR + (i)))
+#define SNOR_CACHE_MAGIC	0x50UL
+#define SNOR_CACHE_LAYOUT	0x1UL	/* bumped when the layout changes */
+
+#define SNOR_CACHE_DTR		(0x1UL << 12)
+#define SNOR_CACHE_QE(misc)	(((misc) >> 13) & 0x7)
+#define SNOR_CACHE_SIZE(misc)	(((misc) >> 16) & 0x1f)
+#define SNOR_CACHE_CHECK(misc)	(((misc) >> 24) & 0xff)
+
+static int (* const spi_nor_quad_enables[])(struct spi_flash *) = {
+	NULL,
+	spansion_quad_enable,
+	spansion_new_quad_enable,
+	macronix_quad_enable,
+	sr2_bit7_quad_enable,
+};
+
+static u32 spi_nor_cache_id(const struct spi_flash *flash)
+{
+	return ((SNOR_CACHE_MAGIC | SNOR_CACHE_LAYOUT) << 24)
+		| (flash->id[0] << 16) | (flash->id[1] << 8) | flash->id[2];
+}
+
+/* FNV-1a of the cached fields and of the controller capabilities */
+static u32 spi_nor_cache_check(u32 id, u32 read, u32 misc,
+			       const struct spi_flash_hwcaps *hwcaps)
+{
+	u32 words[4] = { id, read, misc & 0x00ffffffUL, hwcaps->mask };
+	u32 hash = 0x811c9dc5UL;
+	unsigned int i;
+
+	for (i = 0; i < 16; i++) {
+		hash ^= (words[i >> 2] >> (8 * (i & 3))) & 0xff;
+		hash *= 0x01000193UL;
+	}
+
+	return hash >> 24;
+}
+
+static u32 spi_nor_cache_pack_proto(enum spi_flash_protocol proto)
+{
+	return (spi_flash_protocol_get_inst_nbits(proto) << 8)
+		| (spi_flash_protocol_get_addr_nbits(proto) << 4)
+		| spi_flash_protocol_get_data_nbits(proto)
+		| (spi_flash_protocol_is_dtr(proto) ? SNOR_CACHE_DTR : 0);
+}
+
+static enum spi_flash_protocol spi_nor_cache_unpack_proto(u32 val)
+{
+	return (enum spi_flash_protocol)
+		(SFLASH_PROTO((val >> 8) & 0xf, (val >> 4) & 0xf, val & 0xf)
+		 | ((val & SNOR_CACHE_DTR) ? SFLASH_PROTO_DTR_EN : 0));
+}
+
+/* Return the cached flash size, 0 if the cache does not match the flash */
+static u32 spi_nor_cache_size(struct spi_flash *flash,
+			      const struct spi_flash_hwcaps *hwcaps)
+{
+	u32 id = readl(SNOR_CACHE_REG(0));
+	u32 read = readl(SNOR_CACHE_REG(1));
+	u32 misc = readl(SNOR_CACHE_REG(2));
+
+	if (id != spi_nor_cache_id(flash))
+		return 0;
+
+	if (SNOR_CACHE_CHECK(misc)
+	    != spi_nor_cache_check(id, read, misc, hwcaps))
+		return 0;
+
+	if (SNOR_CACHE_QE(misc) >= ARRAY_SIZE(spi_nor_quad_enables))
+		return 0;
+
+	return 0x1UL << SNOR_CACHE_SIZE(misc);
+}
+
+static int spi_nor_cache_restore(struct spi_flash *flash)
+{
+	u32 read = readl(SNOR_CACHE_REG(1));
+	u32 misc = readl(SNOR_CACHE_REG(2));
+	int (*quad_enable)(struct spi_flash *);
+
+	flash->read_inst = read & 0xff;
+	flash->num_wait_states = (read >> 8) & 0xff;
+	flash->num_mode_cycles = (read >> 16) & 0xff;
+	flash->addr_len = (read >> 24) & 0xff;
+	flash->read_proto = spi_nor_cache_unpack_proto(misc & 0xffff);
+
+	quad_enable = spi_nor_quad_enables[SNOR_CACHE_QE(misc)];
+	if ((spi_flash_protocol_get_data_nbits(flash->read_proto) == 4)
+	    && quad_enable)
+		return quad_enable(flash);
+
+	return 0;
+}
+
+static void spi_nor_cache_store(struct spi_flash *flash,
+				const struct spi_flash_parameters *params,
+				const struct spi_flash_hwcaps *hwcaps)
+{
+	u32 id, read, misc;
+	unsigned int qe;
+
+	/* Only the power of 2 sizes and the known methods are cached */
+	if (!flash->size || (flash->size & (flash->size - 1)))
+		return;
+
+	if (spi_flash_protocol_get_data_nbits(flash->read_proto) > 4)
+		return;
+
+	for (qe = 0; qe < ARRAY_SIZE(spi_nor_quad_enables); qe++)
+		if (spi_nor_quad_enables[qe] == params->quad_enable)
+			break;
+	if (qe == ARRAY_SIZE(spi_nor_quad_enables))
+		return;
+
+	id = spi_nor_cache_id(flash);
+	read = flash->read_inst | (flash->num_wait_states << 8)
+		| (flash->num_mode_cycles << 16) | (flash->addr_len << 24);
+	misc = spi_nor_cache_pack_proto(flash->read_proto)
+		| (qe << 13) | ((fls(flash->size) - 1) << 16);
+	misc |= spi_nor_cache_check(id, read, misc, hwcaps) << 24;
+
+	writel(read, SNOR_CACHE_REG(1));
+	writel(misc, SNOR_CACHE_REG(2));
+	writel(id, SNOR_CACHE_REG(0));
+}
+#endif /* #ifdef CONFIG_SPI_NOR_PROBE_CACHE */
+
 int spi_nor_probe(struct spi_flash *flash,
 		  const struct spi_flash_hwcaps *hwcaps)
 {
 	struct spi_flash_parameters params;
 	const struct spi_nor_info *info;
+	bool sfdp;
+#ifdef CONFIG_SPI_NOR_PROBE_CACHE
+	u32 cached_size;
+#endif
 	int ret;
 
 	/* Check minimum requirement. */
@@ -411,10 +577,20 @@ int spi_nor_probe(struct spi_flash *flash,
 
 	/* Parse the Serial Flash Discoverable Parameter tables. */
 init_params:
-	ret = spi_nor_init_params(flash, info, &params);
+	sfdp = !info || !(info->flags & SNOR_SKIP_SFDP);
+#ifdef CONFIG_SPI_NOR_PROBE_CACHE
+	cached_size = sfdp ? spi_nor_cache_size(flash, hwcaps) : 0;
+	if (cached_size)
+		sfdp = false;
+#endif
+	ret = spi_nor_init_params(flash, info, &params, sfdp);
 	if (ret < 0)
 		return ret;
 
+#ifdef CONFIG_SPI_NOR_PROBE_CACHE
+	if (cached_size)
+		params.size = cached_size;
+#endif
 	flash->size = params.size;
 	flash->page_size = params.page_size;
 	
@@ -441,6 +617,17 @@ init_params:
 		}
 	}
 
+#ifdef CONFIG_SPI_NOR_PROBE_CACHE
+	/* The cached read settings replace the legacy ones */
+	if (cached_size) {
+		dbg_info("SF: Using the cached SFDP read settings\n");
+		return spi_nor_cache_restore(flash);
+	}
+
+	if (sfdp)
+		spi_nor_cache_store(flash, &params, hwcaps);
+#endif
+
 	return 0;
 }
 
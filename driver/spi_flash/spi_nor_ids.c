@@ -104,24 +104,21 @@ struct spi_flash_parameters gd25f128f_params = {
 	},
 };
 
+/* Sorted by JEDEC ID (manufacturer first), spi_nor_read_id() relies on it */
 const struct spi_nor_info spi_nor_ids[] = {
-	/* Macronix */
-	{ MX25("mx25l25645g", 0xc22019,  512), },
-	{ MX66("mx66lm1g45g", 0xc2853b, 2048), &mx66lm1g45g_params},
-
 	/* Micron */
-	{ N25Q("n25q032ax1", 0x20bb16,   64), },
 	{ N25Q("n25q032ax3", 0x20ba16,   64), },
-	{ N25Q("n25q064ax1", 0x20bb17,  128), },
 	{ N25Q("n25q064ax3", 0x20ba17,  128), },
-	{ N25Q("n25q128ax1", 0x20bb18,  256), },
 	{ N25Q("n25q128ax3", 0x20ba18,  256), },
-	{ N25Q("n25q256ax1", 0x20bb19,  512), },
 	{ N25Q("n25q256ax3", 0x20ba19,  512), },
-	{ N25Q("n25q512ax1", 0x20bb20, 1024), },
 	{ N25Q("n25q512ax3", 0x20ba20, 1024), },
-	{ N25Q("n25q00ax1",  0x20bb21, 2048), },
 	{ N25Q("n25q00ax3",  0x20ba21, 2048), },
+	{ N25Q("n25q032ax1", 0x20bb16,   64), },
+	{ N25Q("n25q064ax1", 0x20bb17,  128), },
+	{ N25Q("n25q128ax1", 0x20bb18,  256), },
+	{ N25Q("n25q256ax1", 0x20bb19,  512), },
+	{ N25Q("n25q512ax1", 0x20bb20, 1024), },
+	{ N25Q("n25q00ax1",  0x20bb21, 2048), },
 
 	/* SST */
 	{ SST26("sst26vf016b", 0xbf2641,  512), },
@@ -130,9 +127,17 @@ const struct spi_nor_info spi_nor_ids[] = {
 	{ SST26("sst26wf040b", 0xbf2654,  128), },
 	{ SST26("sst26wf080b", 0xbf2658,  256), },
 
-	{ W25Q("w25q256", 0xef4019, 512), },
+	/* Macronix */
+	{ MX25("mx25l25645g", 0xc22019,  512), },
+	{ MX66("mx66lm1g45g", 0xc2853b, 2048), &mx66lm1g45g_params},
 
+	/* GigaDevice */
 	{ GD25_SKIP_SFDP("gd25f128f", 0xc84318, 256), &gd25f128f_params},
 
+	/* Winbond */
+	{ W25Q("w25q256", 0xef4019, 512), },
+
 	{}	/* Sentinel */
 };
+
+const unsigned int spi_nor_ids_count = ARRAY_SIZE(spi_nor_ids) - 1;
@@ -2,6 +2,7 @@
 //
 // SPDX-License-Identifier: MIT
 
+#include "common.h"
 #include "svc_mgr.h"
 #include "arch/at91_pmc/pmc.h"
 #include "pmc.h"
@@ -10,111 +11,276 @@
 #include "debug.h"
 #include "rstc.h"
 #include "watchdog.h"
+#include "barriers.h"
 
-/*
- * svc_mgr_main - C entry point of the secure world when a SMC is processed
- * in Normal World
- */
-int svc_mgr_main(struct smc_args_t const *args)
+typedef int (*smc_handler_t)(struct smc_args_t const *args);
+
+static int smc_pck_setup(struct smc_args_t const *args)
 {
-	int ret = 0;
 	unsigned int pck_mask;
+
+	switch (args->r1) {
+	case PMC_PCKR:
+		pck_mask = AT91C_PMC_PCK0;
+		break;
+	case PMC_PCKR1:
+		pck_mask = AT91C_PMC_PCK1;
+		break;
+	case PMC_PCKR2:
+		pck_mask = AT91C_PMC_PCK2;
+		break;
+	default:
+		return -1;
+	}
+
+	if (is_pck_clk_secure(pck_mask))
+		return -1;
+
+	pmc_pck_setup(args->r1, args->r2);
+
+	return 0;
+}
+
+static int smc_pmc_read(struct smc_args_t const *args)
+{
+	if (args->r1 == PMC_PLLAR
+		|| args->r1 == PMC_MCKR
+		|| args->r1 == PMC_PCKR
+		|| args->r1 == PMC_PCKR1
+		|| args->r1 == PMC_PCKR2)
+		return pmc_read_reg(args->r1);
+
+	return -1;
+}
+
+static int smc_periph_clk(struct smc_args_t const *args)
+{
 	unsigned int silent = 1;
 
-	dbg_loud("--> svc_mgr_main\n");
+	if (is_peripheral_secure(args->r1))
+		return -1;
 
-	switch (args->r0) {
-	case 0x24:
-		if (args->r1 == PMC_PLLAR
-			|| args->r1 == PMC_MCKR
-			|| args->r1 == PMC_PCKR
-			|| args->r1 == PMC_PCKR1
-			|| args->r1 == PMC_PCKR2)
-			ret = pmc_read_reg(args->r1);
-		else
-			ret = -1;
-		break;
+	if (is_switching_clock_forbiden(args->r1, args->r2, &silent))
+		return silent ? 0 : -1;
 
-	case 0x25:
-		if (is_peripheral_secure(args->r1))
-			ret = -1;
-		else if (is_switching_clock_forbiden(args->r1, args->r2, &silent))
-			if (silent)
-				ret = 0;
-			else
-				ret = -1;
-		else
-			ret = pmc_periph_clk(args->r1, args->r2);
-		break;
+	return pmc_periph_clk(args->r1, args->r2);
+}
 
-	case 0x26:
-		if (is_sys_clk_secure(args->r1) && is_pck_clk_secure(args->r1))
-			ret = -1;
-		else
-			ret = pmc_sys_clk(args->r1, args->r2);
-		break;
+static int smc_sys_clk(struct smc_args_t const *args)
+{
+	if (is_sys_clk_secure(args->r1) && is_pck_clk_secure(args->r1))
+		return -1;
 
-	case 0x27:
-		if (is_usb_hs_secure())
-			ret = -1;
-		else
-			ret = pmc_uckr_clk(args->r1);
-		break;
+	return pmc_sys_clk(args->r1, args->r2);
+}
 
-	case 0x28:
-		if (is_usb_host_secure())
-			ret = -1;
-		else
-			ret = pmc_usb_setup();
-		break;
-	case 0x29:
-		cpu_reset();
-
-	case 0x23:
-		switch (args->r1) {
-		case PMC_PCKR:
-			pck_mask = AT91C_PMC_PCK0;
-			break;
-		case PMC_PCKR1:
-			pck_mask = AT91C_PMC_PCK1;
-			break;
-		case PMC_PCKR2:
-			pck_mask = AT91C_PMC_PCK2;
-			break;
-		default:
-			return -1;
-		}
+static int smc_uckr_clk(struct smc_args_t const *args)
+{
+	if (is_usb_hs_secure())
+		return -1;
+
+	return pmc_uckr_clk(args->r1);
+}
+
+static int smc_usb_setup(struct smc_args_t const *args)
+{
+	if (is_usb_host_secure())
+		return -1;
+
+	return pmc_usb_setup();
+}
+
+static int smc_cpu_reset(struct smc_args_t const *args)
+{
+	cpu_reset();
+
+	return 0;
+}
+
+static int smc_l2cache_enable(struct smc_args_t const *args)
+{
+	l2cache_enable();
+
+	return 0;
+}
+
+static int smc_smd_setup(struct smc_args_t const *args)
+{
+	pmc_smd_setup(args->r1);
+
+	return 0;
+}
+
+static int smc_wdt_set_counter(struct smc_args_t const *args)
+{
+	return at91_wdt_set_counter(args->r1);
+}
+
+static int smc_wdt_reload_counter(struct smc_args_t const *args)
+{
+	return at91_wdt_reload_counter();
+}
+
+#ifdef CONFIG_SVC_MGR_STATS
+static int smc_stats_query(struct smc_args_t const *args);
+#endif
+
+/* Indexed by SMC ID, so that dispatching does not depend on the ID */
+static const smc_handler_t smc_handlers[SMC_ID_COUNT] = {
+	[0x23] = smc_pck_setup,
+	[0x24] = smc_pmc_read,
+	[0x25] = smc_periph_clk,
+	[0x26] = smc_sys_clk,
+	[0x27] = smc_uckr_clk,
+	[0x28] = smc_usb_setup,
+	[0x29] = smc_cpu_reset,
+	[0x42] = smc_l2cache_enable,
+	[0x50] = smc_smd_setup,
+	[0x60] = smc_wdt_set_counter,
+	[0x61] = smc_wdt_reload_counter,
+#ifdef CONFIG_SVC_MGR_STATS
+	[SMC_ID_STATS] = smc_stats_query,
+#endif
+};
+
+#ifdef CONFIG_SVC_MGR_STATS
+struct smc_stats {
+	unsigned int	calls;
+	unsigned int	cycles;		/* total, wraps */
+	unsigned int	max_cycles;
+};
+
+static struct smc_stats smc_stats[SMC_ID_COUNT];
+
+#define PMCR_E		0x01		/* all counters enable */
+#define PMCR_D		0x08		/* cycle counter counts every 64 cycles */
+#define PMU_CYCLES	0x80000000	/* cycle counter bit of PMCNTEN, PMOVSR */
+
+/*
+ * The Performance Monitors belong to the Normal World. When its cycle
+ * counter runs, it is only read, with the settings of the Normal World.
+ * When it is stopped, it is started for the call only, every cycle, the
+ * event counters held, then the registers are put back as they were.
+ */
+struct smc_pmu {
+	unsigned int	pmcr;
+	unsigned int	cnten;
+	unsigned int	ovs;
+	unsigned int	ccnt;
+};
+
+static unsigned int smc_cycles_start(struct smc_pmu *pmu)
+{
+	unsigned int val;
 
-		if (is_pck_clk_secure(pck_mask)) {
-			ret = -1;
-		} else {
-			pmc_pck_setup(args->r1, args->r2);
-			ret = 0;
+	asm volatile ("mrc p15, 0, %0, c9, c12, 0" : "=r" (pmu->pmcr));
+	asm volatile ("mrc p15, 0, %0, c9, c12, 1" : "=r" (pmu->cnten));
+
+	if (!(pmu->pmcr & PMCR_E) || !(pmu->cnten & PMU_CYCLES)) {
+		asm volatile ("mrc p15, 0, %0, c9, c12, 3" : "=r" (pmu->ovs));
+		asm volatile ("mrc p15, 0, %0, c9, c13, 0" : "=r" (pmu->ccnt));
+
+		/* PMCNTENCLR, PMCNTENSET, then PMCR */
+		val = pmu->cnten & ~PMU_CYCLES;
+		asm volatile ("mcr p15, 0, %0, c9, c12, 2" : : "r" (val));
+		asm volatile ("mcr p15, 0, %0, c9, c12, 1" : : "r" (PMU_CYCLES));
+		val = (pmu->pmcr | PMCR_E) & ~PMCR_D;
+		asm volatile ("mcr p15, 0, %0, c9, c12, 0" : : "r" (val));
+		isb();
+	}
+
+	asm volatile ("mrc p15, 0, %0, c9, c13, 0" : "=r" (val));
+
+	return val;
+}
+
+static unsigned int smc_cycles_end(struct smc_pmu *pmu)
+{
+	unsigned int val, now;
+
+	asm volatile ("mrc p15, 0, %0, c9, c13, 0" : "=r" (now));
+
+	if (!(pmu->pmcr & PMCR_E) || !(pmu->cnten & PMU_CYCLES)) {
+		asm volatile ("mcr p15, 0, %0, c9, c12, 0" : : "r" (pmu->pmcr));
+		asm volatile ("mcr p15, 0, %0, c9, c12, 2" : : "r" (PMU_CYCLES));
+		asm volatile ("mcr p15, 0, %0, c9, c12, 1" : : "r" (pmu->cnten));
+		isb();
+		asm volatile ("mcr p15, 0, %0, c9, c13, 0" : : "r" (pmu->ccnt));
+
+		/* PMOVSR, an overflow during the call is not reported */
+		if (!(pmu->ovs & PMU_CYCLES)) {
+			val = PMU_CYCLES;
+			asm volatile ("mcr p15, 0, %0, c9, c12, 3" : : "r" (val));
 		}
-		break;
+	}
 
-	case 0x42:
-		l2cache_enable();
-		break;
-	case 0x50:
-		pmc_smd_setup(args->r1);
-		break;
+	return now;
+}
 
-	case 0x60:
-		ret = at91_wdt_set_counter(args->r1);
-		break;
+/*
+ * r1: the SMC ID, r2: SMC_STATS_CALLS, SMC_STATS_CYCLES or
+ * SMC_STATS_MAX_CYCLES. The counters are only read, never reset.
+ */
+static int smc_stats_query(struct smc_args_t const *args)
+{
+	struct smc_stats *stats;
 
-	case 0x61:
-		ret = at91_wdt_reload_counter();
-		break;
+	if (args->r1 >= SMC_ID_COUNT || !smc_handlers[args->r1])
+		return -1;
+
+	stats = &smc_stats[args->r1];
 
+	switch (args->r2) {
+	case SMC_STATS_CALLS:
+		return stats->calls;
+	case SMC_STATS_CYCLES:
+		return stats->cycles;
+	case SMC_STATS_MAX_CYCLES:
+		return stats->max_cycles;
 	default:
+		return -1;
+	}
+}
+#endif
+
+/*
+ * svc_mgr_main - C entry point of the secure world when a SMC is processed
+ * in Normal World
+ */
+int svc_mgr_main(struct smc_args_t const *args)
+{
+	smc_handler_t handler = NULL;
+	int ret;
+#ifdef CONFIG_SVC_MGR_STATS
+	struct smc_pmu pmu;
+	unsigned int start, cycles;
+#endif
+
+	dbg_loud("--> svc_mgr_main\n");
+
+	if (args->r0 < SMC_ID_COUNT)
+		handler = smc_handlers[args->r0];
+
+	if (!handler) {
 		dbg_info("svc mgr error: SMC ID (%d) not defined\n",
 							args->r0);
-		ret = -1;
-		break;
+		return -1;
 	}
 
+#ifdef CONFIG_SVC_MGR_STATS
+	start = smc_cycles_start(&pmu);
+#endif
+
+	ret = handler(args);
+
+#ifdef CONFIG_SVC_MGR_STATS
+	cycles = smc_cycles_end(&pmu) - start;
+	smc_stats[args->r0].calls++;
+	smc_stats[args->r0].cycles += cycles;
+	if (cycles > smc_stats[args->r0].max_cycles)
+		smc_stats[args->r0].max_cycles = cycles;
+#endif
+
 	dbg_loud("<-- svc_mgr_main\n");
 
 	return ret;
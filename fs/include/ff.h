@@ -77,8 +77,9 @@ typedef char TCHAR;
 typedef struct {
 	BYTE	fs_type;		/* FAT sub-type (0:Not mounted) */
 	BYTE	drv;			/* Physical drive number */
-	BYTE	csize;			/* Sectors per cluster (1,2,4...128) */
 	BYTE	n_fats;			/* Number of FAT copies (1,2) */
+	WORD	csize;			/* Sectors per cluster (1,2,4...128, up to 32768 on exFAT) */
+	BYTE	csize_sh;		/* log2 of csize, to convert offsets without division */
 	BYTE	wflag;			/* win[] dirty flag (1:must be written back) */
 	BYTE	fsi_flag;		/* fsinfo dirty flag (1:must be written back) */
 	WORD	id;				/* File system mount ID */
@@ -103,6 +104,9 @@ typedef struct {
 	DWORD	dirbase;		/* Root directory start sector (FAT32:Cluster#) */
 	DWORD	database;		/* Data start sector */
 	DWORD	winsect;		/* Current sector appearing in the win[] */
+#if _FAT_CACHE_SECTORS
+	DWORD	fatcsect;		/* First FAT sector in the FAT cache (0:empty) */
+#endif
 	BYTE	win[_MAX_SS];		/* Disk access window for Directory, FAT (and Data on tiny cfg) */
 } FATFS;
 
@@ -125,7 +129,8 @@ typedef struct {
 	BYTE*	dir_ptr;		/* Ponter to the directory entry in the window */
 #endif
 #if _USE_FASTSEEK
-	DWORD*	cltbl;			/* Pointer to the cluster link map table (null on file open) */
+	DWORD*	cltbl;			/* Pointer to the cluster link map table (null:follow the FAT) */
+	DWORD	clmt[_FS_CLMT_SIZE];	/* Cluster link map table built at f_open */
 #endif
 #if _FS_SHARE
 	UINT	lockid;			/* File lock ID (index of file semaphore table) */
@@ -152,6 +157,10 @@ typedef struct {
 	WCHAR*	lfn;			/* Pointer to the LFN working buffer */
 	WORD	lfn_idx;		/* Last matched LFN index number (0xFFFF:No LFN) */
 #endif
+#if _FS_EXFAT
+	DWORD	eclust;			/* Last cluster of a contiguous table (0:FAT chain) */
+	BYTE	sdir[32];		/* FAT style entry of the exFAT object found */
+#endif
 } DIR;
 
 
@@ -296,6 +305,7 @@ int ff_del_syncobj (_SYNC_t);		/* Delete a sync object */
 #define FS_FAT12	1
 #define FS_FAT16	2
 #define FS_FAT32	3
+#define FS_EXFAT	4
 
 
 /* File attribute bits for directory entry */
@@ -48,10 +48,45 @@
 /* To enable f_forward function, set _USE_FORWARD to 1 and set _FS_TINY to 1. */
 
 
+#ifdef CONFIG_FATFS_FAST_SEEK
+#define	_USE_FASTSEEK	1	/* 0:Disable or 1:Enable */
+#else
 #define	_USE_FASTSEEK	0	/* 0:Disable or 1:Enable */
+#endif
 /* To enable fast seek feature, set _USE_FASTSEEK to 1. */
 
 
+#ifdef CONFIG_FATFS_FAST_SEEK_EXTENTS
+#define	_FS_CLMT_SIZE	(2 * CONFIG_FATFS_FAST_SEEK_EXTENTS + 2)
+#else
+#define	_FS_CLMT_SIZE	4
+#endif
+/* With fast seek enabled, f_open maps the cluster chain of the file into a
+/  table of this many items in the file object, so that f_read does not
+/  follow the FAT. Files more fragmented than (_FS_CLMT_SIZE - 2) / 2
+/  extents use the FAT. */
+
+
+#ifdef CONFIG_FATFS_EXFAT
+#define	_FS_EXFAT	1	/* 0:Disable or 1:Enable */
+#else
+#define	_FS_EXFAT	0	/* 0:Disable or 1:Enable */
+#endif
+/* To enable read-only exFAT support, set _FS_EXFAT to 1. It requires the
+/  LFN feature for the file names and the fast seek feature, which maps the
+/  contiguous (NoFatChain) files without reading the FAT. */
+
+
+#ifdef CONFIG_FATFS_FAT_CACHE_SECTORS
+#define	_FAT_CACHE_SECTORS	CONFIG_FATFS_FAT_CACHE_SECTORS
+#else
+#define	_FAT_CACHE_SECTORS	0
+#endif
+/* Number of FAT sectors read at once into the FAT cache (0:Disable, 1..128).
+/  The cluster chains are followed in memory instead of through the single
+/  sector window. */
+
+
 
 /*---------------------------------------------------------------------------/
 / Locale and Namespace Configurations
@@ -48,7 +48,7 @@ DSTATUS disk_status(BYTE drv    /* Physical drive number (0..) */
 DRESULT disk_read(BYTE drv,     /* Physical drive number (0..) */
                   BYTE *buff,  /* Data buffer to store read data */
                   DWORD sector, /* Start sector number (LBA) */
-                  BYTE count    /* Sector count (1..255) */
+                  UINT count    /* Sector count */
     )
 {
 	if (drv || !count) return RES_PARERR;
@@ -70,7 +70,7 @@ DRESULT disk_read(BYTE drv,     /* Physical drive number (0..) */
 DRESULT disk_write(BYTE drv,    /* Physical drive number (0..) */
                    const BYTE * buff,   /* Data to be written */
                    DWORD sector,        /* Sector number (LBA) */
-                   BYTE count   /* Sector count (1..255) */
+                   UINT count   /* Sector count */
     )
 {
 }
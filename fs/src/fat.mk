@@ -11,4 +11,6 @@ COBJS-$(CONFIG_FATFS)	+=  $(FS_FAT)/ff.o
 COBJS-$(CONFIG_FATFS)	+=  $(FS_FAT)/diskio.o
 COBJS-$(CONFIG_FATFS)	+=  $(FS_FAT)/option/ccsbcs.o
 
+HOTOBJS-$(CONFIG_FATFS)	+=  $(FS_FAT)/ff.o
+
 
@@ -132,6 +132,14 @@
 #define	ABORT(fs, res)		{ fp->flag |= FA__ERROR; LEAVE_FF(fs, res); }
 
 
+/* exFAT feature */
+#if _FS_EXFAT
+#if !_FS_READONLY || !_USE_LFN || !_USE_FASTSEEK
+#error exFAT needs the read-only, LFN and fast seek cfg.
+#endif
+#endif
+
+
 /* File shareing feature */
 #if _FS_SHARE
 #if _FS_READONLY
@@ -433,6 +441,16 @@ typedef struct {
 #define	SZ_PTE			16	/* MBR: Size of a partition table entry */
 #define BS_55AA			510	/* Boot sector signature (2) */
 
+#define BPB_FatOfsEx		80	/* exFAT: FAT offset from the volume top [sector] (4) */
+#define BPB_FatSzEx		84	/* exFAT: FAT size [sector] (4) */
+#define BPB_DataOfsEx		88	/* exFAT: Data area offset from the volume top [sector] (4) */
+#define BPB_NumClusEx		92	/* exFAT: Number of clusters (4) */
+#define BPB_RootClusEx		96	/* exFAT: Root dir first cluster (4) */
+#define BPB_VolFlagEx		106	/* exFAT: Volume flags (2) */
+#define BPB_BytsPerSecEx	108	/* exFAT: Log2 of sector size [byte] (1) */
+#define BPB_SecPerClusEx	109	/* exFAT: Log2 of cluster size [sector] (1) */
+#define BPB_NumFATsEx		110	/* exFAT: Number of FAT copies (1) */
+
 #define	DIR_Name		0	/* Short file name (11) */
 #define	DIR_Attr		11	/* Attribute (1) */
 #define	DIR_NTres		12	/* NT flag (1) */
@@ -453,6 +471,20 @@ typedef struct {
 #define	DDE			0xE5	/* Deleted directory enrty mark in DIR_Name[0] */
 #define	NDDE			0x05	/* Replacement of a character collides with DDE */
 
+#define	XDIR_Type		0	/* exFAT: Type of the entry (1) */
+#define	XDIR_NumSec		1	/* exFAT: Number of secondary entries (1) */
+#define	XDIR_Attr		4	/* exFAT: Attribute (2) */
+#define	XDIR_GenFlags		1	/* exFAT: General secondary flags (1) */
+#define	XDIR_NumName		3	/* exFAT: Number of characters of the name (1) */
+#define	XDIR_ValidFileSize	8	/* exFAT: Valid file size (8) */
+#define	XDIR_FstClus		20	/* exFAT: First cluster (4) */
+#define	XDIR_FileSize		24	/* exFAT: File/directory size (8) */
+#define	XDIR_Name		2	/* exFAT: Part of the name (30) */
+#define	ET_FILEDIR		0x85	/* exFAT: File and directory entry */
+#define	ET_STREAM		0xC0	/* exFAT: Stream extension entry */
+#define	ET_FILENAME		0xC1	/* exFAT: File name entry */
+#define	GSF_NOFATCHAIN		0x02	/* exFAT: Contiguous allocation, no FAT chain */
+
 
 /*------------------------------------------------------------*/
 /* Module private work area                                   */
@@ -752,6 +784,46 @@ FRESULT move_window (
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Get a FAT sector through the FAT cache or the window                  */
+/*-----------------------------------------------------------------------*/
+
+#if _FAT_CACHE_SECTORS
+static BYTE FatCache[_FAT_CACHE_SECTORS * _MAX_SS];	/* FAT sectors from fs->fatcsect */
+#endif
+
+static
+BYTE* fat_win (		/* Pointer to the sector data, 0:Disk error */
+	FATFS *fs,	/* File system object */
+	DWORD sector	/* FAT sector number */
+)
+{
+#if _FAT_CACHE_SECTORS
+	DWORD csect, end;
+	UINT n;
+
+
+	/* Load the FAT sectors of the aligned block containing the sector at once */
+	csect = sector - (sector - fs->fatbase) % _FAT_CACHE_SECTORS;
+	if (fs->fatcsect != csect) {
+		end = fs->fatbase + fs->fsize;
+		n = (end - csect < _FAT_CACHE_SECTORS) ? (UINT)(end - csect) : _FAT_CACHE_SECTORS;
+		fs->fatcsect = 0;
+		if (disk_read(fs->drv, FatCache, csect, n) != RES_OK)
+			return 0;
+		fs->fatcsect = csect;
+	}
+	return &FatCache[(sector - csect) * SS(fs)];
+#else
+	if (move_window(fs, sector))
+		return 0;
+	return fs->win;
+#endif
+}
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Clean-up cached data                                                  */
 /*-----------------------------------------------------------------------*/
@@ -830,21 +902,28 @@ DWORD get_fat (		/* 0xFFFFFFFF:Disk error, 1:Internal error, Else:Cluster status
 	switch (fs->fs_type) {
 	case FS_FAT12 :
 		bc = (UINT)clst; bc += bc / 2;
-		if (move_window(fs, fs->fatbase + (bc / SS(fs)))) break;
-		wc = fs->win[bc % SS(fs)]; bc++;
-		if (move_window(fs, fs->fatbase + (bc / SS(fs)))) break;
-		wc |= fs->win[bc % SS(fs)] << 8;
+		if (!(p = fat_win(fs, fs->fatbase + (bc / SS(fs))))) break;
+		wc = p[bc % SS(fs)]; bc++;
+		if (!(p = fat_win(fs, fs->fatbase + (bc / SS(fs))))) break;
+		wc |= p[bc % SS(fs)] << 8;
 		return (clst & 1) ? (wc >> 4) : (wc & 0xFFF);
 
 	case FS_FAT16 :
-		if (move_window(fs, fs->fatbase + (clst / (SS(fs) / 2)))) break;
-		p = &fs->win[clst * 2 % SS(fs)];
+		if (!(p = fat_win(fs, fs->fatbase + (clst / (SS(fs) / 2))))) break;
+		p += clst * 2 % SS(fs);
 		return LD_WORD(p);
 
 	case FS_FAT32 :
-		if (move_window(fs, fs->fatbase + (clst / (SS(fs) / 4)))) break;
-		p = &fs->win[clst * 4 % SS(fs)];
+		if (!(p = fat_win(fs, fs->fatbase + (clst / (SS(fs) / 4))))) break;
+		p += clst * 4 % SS(fs);
 		return LD_DWORD(p) & 0x0FFFFFFF;
+#if _FS_EXFAT
+	case FS_EXFAT :
+		if (!(p = fat_win(fs, fs->fatbase + (clst / (SS(fs) / 4))))) break;
+		p += clst * 4 % SS(fs);
+		clst = LD_DWORD(p);
+		return (clst >= fs->n_fatent) ? fs->n_fatent : clst;	/* Any end of chain mark as n_fatent */
+#endif
 	}
 
 	return 0xFFFFFFFF;	/* An error occurred at the disk I/O layer */
@@ -1034,28 +1113,106 @@ DWORD create_chain (	/* 0:No free cluster, 1:Internal error, 0xFFFFFFFF:Disk err
 
 #if _USE_FASTSEEK
 static
-DWORD clmt_clust (		/* <2:Error, >=2:Cluster number */
+DWORD* clmt_frag (		/* 0:Error, Else:Fragment {length, top} holding the cluster */
 	FIL* fp,		/* Pointer to the file object */
-	DWORD ofs		/* File offset to be converted to cluster# */
+	DWORD ofs,		/* File offset to be converted to cluster# */
+	DWORD* ci		/* Returns the cluster order in the fragment */
 )
 {
 	DWORD cl, ncl, *tbl;
 
 
 	tbl = fp->cltbl + 1;			/* Top of CLMT */
-	cl = ofs / SS(fp->fs) / fp->fs->csize;	/* Cluster order from top of the file */
+	cl = ofs / SS(fp->fs) >> fp->fs->csize_sh;	/* Cluster order from top of the file */
 	for (;;) {
-		ncl = *tbl++;			/* Number of cluters in the fragment */
+		ncl = *tbl;			/* Number of cluters in the fragment */
 		if (!ncl) return 0;		/* End of table? (error) */
 		if (cl < ncl) break;		/* In this fragment? */
-		cl -= ncl; tbl++;		/* Next fragment */
+		cl -= ncl; tbl += 2;		/* Next fragment */
 	}
-	return cl + *tbl;			/* Return the cluster number */
+	*ci = cl;
+	return tbl;
+}
+
+
+static
+DWORD clmt_clust (		/* <2:Error, >=2:Cluster number */
+	FIL* fp,		/* Pointer to the file object */
+	DWORD ofs		/* File offset to be converted to cluster# */
+)
+{
+	DWORD cl, *tbl;
+
+
+	tbl = clmt_frag(fp, ofs, &cl);
+	if (!tbl) return 0;
+	return cl + tbl[1];			/* Return the cluster number */
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* FAT handling - Create the link map table of the file                  */
+/*-----------------------------------------------------------------------*/
+
+static
+FRESULT create_clmt (	/* FR_OK:Succeeded, FR_NOT_ENOUGH_CORE:Table too small, Else:Error */
+	FIL* fp			/* Pointer to the file object, fp->cltbl[0] holds the table size */
+)
+{
+	DWORD cl, pcl, ncl, tcl, tlen, ulen, *tbl;
+
+
+	tbl = fp->cltbl;
+	tlen = *tbl++; ulen = 2;	/* Given table size and required table size */
+	cl = fp->sclust;		/* Top of the chain */
+	if (cl) {
+		do {
+			/* Get a fragment */
+			tcl = cl; ncl = 0; ulen += 2;	/* Top, length and used items */
+			do {
+				pcl = cl; ncl++;
+				cl = get_fat(fp->fs, cl);
+				if (cl <= 1) return FR_INT_ERR;
+				if (cl == 0xFFFFFFFF) return FR_DISK_ERR;
+			} while (cl == pcl + 1);
+			if (ulen <= tlen) {		/* Store the length and top of the fragment */
+				*tbl++ = ncl; *tbl++ = tcl;
+			}
+		} while (cl < fp->fs->n_fatent);	/* Repeat until end of chain */
+	}
+	*fp->cltbl = ulen;	/* Number of items used */
+	if (ulen > tlen)
+		return FR_NOT_ENOUGH_CORE;	/* Given table size is smaller than required */
+	*tbl = 0;		/* Terminate table */
+
+	return FR_OK;
 }
 #endif	/* _USE_FASTSEEK */
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Directory handling - Get the next cluster of the table                */
+/*-----------------------------------------------------------------------*/
+
+static
+DWORD dir_next_clust (	/* 0xFFFFFFFF:Disk error, 1:Internal error, >=n_fatent:End of table, Else:Next cluster# */
+	DIR *dj,		/* Pointer to directory object */
+	DWORD clst		/* Current cluster# */
+)
+{
+#if _FS_EXFAT
+	if (dj->eclust)		/* Contiguous table on exFAT */
+		return (clst < dj->eclust) ? clst + 1 : dj->fs->n_fatent;
+#endif
+	return get_fat(dj->fs, clst);
+}
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Directory handling - Set directory index                              */
 /*-----------------------------------------------------------------------*/
@@ -1066,15 +1223,14 @@ FRESULT dir_sdi (
 	WORD idx		/* Directory index number */
 )
 {
-	DWORD clst;
-	WORD ic;
+	DWORD clst, ic;
 
 
 	dj->index = idx;
 	clst = dj->sclust;
 	if (clst == 1 || clst >= dj->fs->n_fatent)	/* Check start cluster range */
 		return FR_INT_ERR;
-	if (!clst && dj->fs->fs_type == FS_FAT32)	/* Replace cluster# 0 with root cluster# if in FAT32 */
+	if (!clst && dj->fs->fs_type >= FS_FAT32)	/* Replace cluster# 0 with root cluster# if in FAT32/exFAT */
 		clst = dj->fs->dirbase;
 
 	if (clst == 0) {	/* Static table (root-dir in FAT12/16) */
@@ -1086,7 +1242,7 @@ FRESULT dir_sdi (
 	else {				/* Dynamic table (sub-dirs or root-dir in FAT32) */
 		ic = SS(dj->fs) / SZ_DIR * dj->fs->csize;	/* Entries per cluster */
 		while (idx >= ic) {				/* Follow cluster chain */
-			clst = get_fat(dj->fs, clst);			/* Get next cluster */
+			clst = dir_next_clust(dj, clst);		/* Get next cluster */
 			if (clst == 0xFFFFFFFF) return FR_DISK_ERR;	/* Disk error */
 			if (clst < 2 || clst >= dj->fs->n_fatent)	/* Reached to end of table or int error */
 				return FR_INT_ERR;
@@ -1132,7 +1288,7 @@ FRESULT dir_next (		/* FR_OK:Succeeded, FR_NO_FILE:End of table, FR_DENIED:EOT a
 		}
 		else {					/* Dynamic table */
 			if (((i / (SS(dj->fs) / SZ_DIR)) & (dj->fs->csize - 1)) == 0) {	/* Cluster changed? */
-				clst = get_fat(dj->fs, dj->clust);			/* Get next cluster */
+				clst = dir_next_clust(dj, dj->clust);			/* Get next cluster */
 				if (clst <= 1) return FR_INT_ERR;
 				if (clst == 0xFFFFFFFF) return FR_DISK_ERR;
 				if (clst >= dj->fs->n_fatent) {				/* When it reached end of dynamic table */
@@ -1344,6 +1500,80 @@ BYTE sum_sfn (
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Directory handling - Find an object in the exFAT directory            */
+/*-----------------------------------------------------------------------*/
+#if _FS_EXFAT
+/* The entry set of the object found is translated into the FAT style entry
+/  dj->sdir, pointed by dj->dir, so that the callers handle both the same. */
+
+static
+FRESULT dir_find_ex (
+	DIR *dj			/* Pointer to the directory object linked to the file name */
+)
+{
+	FRESULT res;
+	BYTE *dir, c, attr = 0, flags = 0, nlen = 0, state = 0;
+	DWORD clst = 0, size = 0, sizeh = 0;
+	UINT i, ni = 0, match = 0;
+	WCHAR wc;
+
+
+	res = dir_sdi(dj, 0);			/* Rewind directory object */
+	if (res != FR_OK) return res;
+
+	do {
+		res = move_window(dj->fs, dj->sect);
+		if (res != FR_OK) break;
+		dir = dj->dir;				/* Ptr to the directory entry of current index */
+		c = dir[XDIR_Type];
+		if (c == 0) { res = FR_NO_FILE; break; }	/* Reached to end of table */
+		if (c == ET_FILEDIR) {			/* Top of an entry set */
+			attr = (BYTE)LD_WORD(dir+XDIR_Attr);
+			state = 1;
+		} else if (c == ET_STREAM && state == 1) {
+			flags = dir[XDIR_GenFlags];
+			nlen = dir[XDIR_NumName];
+			clst = LD_DWORD(dir+XDIR_FstClus);
+			size = LD_DWORD(dir+XDIR_ValidFileSize);
+			sizeh = LD_DWORD(dir+XDIR_ValidFileSize+4);
+			ni = 0; match = 1;
+			state = 2;
+		} else if (c == ET_FILENAME && state == 2) {
+			for (i = 0; i < 15 && ni < nlen; i++, ni++) {	/* Compare the part of the name */
+				wc = LD_WORD(dir+XDIR_Name+i*2);
+				if (ni >= _MAX_LFN || ff_wtoupper(wc) != ff_wtoupper(dj->lfn[ni]))
+					match = 0;
+			}
+			if (ni == nlen) {			/* End of the name */
+				if (match && !dj->lfn[ni]) break;	/* Found */
+				state = 0;
+			}
+		} else {				/* Other or deleted entries */
+			state = 0;
+		}
+		res = dir_next(dj, 0);			/* Next entry */
+	} while (res == FR_OK);
+
+	if (res == FR_OK) {
+		if (sizeh) return FR_DENIED;		/* Cannot handle >= 4GiB objects */
+		dir = dj->sdir;
+		mem_set(dir, 0, SZ_DIR);
+		dir[DIR_Name] = ' ';
+		dir[DIR_Attr] = attr & AM_MASK;
+		dir[DIR_NTres] = flags;			/* Keep the NoFatChain flag */
+		ST_CLUST(dir, clst);
+		ST_DWORD(dir+DIR_FileSize, size);
+		dj->dir = dir;
+	}
+
+	return res;
+}
+#endif
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Directory handling - Find an object in the directory                  */
 /*-----------------------------------------------------------------------*/
@@ -1359,6 +1589,10 @@ FRESULT dir_find (
 	BYTE a, ord, sum;
 #endif
 
+#if _FS_EXFAT
+	if (dj->fs->fs_type == FS_EXFAT)
+		return dir_find_ex(dj);
+#endif
 	res = dir_sdi(dj, 0);			/* Rewind directory object */
 	if (res != FR_OK) return res;
 
@@ -1935,6 +2169,9 @@ FRESULT follow_path (	/* FR_OK(0): successful, !=0: error code */
 		path++;
 	dj->sclust = 0;				/* Start from the root dir */
 #endif
+#if _FS_EXFAT
+	dj->eclust = 0;				/* The root dir is on a FAT chain */
+#endif
 
 	if ((UINT)*path < ' ') {		/* Nul path means the start directory itself */
 		res = dir_sdi(dj, 0);
@@ -1964,6 +2201,17 @@ FRESULT follow_path (	/* FR_OK(0): successful, !=0: error code */
 				res = FR_NO_PATH; break;
 			}
 			dj->sclust = LD_CLUST(dir);
+#if _FS_EXFAT
+			dj->eclust = 0;
+			if (dj->fs->fs_type == FS_EXFAT && (dir[DIR_NTres] & GSF_NOFATCHAIN)) {	/* Contiguous sub dir on exFAT */
+				DWORD dsz = LD_DWORD(dir+DIR_FileSize);
+
+				if (!dsz || !dj->sclust) {	/* A directory has one cluster at least */
+					res = FR_NO_FILESYSTEM; break;
+				}
+				dj->eclust = dj->sclust + ((dsz - 1) / SS(dj->fs) >> dj->fs->csize_sh);	/* Last cluster */
+			}
+#endif
 		}
 	}
 
@@ -1992,6 +2240,10 @@ BYTE check_fs (	/* 0:FAT-VBR, 1:Valid BR but not FAT, 2:Not a BR, 3:Disk error *
 		return 0;
 	if ((LD_DWORD(&fs->win[BS_FilSysType32]) & 0xFFFFFF) == 0x544146)
 		return 0;
+#if _FS_EXFAT
+	if (!mem_cmp(&fs->win[BS_OEMName], "EXFAT   ", 8))	/* Check "EXFAT" string */
+		return 0;
+#endif
 
 	return 1;
 }
@@ -1999,6 +2251,54 @@ BYTE check_fs (	/* 0:FAT-VBR, 1:Valid BR but not FAT, 2:Not a BR, 3:Disk error *
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Initialize the file system object from an exFAT boot record           */
+/*-----------------------------------------------------------------------*/
+#if _FS_EXFAT
+static
+FRESULT mount_exfat (	/* FR_OK(0): successful, !=0: any error occurred */
+	FATFS *fs,	/* File system object, the boot record is in fs->win */
+	DWORD bsect	/* Volume offset in LBA */
+)
+{
+	BYTE b;
+
+
+	if (fs->win[BPB_BytsPerSecEx] != 9)			/* (Sector size must be 512) */
+		return FR_NO_FILESYSTEM;
+	b = fs->win[BPB_SecPerClusEx];				/* (Cluster size up to 16MiB) */
+	if (b > 15) return FR_NO_FILESYSTEM;
+	fs->csize = 1 << b;					/* Number of sectors per cluster */
+	fs->csize_sh = b;
+
+	fs->n_fats = b = fs->win[BPB_NumFATsEx];		/* Number of FAT copies */
+	if (b != 1 && b != 2) return FR_NO_FILESYSTEM;
+	fs->fsize = LD_DWORD(fs->win+BPB_FatSzEx);		/* Number of sectors per FAT */
+	fs->fatbase = bsect + LD_DWORD(fs->win+BPB_FatOfsEx);	/* FAT start sector */
+	if (b == 2 && (LD_WORD(fs->win+BPB_VolFlagEx) & 1))	/* Second FAT is the active one */
+		fs->fatbase += fs->fsize;
+	fs->database = bsect + LD_DWORD(fs->win+BPB_DataOfsEx);	/* Data start sector */
+	fs->n_fatent = LD_DWORD(fs->win+BPB_NumClusEx) + 2;	/* Number of FAT entries */
+	fs->dirbase = LD_DWORD(fs->win+BPB_RootClusEx);		/* Root directory start cluster */
+	fs->n_rootdir = 0;
+	if (fs->n_fatent < 3 || fs->fsize < (fs->n_fatent + SS(fs) / 4 - 1) / (SS(fs) / 4))
+		return FR_NO_FILESYSTEM;			/* (FAT must cover the clusters) */
+
+	fs->fs_type = FS_EXFAT;		/* FAT sub-type */
+	fs->id = ++Fsid;		/* File system mount ID */
+	fs->winsect = 0;		/* Invalidate sector cache */
+#if _FAT_CACHE_SECTORS
+	fs->fatcsect = 0;		/* Invalidate FAT cache */
+#endif
+	fs->wflag = 0;
+
+	return FR_OK;
+}
+#endif
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Check if the file system object is valid or not                       */
 /*-----------------------------------------------------------------------*/
@@ -2076,6 +2376,10 @@ FRESULT chk_mounted (	/* FR_OK(0): successful, !=0: any error occurred */
 	}
 	if (fmt == 3) return FR_DISK_ERR;
 	if (fmt) return FR_NO_FILESYSTEM;		/* No FAT volume is found */
+#if _FS_EXFAT
+	if (!mem_cmp(&fs->win[BS_OEMName], "EXFAT   ", 8))	/* An exFAT volume is found */
+		return mount_exfat(fs, bsect);
+#endif
 
 	/* An FAT volume is found. Following code initializes the file system object */
 
@@ -2092,6 +2396,7 @@ FRESULT chk_mounted (	/* FR_OK(0): successful, !=0: any error occurred */
 
 	fs->csize = b = fs->win[BPB_SecPerClus];		/* Number of sectors per cluster */
 	if (!b || (b & (b - 1))) return FR_NO_FILESYSTEM;	/* (Must be power of 2) */
+	for (fs->csize_sh = 0; (1 << fs->csize_sh) < b; fs->csize_sh++) ;
 
 	fs->n_rootdir = LD_WORD(fs->win+BPB_RootEntCnt);	/* Number of root directory entries */
 	if (fs->n_rootdir % (SS(fs) / SZ_DIR)) return FR_NO_FILESYSTEM;	/* (BPB_RootEntCnt must be sector aligned) */
@@ -2149,6 +2454,9 @@ FRESULT chk_mounted (	/* FR_OK(0): successful, !=0: any error occurred */
 	fs->fs_type = fmt;		/* FAT sub-type */
 	fs->id = ++Fsid;		/* File system mount ID */
 	fs->winsect = 0;		/* Invalidate sector cache */
+#if _FAT_CACHE_SECTORS
+	fs->fatcsect = 0;		/* Invalidate FAT cache */
+#endif
 	fs->wflag = 0;
 #if _FS_RPATH
 	fs->cdir = 0;			/* Current directory (root dir) */
@@ -2352,10 +2660,24 @@ FRESULT f_open (
 		fp->fsize = LD_DWORD(dir+DIR_FileSize);	/* File size */
 		fp->fptr = 0;				/* File pointer */
 		fp->dsect = 0;
+		fp->fs = dj.fs; fp->id = dj.fs->id;	/* Validate file object */
 #if _USE_FASTSEEK
-		fp->cltbl = 0;				/* Normal seek mode */
+		fp->clmt[0] = _FS_CLMT_SIZE;		/* Map the cluster chain once */
+		fp->cltbl = fp->clmt;
+#if _FS_EXFAT
+		if (fp->fs->fs_type == FS_EXFAT && (dir[DIR_NTres] & GSF_NOFATCHAIN)) {	/* Contiguous file on exFAT, a single fragment without FAT */
+			fp->clmt[0] = 4;
+			fp->clmt[1] = fp->fsize ? (((fp->fsize - 1) / SS(fp->fs) >> fp->fs->csize_sh) + 1) : 0;	/* (An empty file has no cluster) */
+			fp->clmt[2] = fp->sclust;
+			fp->clmt[3] = 0;
+		} else
+#endif
+		res = create_clmt(fp);
+		if (res != FR_OK) {			/* Too fragmented, follow the FAT */
+			fp->cltbl = 0;
+			if (res == FR_NOT_ENOUGH_CORE) res = FR_OK;
+		}
 #endif
-		fp->fs = dj.fs; fp->id = dj.fs->id;	/* Validate file object */
 	}
 
 	LEAVE_FF(dj.fs, res);
@@ -2377,8 +2699,9 @@ FRESULT f_read (
 {
 	FRESULT res;
 	DWORD clst, sect, remain;
-	UINT rcnt, cc;
-	BYTE csect, *rbuff = buff;
+	UINT rcnt, cc, nc;
+	UINT csect;
+	BYTE *rbuff = buff;
 
 
 	*br = 0;	/* Initialize byte counter */
@@ -2395,7 +2718,7 @@ FRESULT f_read (
 	for ( ;  btr;					/* Repeat until all data read */
 		rbuff += rcnt, fp->fptr += rcnt, *br += rcnt, btr -= rcnt) {
 		if ((fp->fptr % SS(fp->fs)) == 0) {		/* On the sector boundary? */
-			csect = (BYTE)(fp->fptr / SS(fp->fs) & (fp->fs->csize - 1));	/* Sector offset in the cluster */
+			csect = (UINT)(fp->fptr / SS(fp->fs) & (fp->fs->csize - 1));	/* Sector offset in the cluster */
 			if (!csect) {					/* On the cluster boundary? */
 				if (fp->fptr == 0) {			/* On the top of the file? */
 					clst = fp->sclust;		/* Follow from the origin */
@@ -2416,9 +2739,28 @@ FRESULT f_read (
 			sect += csect;
 			cc = btr / SS(fp->fs);				/* When remaining bytes >= sector size, */
 			if (cc) {					/* Read maximum contiguous sectors directly */
-				if (csect + cc > fp->fs->csize)		/* Clip at cluster boundary */
-					cc = fp->fs->csize - csect;
-				if (disk_read(fp->fs->drv, rbuff, sect, (BYTE)cc) != RES_OK)
+				nc = fp->fs->csize - csect;		/* Sectors up to the cluster boundary */
+#if _USE_FASTSEEK
+				if (fp->cltbl) {			/* Merge up to the end of the fragment in the CLMT */
+					DWORD ci, *tbl = clmt_frag(fp, fp->fptr, &ci);
+
+					if (tbl) {
+						while (nc < cc && ++ci < tbl[0]) {
+							fp->clust = tbl[1] + ci;
+							nc += fp->fs->csize;
+						}
+					}
+				} else
+#endif
+				while (nc < cc) {			/* Merge the physically adjacent clusters */
+					clst = get_fat(fp->fs, fp->clust);
+					if (clst != fp->clust + 1) break;	/* Not adjacent, errors are caught on the next cluster */
+					fp->clust = clst;
+					nc += fp->fs->csize;
+				}
+				if (cc > nc)				/* Clip at the end of the contiguous clusters */
+					cc = nc;
+				if (disk_read(fp->fs->drv, rbuff, sect, cc) != RES_OK)
 					ABORT(fp->fs, FR_DISK_ERR);
 #if !_FS_READONLY && _FS_MINIMIZE <= 2			/* Replace one of the read sectors with cached data if it contains a dirty sector */
 #if _FS_TINY
@@ -2480,7 +2822,7 @@ FRESULT f_write (
 	DWORD clst, sect;
 	UINT wcnt, cc;
 	const BYTE *wbuff = buff;
-	BYTE csect;
+	UINT csect;
 
 
 	*bw = 0;	/* Initialize byte counter */
@@ -2496,7 +2838,7 @@ FRESULT f_write (
 	for ( ;  btw;							/* Repeat until all data written */
 		wbuff += wcnt, fp->fptr += wcnt, *bw += wcnt, btw -= wcnt) {
 		if ((fp->fptr % SS(fp->fs)) == 0) {	/* On the sector boundary? */
-			csect = (BYTE)(fp->fptr / SS(fp->fs) & (fp->fs->csize - 1));	/* Sector offset in the cluster */
+			csect = (UINT)(fp->fptr / SS(fp->fs) & (fp->fs->csize - 1));	/* Sector offset in the cluster */
 			if (!csect) {					/* On the cluster boundary? */
 				if (fp->fptr == 0) {			/* On the top of the file? */
 					clst = fp->sclust;		/* Follow from the origin */
@@ -2814,33 +3156,12 @@ FRESULT f_lseek (
 
 #if _USE_FASTSEEK
 	if (fp->cltbl) {	/* Fast seek */
-		DWORD cl, pcl, ncl, tcl, dsc, tlen, ulen, *tbl;
+		DWORD dsc;
 
 		if (ofs == CREATE_LINKMAP) {	/* Create CLMT */
-			tbl = fp->cltbl;
-			tlen = *tbl++; ulen = 2;	/* Given table size and required table size */
-			cl = fp->sclust;		/* Top of the chain */
-			if (cl) {
-				do {
-					/* Get a fragment */
-					tcl = cl; ncl = 0; ulen += 2;	/* Top, length and used items */
-					do {
-						pcl = cl; ncl++;
-						cl = get_fat(fp->fs, cl);
-						if (cl <= 1) ABORT(fp->fs, FR_INT_ERR);
-						if (cl == 0xFFFFFFFF) ABORT(fp->fs, FR_DISK_ERR);
-					} while (cl == pcl + 1);
-					if (ulen <= tlen) {		/* Store the length and top of the fragment */
-						*tbl++ = ncl; *tbl++ = tcl;
-					}
-				} while (cl < fp->fs->n_fatent);	/* Repeat until end of chain */
-			}
-			*fp->cltbl = ulen;	/* Number of items used */
-			if (ulen <= tlen)
-				*tbl = 0;	/* Terminate table */
-			else
-				res = FR_NOT_ENOUGH_CORE;	/* Given table size is smaller than required */
-
+			res = create_clmt(fp);
+			if (res != FR_OK && res != FR_NOT_ENOUGH_CORE)
+				ABORT(fp->fs, res);
 		} else {				/* Fast seek */
 			if (ofs > fp->fsize)		/* Clip offset at the file size */
 				ofs = fp->fsize;
@@ -3498,7 +3819,7 @@ FRESULT f_forward (
 	FRESULT res;
 	DWORD remain, clst, sect;
 	UINT rcnt;
-	BYTE csect;
+	UINT csect;
 
 
 	*bf = 0;	/* Initialize byte counter */
@@ -3515,7 +3836,7 @@ FRESULT f_forward (
 
 	for ( ;  btr && (*func)(0, 0);					/* Repeat until all data transferred or stream becomes busy */
 		fp->fptr += rcnt, *bf += rcnt, btr -= rcnt) {
-		csect = (BYTE)(fp->fptr / SS(fp->fs) & (fp->fs->csize - 1));	/* Sector offset in the cluster */
+		csect = (UINT)(fp->fptr / SS(fp->fs) & (fp->fs->csize - 1));	/* Sector offset in the cluster */
 		if ((fp->fptr % SS(fp->fs)) == 0) {				/* On the sector boundary? */
 			if (!csect) {						/* On the cluster boundary? */
 				clst = (fp->fptr == 0) ?			/* On the top of the file? */
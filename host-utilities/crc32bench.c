@@ -0,0 +1,208 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+/*
+ * Check lib/crc32.c against known vectors and a bitwise CRC-32, then time
+ * it against the byte by byte table walk and memcpy().
+ *
+ * Built and run on the host by "make crc32-bench".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "crc32.h"
+
+#define BENCH_SIZE	(4 << 20)	/* a kernel */
+#define BENCH_ROUNDS	16
+
+static const struct {
+	const char *data;
+	unsigned int len;
+	unsigned int crc;
+} vectors[] = {
+	{ "", 0, 0x00000000 },
+	{ "a", 1, 0xe8b7be43 },
+	{ "abc", 3, 0x352441c2 },
+	{ "123456789", 9, 0xcbf43926 },
+	{ "The quick brown fox jumps over the lazy dog", 43, 0x414fa339 },
+	{ "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"
+	  "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", 32, 0x190a55ad },
+	{ "\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff"
+	  "\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff",
+	  32, 0xff6cab0b },
+};
+
+static unsigned int byte_table[256];
+
+static unsigned int crc32_bitwise(unsigned int crc, const unsigned char *p,
+				  unsigned int len)
+{
+	int i;
+
+	crc = ~crc;
+	while (len--) {
+		crc ^= *p++;
+		for (i = 0; i < 8; i++)
+			crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+	}
+
+	return ~crc;
+}
+
+static unsigned int crc32_bytewise(unsigned int crc, const unsigned char *p,
+				   unsigned int len)
+{
+	crc = ~crc;
+	while (len--)
+		crc = byte_table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+
+	return ~crc;
+}
+
+static int check(const char *what, unsigned int got, unsigned int expected)
+{
+	if (got == expected)
+		return 0;
+
+	printf("FAIL %s: %08x, expected %08x\n", what, got, expected);
+	return 1;
+}
+
+static int check_vectors(void)
+{
+	unsigned int i;
+	int fails = 0;
+
+	for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+		fails += check("vector",
+			       crc32(0, vectors[i].data, vectors[i].len),
+			       vectors[i].crc);
+
+	return fails;
+}
+
+/* Every alignment and tail, in one go, split and copied */
+static int check_random(void)
+{
+	unsigned char src[300], dst[300];
+	unsigned int off, len, split, ref;
+	int fails = 0;
+
+	for (len = 0; len < sizeof(src); len++)
+		src[len] = rand();
+
+	for (off = 0; off < 8; off++) {
+		for (len = 0; len + off + 8 < sizeof(src); len++) {
+			ref = crc32_bitwise(0, src + off, len);
+			fails += check("aligned", crc32(0, src + off, len), ref);
+
+			split = len / 3;
+			fails += check("split",
+				       crc32(crc32(0, src + off, split),
+					     src + off + split, len - split),
+				       ref);
+
+			memset(dst, 0, sizeof(dst));
+			fails += check("copy",
+				       crc32_copy(0, dst + off, src + off, len),
+				       ref);
+			fails += check("copy data",
+				       memcmp(dst + off, src + off, len), 0);
+
+			fails += check("misaligned copy",
+				       crc32_copy(0, dst + (off ^ 1), src + off,
+						  len), ref);
+		}
+	}
+
+	return fails;
+}
+
+static double elapsed(struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (now.tv_sec - start->tv_sec)
+		+ (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void report(const char *name, double sec)
+{
+	printf("  %-12s %8.1f MB/s\n", name,
+	       (double)BENCH_SIZE * BENCH_ROUNDS / sec / (1 << 20));
+}
+
+static void bench(void)
+{
+	unsigned char *src, *dst;
+	struct timespec start;
+	unsigned int crc = 0;
+	int i;
+
+	src = malloc(BENCH_SIZE);
+	dst = malloc(BENCH_SIZE);
+	if (!src || !dst) {
+		printf("out of memory\n");
+		exit(1);
+	}
+	for (i = 0; i < BENCH_SIZE; i++)
+		src[i] = rand();
+	memcpy(dst, src, BENCH_SIZE);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < BENCH_ROUNDS; i++)
+		crc ^= crc32_bytewise(0, src, BENCH_SIZE);
+	report("byte table", elapsed(&start));
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < BENCH_ROUNDS; i++)
+		crc ^= crc32(0, src, BENCH_SIZE);
+	report("crc32", elapsed(&start));
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < BENCH_ROUNDS; i++)
+		memcpy(dst, src, BENCH_SIZE);
+	report("memcpy", elapsed(&start));
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < BENCH_ROUNDS; i++)
+		crc ^= crc32_copy(0, dst, src, BENCH_SIZE);
+	report("crc32_copy", elapsed(&start));
+
+	/* keeps the loops from being optimized out */
+	if (crc == 0x12345678)
+		printf("\n");
+
+	free(src);
+	free(dst);
+}
+
+int main(void)
+{
+	unsigned int i, j, c;
+	int fails;
+
+	for (i = 0; i < 256; i++) {
+		c = i;
+		for (j = 0; j < 8; j++)
+			c = (c & 1) ? (c >> 1) ^ 0xedb88320 : c >> 1;
+		byte_table[i] = c;
+	}
+
+	fails = check_vectors() + check_random();
+	if (fails) {
+		printf("CRC-32: %d failures\n", fails);
+		return 1;
+	}
+	printf("CRC-32: test vectors passed\n");
+
+	bench();
+
+	return 0;
+}
@@ -0,0 +1,1125 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+/*
+ * Check the fixup transaction of lib/fdt.c against the per-property path
+ * it replaced: a search of the node and of the property from the start of
+ * the blob, and a move of the rest of the blob, for each property set.
+ * Both must give the same tree, on boards built here, on random trees with
+ * random fixups, and on the blobs given on the command line. Then time both.
+ *
+ * The overlays applied on a base blob must give the tree built here, with
+ * their labels resolved and their phandles moved past the ones of the
+ * base. Malformed overlays, and random byte flips of a good one, must be
+ * refused or applied without reading or writing past their blobs.
+ *
+ * Built and run on the host by "make fdt-check", "make fdt-check
+ * DTBS=<blobs>" adds compiled device trees. lib/fdt.c stores addresses in
+ * 32 bits, the blobs are mapped in the low 2 GiB.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#include "common.h"
+#include "fdt.h"
+
+#define BLOB_SIZE	(256 * 1024)
+#define RANDOM_ROUNDS	2000
+#define FUZZ_ROUNDS	20000
+#define BASE_ROOM	(16 * 1024)
+#define BENCH_ROUNDS	2000
+
+#define FDT_MAGIC	0xd00dfeed
+#define FDT_BEGIN_NODE	1
+#define FDT_END_NODE	2
+#define FDT_PROP	3
+#define FDT_NOP		4
+#define FDT_END		9
+
+static int fails;
+
+int dbg_printf(const char *fmt_str, ...)
+{
+	return 0;
+}
+
+static unsigned int be32(const void *p)
+{
+	const unsigned char *b = p;
+
+	return ((unsigned int)b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3];
+}
+
+static void set_be32(void *p, unsigned int val)
+{
+	unsigned char *b = p;
+
+	b[0] = val >> 24;
+	b[1] = val >> 16;
+	b[2] = val >> 8;
+	b[3] = val;
+}
+
+static unsigned char *blob_alloc(void)
+{
+	unsigned char *blob;
+
+	blob = mmap(NULL, BLOB_SIZE, PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+	if (blob == MAP_FAILED) {
+		printf("no memory in the low 2 GiB\n");
+		exit(1);
+	}
+
+	return blob;
+}
+
+/* -------------------------------------------------------- */
+
+/* Blob writer: the dt struct is built in place, the dt strings aside */
+
+struct writer {
+	unsigned char *blob;
+	unsigned int size;
+	char strings[4096];
+	unsigned int stringslen;
+};
+
+#define HEADER_SIZE	40
+#define RSVMAP_SIZE	16
+
+static void w_begin(struct writer *w, unsigned char *blob)
+{
+	memset(blob, 0, BLOB_SIZE);
+	w->blob = blob;
+	w->size = HEADER_SIZE + RSVMAP_SIZE;
+	w->stringslen = 0;
+}
+
+static void w_cell(struct writer *w, unsigned int val)
+{
+	set_be32(w->blob + w->size, val);
+	w->size += 4;
+}
+
+static unsigned int w_string(struct writer *w, const char *name)
+{
+	unsigned int offset = 0;
+
+	while (offset < w->stringslen) {
+		if (!strcmp(w->strings + offset, name))
+			return offset;
+		offset += strlen(w->strings + offset) + 1;
+	}
+
+	strcpy(w->strings + offset, name);
+	w->stringslen += strlen(name) + 1;
+
+	return offset;
+}
+
+static void w_node(struct writer *w, const char *name)
+{
+	w_cell(w, FDT_BEGIN_NODE);
+	strcpy((char *)w->blob + w->size, name);
+	w->size += OF_ALIGN(strlen(name) + 1);
+}
+
+static void w_end(struct writer *w)
+{
+	w_cell(w, FDT_END_NODE);
+}
+
+static void w_prop(struct writer *w, const char *name,
+		   const void *value, unsigned int len)
+{
+	w_cell(w, FDT_PROP);
+	w_cell(w, len);
+	w_cell(w, w_string(w, name));
+	memcpy(w->blob + w->size, value, len);
+	w->size += OF_ALIGN(len);
+}
+
+static void w_prop_str(struct writer *w, const char *name, const char *value)
+{
+	w_prop(w, name, value, strlen(value) + 1);
+}
+
+static void w_prop_cell(struct writer *w, const char *name, unsigned int a)
+{
+	unsigned char cell[4];
+
+	set_be32(cell, a);
+	w_prop(w, name, cell, sizeof(cell));
+}
+
+static void w_prop_cells(struct writer *w, const char *name,
+			 unsigned int a, unsigned int b)
+{
+	unsigned char cells[8];
+
+	set_be32(cells, a);
+	set_be32(cells + 4, b);
+	w_prop(w, name, cells, sizeof(cells));
+}
+
+static void w_finish(struct writer *w)
+{
+	unsigned char *h = w->blob;
+	unsigned int struct_len;
+
+	w_cell(w, FDT_END);
+	struct_len = w->size - HEADER_SIZE - RSVMAP_SIZE;
+	memcpy(w->blob + w->size, w->strings, w->stringslen);
+
+	set_be32(h, FDT_MAGIC);
+	set_be32(h + 4, w->size + w->stringslen);
+	set_be32(h + 8, HEADER_SIZE + RSVMAP_SIZE);
+	set_be32(h + 12, w->size);
+	set_be32(h + 16, HEADER_SIZE);
+	set_be32(h + 20, 17);
+	set_be32(h + 24, 16);
+	set_be32(h + 32, w->stringslen);
+	set_be32(h + 36, struct_len);
+}
+
+/* -------------------------------------------------------- */
+
+/* The per-property path, as before the fixup transaction */
+
+static unsigned char *dt_struct(unsigned char *blob)
+{
+	return blob + be32(blob + 8);
+}
+
+static char *dt_strings(unsigned char *blob)
+{
+	return (char *)blob + be32(blob + 12);
+}
+
+static unsigned int token_next(unsigned char *blob, unsigned int offset,
+			       unsigned int *token)
+{
+	unsigned char *p = dt_struct(blob) + offset;
+
+	*token = be32(p);
+	if (*token == FDT_BEGIN_NODE)
+		return offset + 4 + OF_ALIGN(strlen((char *)p + 4) + 1);
+	if (*token == FDT_PROP)
+		return offset + 12 + OF_ALIGN(be32(p + 4));
+
+	return offset + 4;
+}
+
+static int node_match(const char *nodename, const char *name)
+{
+	unsigned int namelen = strlen(name);
+
+	return !memcmp(nodename, name, namelen)
+		&& ((nodename[namelen] == '\0') || (nodename[namelen] == '@'));
+}
+
+/* return the offset past the begin token of the first node matching */
+static int old_find_node(unsigned char *blob, const char *name)
+{
+	unsigned int offset = 0;
+	unsigned int next, token;
+
+	for (;; offset = next) {
+		next = token_next(blob, offset, &token);
+		if (token == FDT_END)
+			return -1;
+		if ((token == FDT_BEGIN_NODE)
+		    && node_match((char *)dt_struct(blob) + offset + 4, name))
+			return next;
+	}
+}
+
+static void old_splice(unsigned char *blob, unsigned int offset,
+		       unsigned int oldlen, unsigned int newlen)
+{
+	unsigned char *point = dt_struct(blob) + offset;
+	unsigned int end = be32(blob + 12) + be32(blob + 32);
+	int delta = newlen - oldlen;
+
+	memmove(point + newlen, point + oldlen,
+		blob + end - point - oldlen);
+	set_be32(blob + 36, be32(blob + 36) + delta);
+	set_be32(blob + 12, be32(blob + 12) + delta);
+}
+
+static int old_set_prop(unsigned char *blob, const char *node,
+			const char *name, const void *value, unsigned int len)
+{
+	unsigned int offset, next, token;
+	unsigned int oldlen = 0;
+	unsigned int nameoff, stringslen;
+	unsigned char *p;
+	int node_offset;
+
+	node_offset = old_find_node(blob, node);
+	if (node_offset < 0)
+		return -1;
+
+	for (offset = node_offset;; offset = next) {
+		next = token_next(blob, offset, &token);
+		if (token == FDT_NOP)
+			continue;
+		if (token != FDT_PROP)
+			break;
+		p = dt_struct(blob) + offset;
+		if (!strcmp(dt_strings(blob) + be32(p + 8), name)) {
+			oldlen = next - offset;
+			break;
+		}
+	}
+	if (!oldlen)
+		offset = node_offset;
+
+	stringslen = be32(blob + 32);
+	for (nameoff = 0; nameoff < stringslen;
+	     nameoff += strlen(dt_strings(blob) + nameoff) + 1)
+		if (!strcmp(dt_strings(blob) + nameoff, name))
+			break;
+	if (nameoff >= stringslen) {
+		strcpy(dt_strings(blob) + stringslen, name);
+		set_be32(blob + 32, stringslen + strlen(name) + 1);
+	}
+
+	old_splice(blob, offset, oldlen, 12 + OF_ALIGN(len));
+	p = dt_struct(blob) + offset;
+	set_be32(p, FDT_PROP);
+	set_be32(p + 4, len);
+	set_be32(p + 8, nameoff);
+	memset(p + 12, 0, OF_ALIGN(len));
+	memcpy(p + 12, value, len);
+
+	return 0;
+}
+
+static int old_apply(unsigned char *blob, struct of_fixups *fixups)
+{
+	struct of_fixup *fixup;
+	unsigned int i, size;
+
+	for (i = 0; i < fixups->count; i++) {
+		fixup = &fixups->fixup[i];
+		if (old_set_prop(blob, fixup->node, fixup->property,
+				 fixup->value, fixup->len))
+			return -1;
+	}
+
+	size = be32(blob + 12) + be32(blob + 32);
+	if (size > be32(blob + 4))
+		set_be32(blob + 4, size);
+
+	return 0;
+}
+
+/* -------------------------------------------------------- */
+
+/*
+ * The trees are the same if they have the same nodes in the same order,
+ * and each node the same properties with the same values, in any order.
+ */
+
+static int node_props(unsigned char *blob, unsigned int offset,
+		      unsigned int *props, unsigned int max)
+{
+	unsigned int next, token;
+	unsigned int count = 0;
+
+	for (;; offset = next) {
+		next = token_next(blob, offset, &token);
+		if (token == FDT_NOP)
+			continue;
+		if ((token != FDT_PROP) || (count == max))
+			return count;
+		props[count++] = offset;
+	}
+}
+
+static int same_nodes(unsigned char *a, unsigned char *b)
+{
+	unsigned int pa[64], pb[64];
+	unsigned int oa = 0, ob = 0;
+	unsigned int next_a, next_b;
+	unsigned int ta, tb;
+	unsigned int na, nb, i, j;
+	unsigned char *p, *q;
+
+	for (;; oa = next_a, ob = next_b) {
+		next_a = token_next(a, oa, &ta);
+		next_b = token_next(b, ob, &tb);
+		if (ta != tb)
+			return 0;
+		if (ta == FDT_END)
+			return 1;
+		if (ta != FDT_BEGIN_NODE)
+			continue;
+
+		if (strcmp((char *)dt_struct(a) + oa + 4,
+			   (char *)dt_struct(b) + ob + 4))
+			return 0;
+
+		na = node_props(a, next_a, pa, 64);
+		nb = node_props(b, next_b, pb, 64);
+		if (na != nb)
+			return 0;
+
+		for (i = 0; i < na; i++) {
+			p = dt_struct(a) + pa[i];
+			for (j = 0; j < nb; j++) {
+				q = dt_struct(b) + pb[j];
+				if (!strcmp(dt_strings(a) + be32(p + 8),
+					    dt_strings(b) + be32(q + 8)))
+					break;
+			}
+			if ((j == nb) || (be32(p + 4) != be32(q + 4))
+			    || memcmp(p + 12, q + 12, be32(p + 4)))
+				return 0;
+		}
+	}
+}
+
+/* and the same sizes, the dt strings laid out alike */
+static int same_tree(unsigned char *a, unsigned char *b)
+{
+	if ((be32(a + 4) != be32(b + 4)) || (be32(a + 36) != be32(b + 36)))
+		return 0;
+
+	return same_nodes(a, b);
+}
+
+/* -------------------------------------------------------- */
+
+static unsigned char *blob_new, *blob_old;
+
+static void check_fixups(const char *what, unsigned char *blob,
+			 struct of_fixups *fixups)
+{
+	unsigned int size = be32(blob + 4);
+	int ret_new, ret_old;
+
+	memcpy(blob_new, blob, size);
+	memset(blob_new + size, 0, BLOB_SIZE - size);
+	memcpy(blob_old, blob_new, BLOB_SIZE);
+
+	ret_new = of_fixups_apply(blob_new, fixups);
+	ret_old = old_apply(blob_old, fixups);
+
+	if (ret_new != ret_old) {
+		printf("FAIL %s: returned %d, expected %d\n",
+		       what, ret_new, ret_old);
+		fails++;
+	} else if (!ret_new && !same_tree(blob_new, blob_old)) {
+		printf("FAIL %s: trees differ\n", what);
+		fails++;
+	}
+}
+
+static const char measurements[] = "0123456789abcdef0123456789abcdef";
+
+static void boot_fixups(struct of_fixups *fixups, const char *bootargs)
+{
+	static unsigned int reg[2];
+	static unsigned int revision, boot_time;
+
+	set_be32(&reg[0], 0x20000000);
+	set_be32(&reg[1], 0x08000000);
+	set_be32(&revision, 0x00000421);
+	set_be32(&boot_time, 1234567);
+
+	of_fixups_init(fixups);
+	of_fixup_add(fixups, "chosen", "bootargs",
+		     bootargs, strlen(bootargs) + 1);
+	of_fixup_add(fixups, "memory",
+		     "device_type", "memory", sizeof("memory"));
+	of_fixup_add(fixups, "memory", "reg", reg, sizeof(reg));
+	of_fixup_add(fixups, "", "serial-number",
+		     "0123456789abcdef", sizeof("0123456789abcdef"));
+	of_fixup_add(fixups, "chosen", "at91bootstrap,board-revision",
+		     &revision, sizeof(revision));
+	of_fixup_add(fixups, "chosen", "at91bootstrap,boot-time-us",
+		     &boot_time, sizeof(boot_time));
+	of_fixup_add(fixups, "chosen", "at91bootstrap,measurements",
+		     measurements, sizeof(measurements));
+}
+
+/* A board: some buses of peripherals, with or without bootargs */
+static void build_board(struct writer *w, unsigned char *blob,
+			unsigned int peripherals, int with_bootargs)
+{
+	char name[32];
+	unsigned int i;
+
+	w_begin(w, blob);
+	w_node(w, "");
+	w_prop_str(w, "model", "Microchip SAMA5D2 Xplained");
+	w_prop_str(w, "compatible", "atmel,sama5d2-xplained");
+	w_prop_cells(w, "#address-cells", 1, 1);
+
+	w_node(w, "chosen");
+	if (with_bootargs)
+		w_prop_str(w, "bootargs", "console=ttyS0,115200 root=/dev/mmcblk0p2 rw rootwait");
+	w_prop_str(w, "stdout-path", "serial0:115200n8");
+	w_end(w);
+
+	w_node(w, "cpus");
+	w_node(w, "cpu@0");
+	w_prop_str(w, "compatible", "arm,cortex-a5");
+	w_prop_cells(w, "reg", 0, 0);
+	w_end(w);
+	w_end(w);
+
+	w_node(w, "memory@20000000");
+	w_prop_cells(w, "reg", 0x20000000, 0x04000000);
+	w_end(w);
+
+	w_node(w, "ahb");
+	w_prop_str(w, "compatible", "simple-bus");
+	for (i = 0; i < peripherals; i++) {
+		sprintf(name, "peripheral@f80%05x", i * 0x400);
+		w_node(w, name);
+		w_prop_str(w, "compatible", "atmel,at91sam9260-usart");
+		w_prop_cells(w, "reg", 0xf8000000 + i * 0x400, 0x100);
+		w_prop_cells(w, "interrupts", 24 + i, 4);
+		w_prop_str(w, "status", (i & 1) ? "okay" : "disabled");
+		w_end(w);
+	}
+	w_end(w);
+
+	w_end(w);
+	w_finish(w);
+}
+
+static void check_boards(unsigned char *blob)
+{
+	struct of_fixups fixups;
+	struct writer w;
+
+	build_board(&w, blob, 8, 1);
+	boot_fixups(&fixups, "console=ttyS0,115200");
+	check_fixups("board, shorter bootargs", blob, &fixups);
+	boot_fixups(&fixups, "console=ttyS0,115200 mtdparts=atmel_nand:256k(bootstrap)ro,768k(uboot)ro,256k(env),-(rootfs) root=ubi0:rootfs rw");
+	check_fixups("board, longer bootargs", blob, &fixups);
+
+	build_board(&w, blob, 8, 0);
+	boot_fixups(&fixups, "console=ttyS0,115200");
+	check_fixups("board, no bootargs", blob, &fixups);
+
+	/* the same property set twice keeps the last value */
+	of_fixup_add(&fixups, "chosen", "bootargs", "quiet", sizeof("quiet"));
+	check_fixups("board, bootargs set twice", blob, &fixups);
+
+	of_fixups_init(&fixups);
+	of_fixup_add(&fixups, "aliases", "serial0", "/ahb", sizeof("/ahb"));
+	check_fixups("board, missing node", blob, &fixups);
+}
+
+static void check_overflow(void)
+{
+	struct of_fixups fixups;
+	char names[OF_MAX_FIXUPS + 1][8];
+	unsigned int i;
+	int ret = 0;
+
+	of_fixups_init(&fixups);
+	for (i = 0; i < OF_MAX_FIXUPS; i++) {
+		sprintf(names[i], "prop%u", i);
+		ret |= of_fixup_add(&fixups, "chosen", names[i], "", 1);
+	}
+	if (ret || of_fixup_add(&fixups, "chosen", names[0], "x", 2)) {
+		printf("FAIL overflow: a full set refused a fixup\n");
+		fails++;
+	}
+
+	sprintf(names[i], "prop%u", i);
+	if (!of_fixup_add(&fixups, "chosen", names[i], "", 1)) {
+		printf("FAIL overflow: a fixup past %d accepted\n",
+		       OF_MAX_FIXUPS);
+		fails++;
+	}
+}
+
+/* -------------------------------------------------------- */
+
+static const char *random_names[] = {
+	"compatible", "reg", "status", "bootargs", "interrupts",
+	"clocks", "linux,phandle", "x", "reg-names", "a-new-property",
+};
+
+static const char *random_nodes[] = {
+	"", "chosen", "memory", "soc", "serial", "clock", "gpio", "absent",
+};
+
+static void random_value(unsigned char *value, unsigned int len)
+{
+	unsigned int i;
+
+	for (i = 0; i < len; i++)
+		value[i] = rand();
+}
+
+static void random_node(struct writer *w, unsigned int depth)
+{
+	unsigned char value[64];
+	unsigned int i, count, first;
+
+	/* distinct names, a node has a property of each name at most */
+	count = rand() % 4;
+	first = rand();
+	for (i = 0; i < count; i++) {
+		random_value(value, sizeof(value));
+		w_prop(w, random_names[(first + i) % ARRAY_SIZE(random_names)],
+		       value, rand() % sizeof(value));
+	}
+
+	count = depth ? rand() % 4 : 0;
+	for (i = 0; i < count; i++) {
+		w_node(w, random_nodes[1 + rand() % (ARRAY_SIZE(random_nodes) - 2)]);
+		random_node(w, depth - 1);
+		w_end(w);
+	}
+}
+
+static void check_random(unsigned char *blob)
+{
+	static unsigned char values[OF_MAX_FIXUPS][80];
+	struct of_fixups fixups;
+	struct writer w;
+	unsigned int round, i, count;
+	char what[32];
+
+	srand(1);
+	for (round = 0; round < RANDOM_ROUNDS; round++) {
+		w_begin(&w, blob);
+		w_node(&w, "");
+		random_node(&w, 3);
+		w_end(&w);
+		w_finish(&w);
+
+		of_fixups_init(&fixups);
+		count = 1 + rand() % OF_MAX_FIXUPS;
+		for (i = 0; i < count; i++) {
+			random_value(values[i], sizeof(values[i]));
+			of_fixup_add(&fixups,
+				random_nodes[rand() % ARRAY_SIZE(random_nodes)],
+				random_names[rand() % ARRAY_SIZE(random_names)],
+				values[i], rand() % sizeof(values[i]));
+		}
+
+		sprintf(what, "random %u", round);
+		check_fixups(what, blob, &fixups);
+	}
+}
+
+/* -------------------------------------------------------- */
+
+/*
+ * Overlays: the base has labels for a peripheral and a clock, phandles 1
+ * and 2. The overlay enables the peripheral by its label, adds a device
+ * with phandle 1 of its own, referencing the clock by its label and
+ * itself by its phandle, and sets the bootargs by path.
+ */
+
+enum overlay_case {
+	OVERLAY_GOOD,
+	OVERLAY_BOARD_ID,
+	OVERLAY_NO_LABEL,
+	OVERLAY_NO_TARGET,
+	OVERLAY_TARGET_PATH_UNTERMINATED,
+	OVERLAY_FIXUP_UNTERMINATED,
+	OVERLAY_FIXUP_SYNTAX,
+	OVERLAY_FIXUP_RANGE,
+	OVERLAY_FIXUP_UNALIGNED,
+	OVERLAY_LOCAL_FIXUP_RANGE,
+	OVERLAY_LOCAL_FIXUP_NO_NODE,
+	OVERLAY_TOO_DEEP,
+};
+
+static const char *overlay_cases[] = {
+	"good", "board id", "missing label", "missing target",
+	"unterminated target-path", "unterminated fixup", "fixup syntax",
+	"fixup past its property", "unaligned fixup",
+	"local fixup past its property", "local fixup of a missing node",
+	"too deep",
+};
+
+static void build_base(struct writer *w, unsigned char *blob)
+{
+	w_begin(w, blob);
+	w_node(w, "");
+	w_prop_str(w, "compatible", "atmel,sama5d2");
+
+	w_node(w, "chosen");
+	w_prop_str(w, "bootargs", "console=ttyS0,115200");
+	w_end(w);
+
+	w_node(w, "clk");
+	w_prop_cell(w, "phandle", 2);
+	w_end(w);
+
+	w_node(w, "ahb");
+	w_node(w, "peripheral@f8000000");
+	w_prop_str(w, "status", "disabled");
+	w_prop_cell(w, "phandle", 1);
+	w_end(w);
+	w_end(w);
+
+	w_node(w, "__symbols__");
+	w_prop_str(w, "uart0", "/ahb/peripheral@f8000000");
+	w_prop_str(w, "clk", "/clk");
+	w_end(w);
+
+	w_end(w);
+	w_finish(w);
+}
+
+/* the base with the good overlay applied */
+static void build_expected(struct writer *w, unsigned char *blob)
+{
+	w_begin(w, blob);
+	w_node(w, "");
+	w_prop_str(w, "compatible", "atmel,sama5d2");
+
+	w_node(w, "chosen");
+	w_prop_str(w, "bootargs", "console=ttyS1,115200 quiet");
+	w_end(w);
+
+	w_node(w, "clk");
+	w_prop_cell(w, "phandle", 2);
+	w_end(w);
+
+	w_node(w, "ahb");
+	w_node(w, "peripheral@f8000000");
+	w_prop_str(w, "status", "okay");
+	w_prop_cell(w, "phandle", 1);
+	w_prop_str(w, "label", "console");
+	w_node(w, "dev");
+	w_prop_cell(w, "phandle", 3);
+	w_prop_cells(w, "clocks", 2, 3);
+	w_prop_cell(w, "link", 3);
+	w_end(w);
+	w_end(w);
+	w_end(w);
+
+	w_node(w, "__symbols__");
+	w_prop_str(w, "uart0", "/ahb/peripheral@f8000000");
+	w_prop_str(w, "clk", "/clk");
+	w_end(w);
+
+	w_end(w);
+	w_finish(w);
+}
+
+static void build_overlay(struct writer *w, unsigned char *blob,
+			  enum overlay_case c)
+{
+	unsigned int i;
+
+	w_begin(w, blob);
+	w_node(w, "");
+	if (c == OVERLAY_BOARD_ID)
+		w_prop_str(w, "board-id", "ek21-a");
+
+	w_node(w, "fragment@0");
+	w_prop_cell(w, "target", 0xffffffff);
+	w_node(w, "__overlay__");
+	w_prop_str(w, "status", "okay");
+	w_prop_str(w, "label", "console");
+	w_node(w, "dev");
+	w_prop_cell(w, "phandle", 1);
+	w_prop_cells(w, "clocks", 0xffffffff, 3);
+	w_prop_cell(w, "link", 1);
+	for (i = 0; (c == OVERLAY_TOO_DEEP) && (i < 16); i++)
+		w_node(w, "deeper");
+	for (i = 0; (c == OVERLAY_TOO_DEEP) && (i < 16); i++)
+		w_end(w);
+	w_end(w);
+	w_end(w);
+	w_end(w);
+
+	w_node(w, "fragment@1");
+	if (c == OVERLAY_NO_TARGET)
+		w_prop_str(w, "target-path", "/absent");
+	else if (c == OVERLAY_TARGET_PATH_UNTERMINATED)
+		w_prop(w, "target-path", "/chosen", 7);
+	else
+		w_prop_str(w, "target-path", "/chosen");
+	w_node(w, "__overlay__");
+	w_prop_str(w, "bootargs", "console=ttyS1,115200 quiet");
+	w_end(w);
+	w_end(w);
+
+	w_node(w, "__fixups__");
+	w_prop_str(w, (c == OVERLAY_NO_LABEL) ? "uart1" : "uart0",
+		   "/fragment@0:target:0");
+	if (c == OVERLAY_FIXUP_UNTERMINATED)
+		w_prop(w, "clk", "/fragment@0/__overlay__/dev:clocks:0", 36);
+	else if (c == OVERLAY_FIXUP_SYNTAX)
+		w_prop_str(w, "clk", "/fragment@0/__overlay__/dev:clocks");
+	else if (c == OVERLAY_FIXUP_RANGE)
+		w_prop_str(w, "clk", "/fragment@0/__overlay__/dev:clocks:8");
+	else if (c == OVERLAY_FIXUP_UNALIGNED)
+		w_prop_str(w, "clk", "/fragment@0/__overlay__/dev:clocks:2");
+	else
+		w_prop_str(w, "clk", "/fragment@0/__overlay__/dev:clocks:0");
+	w_end(w);
+
+	w_node(w, "__local_fixups__");
+	w_node(w, "fragment@0");
+	w_node(w, "__overlay__");
+	w_node(w, (c == OVERLAY_LOCAL_FIXUP_NO_NODE) ? "absent" : "dev");
+	w_prop_cell(w, "link", (c == OVERLAY_LOCAL_FIXUP_RANGE) ? 4 : 0);
+	w_end(w);
+	w_end(w);
+	w_end(w);
+	w_end(w);
+
+	w_end(w);
+	w_finish(w);
+}
+
+/* a blob placed right before a page which cannot be accessed */
+static unsigned char *guarded_alloc(void)
+{
+	unsigned char *blob = blob_alloc();
+
+	if (mprotect(blob + BLOB_SIZE - 4096, 4096, PROT_NONE)) {
+		printf("cannot protect the guard page\n");
+		exit(1);
+	}
+
+	return blob + BLOB_SIZE - 4096;
+}
+
+static unsigned char *guarded_copy(unsigned char *guard,
+				   unsigned char *blob, unsigned int room)
+{
+	unsigned char *dest = guard - OF_ALIGN(room);
+
+	memset(dest, 0, OF_ALIGN(room));
+	memcpy(dest, blob, be32(blob + 4));
+
+	return dest;
+}
+
+static unsigned char *base_guard, *overlay_guard;
+static unsigned char *overlay_blob, *base_blob;
+
+/* apply an overlay on a copy of the base, which may grow by BASE_ROOM */
+static int apply_overlay(unsigned char *overlay, unsigned int size,
+			 unsigned char **base)
+{
+	unsigned char *ov;
+	int ret;
+
+	*base = guarded_copy(base_guard, base_blob, BASE_ROOM);
+	ov = guarded_copy(overlay_guard, overlay, size);
+	ret = of_overlay_apply(*base, BASE_ROOM, ov);
+
+	if ((ret != 0) && (ret != -1)) {
+		printf("FAIL overlay: returned %d\n", ret);
+		fails++;
+	} else if (be32(*base + 12) + be32(*base + 32) > BASE_ROOM) {
+		printf("FAIL overlay: the base grew past its room\n");
+		fails++;
+	}
+
+	return ret;
+}
+
+static void check_bad_overlay(const char *what, unsigned char *overlay)
+{
+	unsigned char *base;
+
+	if (!apply_overlay(overlay, be32(overlay + 4), &base)) {
+		printf("FAIL overlay, %s: applied\n", what);
+		fails++;
+	}
+}
+
+/* a blob which is not well formed is not even matched */
+static void check_malformed(const char *what, unsigned char *overlay)
+{
+	unsigned char *ov;
+
+	ov = guarded_copy(overlay_guard, overlay, be32(overlay + 4));
+	if (of_overlay_match(ov, NULL)) {
+		printf("FAIL overlay, %s: matched\n", what);
+		fails++;
+	}
+	check_bad_overlay(what, overlay);
+}
+
+/* the offset in the dt struct of the n-th token of a type */
+static unsigned int find_token(unsigned char *blob, unsigned int type,
+			       unsigned int n)
+{
+	unsigned int offset = 0;
+	unsigned int next, token;
+
+	for (;; offset = next) {
+		next = token_next(blob, offset, &token);
+		if ((token == type) && !n--)
+			return offset;
+	}
+}
+
+static void check_malformed_blobs(unsigned char *overlay)
+{
+	unsigned char *bad = blob_new;
+	unsigned int size = be32(overlay + 4);
+	unsigned int offset;
+
+#define MALFORMED(what, edit)				\
+	do {						\
+		memcpy(bad, overlay, size);		\
+		edit;					\
+		check_malformed(what, bad);		\
+	} while (0)
+
+	MALFORMED("truncated header", set_be32(bad + 4, 32));
+	MALFORMED("truncated dt struct", set_be32(bad + 4, be32(bad + 8) + 16));
+	MALFORMED("truncated dt strings", set_be32(bad + 4, size - 1));
+	MALFORMED("dt struct past the blob", set_be32(bad + 36, size));
+	MALFORMED("unaligned dt struct", set_be32(bad + 8, be32(bad + 8) + 2));
+	MALFORMED("dt strings past the blob", set_be32(bad + 32, size));
+	MALFORMED("unterminated dt strings", bad[size - 1] = 'x');
+
+	offset = find_token(overlay, FDT_PROP, 0);
+	MALFORMED("property name past the dt strings",
+		  set_be32(dt_struct(bad) + offset + 8, be32(bad + 32)));
+	MALFORMED("property past the dt struct",
+		  set_be32(dt_struct(bad) + offset + 4, 0xfffffff0));
+	MALFORMED("property of a huge length",
+		  set_be32(dt_struct(bad) + offset + 4, 0xffffffff));
+
+	offset = find_token(overlay, FDT_BEGIN_NODE, 1);
+	MALFORMED("unterminated node name",
+		  memset(dt_struct(bad) + offset + 4, 'x',
+			 be32(bad + 36) - offset - 4));
+
+	offset = find_token(overlay, FDT_END, 0);
+	MALFORMED("no end token",
+		  set_be32(dt_struct(bad) + offset, FDT_NOP));
+	MALFORMED("unbalanced nodes",
+		  set_be32(dt_struct(bad) + offset - 4, FDT_NOP));
+	MALFORMED("unknown token",
+		  set_be32(dt_struct(bad) + offset - 4, 7));
+	MALFORMED("property outside the nodes",
+		  set_be32(dt_struct(bad), FDT_PROP));
+
+#undef MALFORMED
+}
+
+static unsigned int max_phandle(unsigned char *blob)
+{
+	unsigned int offset = 0;
+	unsigned int next, token;
+	unsigned int max = 0;
+	unsigned char *p;
+
+	for (;; offset = next) {
+		next = token_next(blob, offset, &token);
+		if (token == FDT_END)
+			return max;
+
+		p = dt_struct(blob) + offset;
+		if ((token == FDT_PROP)
+		    && !strcmp(dt_strings(blob) + be32(p + 8), "phandle")
+		    && (be32(p + 12) > max))
+			max = be32(p + 12);
+	}
+}
+
+static void check_overlays(unsigned char *blob)
+{
+	unsigned char *expected = blob_old;
+	unsigned char *base, *ov;
+	struct writer w;
+	unsigned int c;
+
+	base_guard = guarded_alloc();
+	overlay_guard = guarded_alloc();
+	base_blob = blob_alloc();
+	overlay_blob = blob;
+
+	build_base(&w, base_blob);
+	build_expected(&w, expected);
+
+	build_overlay(&w, overlay_blob, OVERLAY_GOOD);
+	if (apply_overlay(overlay_blob, be32(overlay_blob + 4), &base)
+	    || !same_nodes(base, expected)) {
+		printf("FAIL overlay, good: trees differ\n");
+		fails++;
+	}
+
+	/* applied again, the device is merged with phandle 4 */
+	ov = guarded_copy(overlay_guard, overlay_blob, be32(overlay_blob + 4));
+	if (of_overlay_apply(base, BASE_ROOM, ov) || (max_phandle(base) != 4)) {
+		printf("FAIL overlay, applied twice: phandles not renumbered\n");
+		fails++;
+	}
+
+	ov = guarded_copy(overlay_guard, overlay_blob, be32(overlay_blob + 4));
+	if (!of_overlay_match(ov, NULL) || !of_overlay_match(ov, "ek21-a")) {
+		printf("FAIL overlay, no board id: not matched\n");
+		fails++;
+	}
+
+	build_overlay(&w, overlay_blob, OVERLAY_BOARD_ID);
+	ov = guarded_copy(overlay_guard, overlay_blob, be32(overlay_blob + 4));
+	if (!of_overlay_match(ov, "ek21-a") || of_overlay_match(ov, "ek21-b")
+	    || of_overlay_match(ov, "ek21-") || of_overlay_match(ov, NULL)) {
+		printf("FAIL overlay, board id: wrong match\n");
+		fails++;
+	}
+
+	for (c = OVERLAY_NO_LABEL; c < ARRAY_SIZE(overlay_cases); c++) {
+		build_overlay(&w, overlay_blob, c);
+		check_bad_overlay(overlay_cases[c], overlay_blob);
+	}
+
+	build_overlay(&w, overlay_blob, OVERLAY_GOOD);
+	check_malformed_blobs(overlay_blob);
+}
+
+/*
+ * Flip random bytes of the good overlay: whatever the result, the overlay
+ * is only read within its size, and the base only written within its own.
+ * A total size past the blob is left to the loaders, which check it.
+ */
+static void check_overlay_fuzz(void)
+{
+	unsigned char *fuzz = blob_new;
+	unsigned char *base;
+	struct writer w;
+	unsigned int size, round, i, count;
+	unsigned int applied = 0;
+
+	build_overlay(&w, overlay_blob, OVERLAY_GOOD);
+	size = be32(overlay_blob + 4);
+
+	srand(2);
+	for (round = 0; round < FUZZ_ROUNDS; round++) {
+		memcpy(fuzz, overlay_blob, size);
+		count = 1 + rand() % 4;
+		for (i = 0; i < count; i++)
+			fuzz[rand() % size] ^= 1 << (rand() % 8);
+		if (be32(fuzz + 4) > size)
+			continue;
+
+		if (!apply_overlay(fuzz, size, &base))
+			applied++;
+	}
+
+	if (!applied) {
+		printf("FAIL overlay fuzz: nothing applied\n");
+		fails++;
+	}
+}
+
+static void check_file(const char *path, unsigned char *blob)
+{
+	struct of_fixups fixups;
+	FILE *f;
+	size_t size;
+
+	f = fopen(path, "rb");
+	if (!f) {
+		printf("FAIL %s: cannot open\n", path);
+		fails++;
+		return;
+	}
+	size = fread(blob, 1, BLOB_SIZE / 2, f);
+	fclose(f);
+
+	if ((size < HEADER_SIZE) || check_dt_blob_valid(blob)
+	    || (be32(blob + 4) > size)) {
+		printf("FAIL %s: not a device tree blob\n", path);
+		fails++;
+		return;
+	}
+
+	boot_fixups(&fixups, "console=ttyS0,115200 root=/dev/mmcblk0p2 rw");
+	check_fixups(path, blob, &fixups);
+}
+
+/* -------------------------------------------------------- */
+
+static double elapsed(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (now.tv_sec - start->tv_sec)
+		+ (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void bench(unsigned char *blob)
+{
+	struct of_fixups fixups;
+	struct timespec start;
+	struct writer w;
+	unsigned int size, i;
+	double t_new, t_old;
+
+	build_board(&w, blob, 200, 0);
+	size = be32(blob + 4);
+	boot_fixups(&fixups, "console=ttyS0,115200 root=/dev/mmcblk0p2 rw");
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < BENCH_ROUNDS; i++) {
+		memcpy(blob_new, blob, size);
+		of_fixups_apply(blob_new, &fixups);
+	}
+	t_new = elapsed(&start);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < BENCH_ROUNDS; i++) {
+		memcpy(blob_old, blob, size);
+		old_apply(blob_old, &fixups);
+	}
+	t_old = elapsed(&start);
+
+	printf("fdt: %u byte blob, %u fixups: %.1f us per property, "
+	       "%.1f us batched\n", size, fixups.count,
+	       t_old * 1e6 / BENCH_ROUNDS, t_new * 1e6 / BENCH_ROUNDS);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned char *blob;
+	int i;
+
+	blob = blob_alloc();
+	blob_new = blob_alloc();
+	blob_old = blob_alloc();
+
+	check_boards(blob);
+	check_overflow();
+	check_random(blob);
+	check_overlays(blob);
+	check_overlay_fuzz();
+	for (i = 1; i < argc; i++)
+		check_file(argv[i], blob);
+
+	if (fails) {
+		printf("fdt: %d failures\n", fails);
+		return 1;
+	}
+	printf("fdt: all checks passed\n");
+
+	bench(blob);
+
+	return 0;
+}
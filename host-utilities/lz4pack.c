@@ -0,0 +1,319 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+/*
+ * Pack the bootstrap binary behind the LZ4 inflate stub (lz4_stub.S).
+ *
+ * lz4pack -s stub.bin -i bootstrap.bin -o packed.bin -l link -t top
+ *
+ * The bootstrap is compressed as a raw LZ4 block, then inflated back the
+ * way the stub does and compared, and the layout the stub uses at run
+ * time is checked against the SRAM from the link address to the top.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MINMATCH	4
+#define LASTLITERALS	5	/* the block ends with literals */
+#define MFLIMIT		12	/* no match starts closer to the end */
+#define MAX_DISTANCE	65535
+#define HASH_LOG	16
+#define MAX_CHAIN	256
+
+#define STUB_MAGIC	"LZ4I"
+#define STUB_HEADER	12	/* magic, inflated size, packed size */
+#define STUB_SIZE_WORD	0x14	/* vector 6, read by the ROM code */
+#define COPY_ALIGN	16	/* the stub moves itself by 16 bytes */
+#define RELOC_ALIGN	32
+
+static const char *prog;
+
+static void die(const char *fmt, const char *arg)
+{
+	fprintf(stderr, "%s: ", prog);
+	fprintf(stderr, fmt, arg);
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+static unsigned char *read_file(const char *name, unsigned int *size)
+{
+	unsigned char *buf;
+	FILE *f;
+	long len;
+
+	f = fopen(name, "rb");
+	if (!f)
+		die("cannot open %s", name);
+	if (fseek(f, 0, SEEK_END) || (len = ftell(f)) < 0 ||
+	    fseek(f, 0, SEEK_SET))
+		die("cannot read %s", name);
+
+	buf = malloc(len + 1);
+	if (!buf || fread(buf, 1, len, f) != (size_t)len)
+		die("cannot read %s", name);
+	fclose(f);
+
+	*size = len;
+	return buf;
+}
+
+static void put_le32(unsigned char *p, unsigned int val)
+{
+	p[0] = val;
+	p[1] = val >> 8;
+	p[2] = val >> 16;
+	p[3] = val >> 24;
+}
+
+static unsigned int get_le32(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static unsigned int hash4(const unsigned char *p)
+{
+	return (get_le32(p) * 2654435761U) >> (32 - HASH_LOG);
+}
+
+static unsigned char *put_length(unsigned char *op, unsigned int len)
+{
+	while (len >= 255) {
+		*op++ = 255;
+		len -= 255;
+	}
+	*op++ = len;
+
+	return op;
+}
+
+static unsigned char *put_sequence(unsigned char *op,
+				   const unsigned char *lit,
+				   unsigned int lit_len,
+				   unsigned int offset,
+				   unsigned int match_len)
+{
+	unsigned char *token = op++;
+
+	*token = (lit_len < 15 ? lit_len : 15) << 4;
+	if (lit_len >= 15)
+		op = put_length(op, lit_len - 15);
+	memcpy(op, lit, lit_len);
+	op += lit_len;
+
+	if (!match_len)
+		return op;
+
+	*op++ = offset;
+	*op++ = offset >> 8;
+	match_len -= MINMATCH;
+	*token |= match_len < 15 ? match_len : 15;
+	if (match_len >= 15)
+		op = put_length(op, match_len - 15);
+
+	return op;
+}
+
+/* Greedy parse, longest match over a bounded hash chain */
+static unsigned int lz4_compress(const unsigned char *src, unsigned int size,
+				 unsigned char *dst)
+{
+	unsigned char *op = dst;
+	unsigned int anchor = 0, pos = 0;
+	int *head, *prev;
+	unsigned int i;
+
+	head = malloc(sizeof(int) << HASH_LOG);
+	prev = malloc(sizeof(int) * (size + 1));
+	if (!head || !prev)
+		die("%s", strerror(ENOMEM));
+	for (i = 0; i < (1 << HASH_LOG); i++)
+		head[i] = -1;
+
+	while (size >= MFLIMIT && pos <= size - MFLIMIT) {
+		unsigned int h = hash4(src + pos);
+		unsigned int limit = size - LASTLITERALS - pos;
+		unsigned int best_len = 0, best_pos = 0;
+		unsigned int depth = MAX_CHAIN;
+		int cand;
+
+		for (cand = head[h]; cand >= 0 && depth--; cand = prev[cand]) {
+			unsigned int len = 0;
+
+			if (pos - cand > MAX_DISTANCE)
+				break;
+			while (len < limit && src[cand + len] == src[pos + len])
+				len++;
+			if (len > best_len) {
+				best_len = len;
+				best_pos = cand;
+			}
+		}
+
+		if (best_len < MINMATCH) {
+			prev[pos] = head[h];
+			head[h] = pos++;
+			continue;
+		}
+
+		op = put_sequence(op, src + anchor, pos - anchor,
+				  pos - best_pos, best_len);
+
+		for (i = pos + best_len; pos < i; pos++) {
+			h = hash4(src + pos);
+			prev[pos] = head[h];
+			head[h] = pos;
+		}
+		anchor = pos;
+	}
+
+	op = put_sequence(op, src + anchor, size - anchor, 0, 0);
+
+	free(head);
+	free(prev);
+
+	return op - dst;
+}
+
+/* Same walk as the stub, with the bounds it does not need to check */
+static int lz4_inflate(const unsigned char *src, unsigned int size,
+		       unsigned char *dst, unsigned int dst_size)
+{
+	const unsigned char *end = src + size;
+	unsigned char *op = dst;
+	unsigned int len, offset, token;
+
+	while (src < end) {
+		token = *src++;
+
+		len = token >> 4;
+		if (len == 15)
+			do {
+				if (src >= end)
+					return -1;
+				len += *src;
+			} while (*src++ == 255);
+		if (len > (unsigned int)(end - src) ||
+		    len > dst_size - (op - dst))
+			return -1;
+		memcpy(op, src, len);
+		op += len;
+		src += len;
+
+		if (src >= end)
+			break;
+
+		if (end - src < 2)
+			return -1;
+		offset = src[0] | (src[1] << 8);
+		src += 2;
+		if (!offset || offset > (unsigned int)(op - dst))
+			return -1;
+
+		len = token & 15;
+		if (len == 15)
+			do {
+				if (src >= end)
+					return -1;
+				len += *src;
+			} while (*src++ == 255);
+		len += MINMATCH;
+		if (len > dst_size - (op - dst))
+			return -1;
+		while (len--) {
+			*op = *(op - offset);
+			op++;
+		}
+	}
+
+	return op - dst;
+}
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: %s -s stub.bin -i image.bin -o packed.bin"
+		" -l link_addr -t top_of_memory\n", prog);
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *stub_name = NULL, *in_name = NULL, *out_name = NULL;
+	unsigned long link = 0, top = 0;
+	unsigned char *stub, *image, *packed, *check;
+	unsigned int stub_size, size, lz4_size, packed_size, reloc;
+	FILE *f;
+	int i;
+
+	prog = argv[0];
+	for (i = 1; i + 1 < argc; i += 2) {
+		if (!strcmp(argv[i], "-s"))
+			stub_name = argv[i + 1];
+		else if (!strcmp(argv[i], "-i"))
+			in_name = argv[i + 1];
+		else if (!strcmp(argv[i], "-o"))
+			out_name = argv[i + 1];
+		else if (!strcmp(argv[i], "-l"))
+			link = strtoul(argv[i + 1], NULL, 0);
+		else if (!strcmp(argv[i], "-t"))
+			top = strtoul(argv[i + 1], NULL, 0);
+		else
+			usage();
+	}
+	if (i != argc || !stub_name || !in_name || !out_name || top <= link)
+		usage();
+
+	stub = read_file(stub_name, &stub_size);
+	if (stub_size < STUB_SIZE_WORD + 4 + STUB_HEADER ||
+	    memcmp(stub + stub_size - STUB_HEADER, STUB_MAGIC, 4))
+		die("%s is not the LZ4 stub", stub_name);
+
+	image = read_file(in_name, &size);
+	if (!size)
+		die("%s is empty", in_name);
+
+	/* Worst case of the LZ4 block, plus the padding */
+	packed = calloc(1, stub_size + size + size / 255 + 16 + COPY_ALIGN);
+	check = malloc(size);
+	if (!packed || !check)
+		die("%s", strerror(ENOMEM));
+
+	memcpy(packed, stub, stub_size);
+	lz4_size = lz4_compress(image, size, packed + stub_size);
+	packed_size = (stub_size + lz4_size + COPY_ALIGN - 1) & ~(COPY_ALIGN - 1);
+
+	put_le32(packed + STUB_SIZE_WORD, packed_size);
+	put_le32(packed + stub_size - 8, size);
+	put_le32(packed + stub_size - 4, lz4_size);
+
+	if (lz4_inflate(packed + stub_size, lz4_size, check, size) != (int)size ||
+	    memcmp(check, image, size))
+		die("%s does not inflate back", in_name);
+
+	/* The stub and payload are moved above the inflated image */
+	reloc = (size + RELOC_ALIGN - 1) & ~(RELOC_ALIGN - 1);
+	if (reloc < packed_size)
+		die("%s does not compress", in_name);
+	if (link + reloc + packed_size > top)
+		die("%s: the packed image does not fit below the top of memory",
+		    in_name);
+
+	f = fopen(out_name, "wb");
+	if (!f || fwrite(packed, 1, packed_size, f) != packed_size ||
+	    fclose(f))
+		die("cannot write %s", out_name);
+
+	printf("  LZ4       %u -> %u bytes\n", size, packed_size);
+
+	free(stub);
+	free(image);
+	free(packed);
+	free(check);
+
+	return 0;
+}
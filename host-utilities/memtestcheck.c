@@ -0,0 +1,185 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+/*
+ * Check the pattern engine of lib/memtest.c on host memory: every pass
+ * must be clean on good memory, and must catch a corrupted word, or an
+ * address line shorted by mapping the same pages twice.
+ *
+ * Built and run on the host by "make memtest-check". The engine records
+ * the low 32 bits of the addresses, and so does this check.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "memtest.h"
+
+#define CHECK_WORDS	(64 * 1024)
+#define CHECK_SIZE	(CHECK_WORDS * 4)
+
+static int fails;
+
+static void expect(const char *what, const struct memtest_result *res,
+		   unsigned int errors, const volatile unsigned int *addr)
+{
+	if (res->errors != errors) {
+		printf("FAIL %s: %u errors, expected %u\n",
+		       what, res->errors, errors);
+		fails++;
+	} else if (errors && addr &&
+		   (res->first_addr != (unsigned int)(uintptr_t)addr)) {
+		printf("FAIL %s: first error at %08x, expected %08x\n", what,
+		       res->first_addr, (unsigned int)(uintptr_t)addr);
+		fails++;
+	}
+}
+
+static void check_patterns(unsigned int *mem)
+{
+	struct memtest_result res;
+	unsigned int bad = CHECK_WORDS / 3;
+
+	memset(&res, 0, sizeof(res));
+	memtest_fill(mem, CHECK_WORDS, 0xaaaaaaaa);
+	memtest_verify(mem, CHECK_WORDS, 0xaaaaaaaa, &res);
+	expect("fixed pattern", &res, 0, NULL);
+
+	mem[bad] ^= 0x100;
+	memtest_verify(mem, CHECK_WORDS, 0xaaaaaaaa, &res);
+	expect("fixed pattern, corrupted", &res, 1, &mem[bad]);
+	if (res.expected != 0xaaaaaaaa || res.actual != (0xaaaaaaaa ^ 0x100)) {
+		printf("FAIL fixed pattern: exp %08x got %08x\n",
+		       res.expected, res.actual);
+		fails++;
+	}
+}
+
+static void check_inversions(unsigned int *mem)
+{
+	struct memtest_result res;
+	unsigned int bad = CHECK_WORDS - 5;
+
+	memset(&res, 0, sizeof(res));
+	memtest_fill(mem, CHECK_WORDS, 0x55555555);
+	memtest_invert_up(mem, CHECK_WORDS, 0x55555555, &res);
+	memtest_invert_down(mem, CHECK_WORDS, 0xaaaaaaaa, &res);
+	memtest_verify(mem, CHECK_WORDS, 0x55555555, &res);
+	expect("moving inversions", &res, 0, NULL);
+
+	/* A bit stuck high seen on the way up, then down */
+	memtest_fill(mem, CHECK_WORDS, 0x55555555);
+	mem[bad] |= 0x80000000;
+	memtest_invert_up(mem, CHECK_WORDS, 0x55555555, &res);
+	expect("moving inversions, up", &res, 1, &mem[bad]);
+
+	memset(&res, 0, sizeof(res));
+	mem[1] = 0;
+	memtest_invert_down(mem, CHECK_WORDS, 0xaaaaaaaa, &res);
+	expect("moving inversions, down", &res, 1, &mem[1]);
+}
+
+static void check_addr_in_addr(unsigned int *mem)
+{
+	struct memtest_result res;
+	unsigned int bad = 12345;
+
+	memset(&res, 0, sizeof(res));
+	memtest_addr_fill(mem, CHECK_WORDS);
+	memtest_addr_invert(mem, CHECK_WORDS, &res);
+	memtest_addr_verify_inv(mem, CHECK_WORDS, &res);
+	expect("address in address", &res, 0, NULL);
+
+	memtest_addr_fill(mem, CHECK_WORDS);
+	mem[bad] = mem[bad + 1];
+	memtest_addr_invert(mem, CHECK_WORDS, &res);
+	expect("address in address, aliased", &res, 1, &mem[bad]);
+}
+
+static void check_walking_ones(unsigned int *mem)
+{
+	struct memtest_result res;
+
+	memset(&res, 0, sizeof(res));
+	memtest_walking_ones(mem, &res);
+	memtest_addr_lines(mem, CHECK_SIZE, &res);
+	expect("walking ones", &res, 0, NULL);
+}
+
+/*
+ * The upper half of the window maps the pages of the lower half: the top
+ * address line of the window is shorted low, which only the address line
+ * test can see.
+ */
+static void check_address_line(void)
+{
+	struct memtest_result res;
+	unsigned int *mem;
+	int fd;
+
+	fd = memfd_create("memtest", 0);
+	if ((fd < 0) || ftruncate(fd, CHECK_SIZE)) {
+		printf("no memfd, address line check skipped\n");
+		return;
+	}
+
+	mem = mmap(NULL, 2 * CHECK_SIZE, PROT_NONE,
+		   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if ((mem == MAP_FAILED) ||
+	    (mmap(mem, CHECK_SIZE, PROT_READ | PROT_WRITE,
+		  MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) ||
+	    (mmap(mem + CHECK_WORDS, CHECK_SIZE, PROT_READ | PROT_WRITE,
+		  MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)) {
+		printf("no aliased mapping, address line check skipped\n");
+		close(fd);
+		return;
+	}
+
+	memset(&res, 0, sizeof(res));
+	memtest_walking_ones(mem, &res);
+	memtest_fill(mem, CHECK_WORDS, 0);
+	memtest_verify(mem + CHECK_WORDS, CHECK_WORDS, 0, &res);
+	expect("shorted line, data", &res, 0, NULL);
+
+	memtest_addr_lines(mem, 2 * CHECK_SIZE, &res);
+	if (!res.errors) {
+		printf("FAIL shorted line: not detected\n");
+		fails++;
+	}
+
+	munmap(mem, 2 * CHECK_SIZE);
+	close(fd);
+}
+
+int main(void)
+{
+	unsigned int *mem;
+
+	mem = malloc(CHECK_SIZE);
+	if (!mem) {
+		printf("out of memory\n");
+		return 1;
+	}
+
+	check_patterns(mem);
+	check_inversions(mem);
+	check_addr_in_addr(mem);
+	check_walking_ones(mem);
+	check_address_line();
+
+	free(mem);
+
+	if (fails) {
+		printf("memtest: %d failures\n", fails);
+		return 1;
+	}
+	printf("memtest: all checks passed\n");
+
+	return 0;
+}
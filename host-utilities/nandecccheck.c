@@ -0,0 +1,94 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+/*
+ * Check the On-Die ECC status decode of driver/nand_ondie_ecc.c against
+ * every combination of the status bits the Micron parts use: bit 0 (fail),
+ * bit 1 (8-bit uncorrectable), bits 4:3 (8-bit count, 4-bit rewrite).
+ * The other bits, ready among them, must not change the result.
+ *
+ * Built and run on the host by "make nand-ecc-check".
+ */
+
+#include <stdio.h>
+
+#include "nand.h"
+
+#define BIT_FAIL	0x01
+#define BIT_UNCORR_8	0x02
+#define BIT_3		0x08
+#define BIT_4		0x10
+
+static int fails;
+
+/* The expected result, written from the datasheets */
+static int expected(unsigned char status, unsigned int strength)
+{
+	unsigned int count = (status >> 3) & 0x3;
+
+	if (status & BIT_FAIL)
+		return -1;
+
+	if (strength == 4)
+		return (status & BIT_3) ? 4 : 0;
+
+	if (status & BIT_UNCORR_8)
+		return -1;
+
+	switch (count) {
+	case 0:
+		return 0;
+	case 2:		/* bit 4 */
+		return 3;
+	case 1:		/* bit 3 */
+		return 6;
+	default:
+		return 8;
+	}
+}
+
+static void check(unsigned char status, unsigned int strength)
+{
+	int ret = nand_ondie_ecc_status(status, strength);
+	int exp = expected(status, strength);
+
+	if (ret != exp) {
+		printf("FAIL %d-bit status %02x: %d, expected %d\n",
+		       strength, status, ret, exp);
+		fails++;
+	}
+}
+
+int main(void)
+{
+	static const unsigned char others[] = { 0x00, 0x20, 0x40, 0xe4 };
+	unsigned int bits, i;
+
+	for (bits = 0; bits < 16; bits++) {
+		unsigned char status = (bits & 0x3) | ((bits & 0xc) << 1);
+
+		for (i = 0; i < sizeof(others); i++) {
+			check(status | others[i], 4);
+			check(status | others[i], 8);
+		}
+	}
+
+	/* The cases the decode exists for */
+	if (nand_ondie_ecc_status(BIT_UNCORR_8, 8) != -1) {
+		printf("FAIL 8-bit uncorrectable page passed\n");
+		fails++;
+	}
+	if (nand_ondie_ecc_status(BIT_3, 4) != 4) {
+		printf("FAIL 4-bit rewrite recommended not bounded by 4\n");
+		fails++;
+	}
+
+	if (fails) {
+		printf("nand ecc: %d failures\n", fails);
+		return 1;
+	}
+	printf("nand ecc: all checks passed\n");
+
+	return 0;
+}
@@ -0,0 +1,262 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+/*
+ * Check lib/p256.c against signatures known good, and the same signatures
+ * altered, then time the verification.
+ *
+ * Built and run on the host by "make p256-bench". The host runs the
+ * portable Montgomery multiplication, not the ARM assembly.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "p256.h"
+#include "sha256.h"
+
+#define BENCH_ROUNDS	200
+
+/* RFC 6979, A.2.5: P-256 with SHA-256 */
+static const char rfc6979_key[] =
+	"60fed4ba255a9d31c961eb74c6356d68c049b8923b61fa6ce669622e60f29fb6"
+	"7903fe1008b8bc99a41ae9e95628bc64f2f1b20c2d7e9f5177a3c294d4462299";
+
+static const struct {
+	const char *message;
+	const char *signature;
+} rfc6979_vectors[] = {
+	{
+		"sample",
+		"efd48b2aacb6a8fd1140dd9cd45e81d69d2c877b56aaf991c34d0ea84eaf3716"
+		"f7cb1c942d657c41d436c7a1b6e29f65f3e900dbb9aff4064dc4ab2f843acda8",
+	},
+	{
+		"test",
+		"f1abb023518351cd71d881567b1ea663ed3efcf6c5132b354f28d3b0b7d38367"
+		"019f4113742a2b14bd25926b49c649155f267e60d3814b4c0cc84250e46f0083",
+	},
+};
+
+/*
+ * Random keys and digests, the last ones 0, 2^256 - 1, n and n - 1,
+ * signed with a reference implementation.
+ */
+static const struct {
+	const char *key;
+	const char *digest;
+	const char *signature;
+} vectors[] = {
+	{
+		"467d9adc23cffe297b5743b6a8f6a38154c3e9efcc5bf3477004e99877537069"
+		"61f34c1c7f637519378cb5076f8285f714f4deb6338550b43785ff38cb1fd056",
+		"750b79840a35e888cea8684b60033cd65db233956ea88f4b4f72fd3f7d254db8",
+		"5d2f90b6ed4388cb7f5449737072de4507b58bc49cae4a48abc5fe669843e62a"
+		"dde2246936a456d9c02856015ada75bc4b6ec56ecb9586d723dfc192ad626726",
+	},
+	{
+		"7aaeb00b480fbd3965a16dd9d0391213ab3e09b929c32684435b01ab054f5f47"
+		"55a407c2d7a0e171255ce4807196c02c3652c8da44db075eebb6e1c1603d8e91",
+		"aacdabbb49c9c6072c54a01283037cadfde8ec5e3e1544596ebbec4cc598e827",
+		"6497fb95d95ef76faf7cfee38ad425d4db6eeaf1f721c57ad7bb5c36e62c586e"
+		"08173961f4f41902af279025ec9b6b4fa726a580da82308e7ca33175dd55f2ab",
+	},
+	{
+		"f1ef0b9cf136ca3cc32c0b5c5945b8d6788ec3e1495f7a6ba9a1cdf644753537"
+		"1b86696998710c5948a6a725fd78d4c1a6beec18be23bf79beda4ea7b7f4e02d",
+		"d2aeeaf914c7d3fd9a1ac067541b8ee6f0969fe15284b2bf8e56916a518a4444",
+		"a6357c9acb865e17258eba204ecdded4bc23ddf894f3ccbd0786c4e5088f45d0"
+		"74b81d7e3e7965b561eb3403cd8eca24f9b56207ba0e7c1e15493f02dbf6c692",
+	},
+	{
+		"958c946d09ed45b8669ba17f266c63658542bff5147bc7c0088d18aee6b7e8ae"
+		"759b3d960936144783eccedb0243ffe24cff1cb3bc4b7c758683791f496450f1",
+		"f09b30460cce5b3445fff12fb4d7a20d294b97d08e7981664997082c8b7e20bf",
+		"8f3f6d1ce6a66136b585b7a7665960584fe1818ffa7636a41e712fcc9ebe39d1"
+		"b7da091e1492b1e920e5841d8d3bce3a474584e616b800595cd548317932bd48",
+	},
+	{
+		"fd3d38268b49c219d6e5175c2cdfb12524fb0037262ade087c49a53602b8cf0a"
+		"65247003f9458901b00e53490bd22024e3ad0c9cf651c994a3fb5b2866bfc91d",
+		"fde9c7e9675be2b6da6f2974beeb65d108c25300fecf0c9277eeb71d894a472b",
+		"786035601b375a8d28cfa707d77cf873585faf9636a0e7afc74c2f17627937d8"
+		"62028778fadfc70b5b3883a48d4d86199069353df3bca4caccefefccccba3522",
+	},
+	{
+		"18b5a740821478e281f0dfdf167d055135bebd95cca65423f30e0a991cd23f16"
+		"93bace9c7a859043bc7be3efc4c44e9697453b7474657fe899ff4702abef7169",
+		"0000000000000000000000000000000000000000000000000000000000000000",
+		"48d0306487bfaa2c0656695dd4c1e1cff16594e6bebb72f68512396204ad867d"
+		"400593475c69411657f8436ab5212794981afe2cbc482ef4efbe04f89466f123",
+	},
+	{
+		"5a0c2a6afdeef5c8028c6e4e95fc6535d2f3fa5f5d20afa883155ab9cf53504f"
+		"f68495bc1d33b5d7ce512cd4f2a43815b0ed5cd88029103b0be1fb70f459c9bc",
+		"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+		"99791a47d5dac0f6d0008f5a8d6f27eeaeed243b8066aa26e62a5d0fc804c19b"
+		"892d097d9186177fd4a2fe3fdc87fcc1783888080600c65a0844a667983674a7",
+	},
+	{
+		"1a78b715381b6e793634d14bf253d3daccac16aed5ffed67f5a2f91e1b71520b"
+		"2c5da63012d1dceed5234e42f2b4e4a15c378af4194d558858a857929414b40b",
+		"ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551",
+		"c87468a0ab49f5431c74dc38ddd00e12b2de58e2b2ded7ba21aa43f3327984a3"
+		"1f43dff1c15bcca14ac9c6a79401365b30a0a9a9ac2f103686e7ba8df754d550",
+	},
+	{
+		"f6546e60b87da77e9525032b033c4e879899bbd9e43bf9b1963758bf69405748"
+		"aeefbbb7d876d70d0dd164bf70d71318e7b41903de69b06a27b2b6acb201a218",
+		"ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632550",
+		"b57f5b3dca58c7a7f9639c9514e3338984daa8ebd4c370ef773377de6e58bd71"
+		"8658c0943cb674e503843ae439eb8e6a99faddb14c5bfc7a203648dabc9eb184",
+	},
+};
+
+/* n, a valid r or s once decremented */
+static const char order[] =
+	"ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551";
+
+static void from_hex(unsigned char *bin, const char *hex, unsigned int len)
+{
+	unsigned int i, byte;
+
+	for (i = 0; i < len; i++) {
+		sscanf(hex + 2 * i, "%2x", &byte);
+		bin[i] = byte;
+	}
+}
+
+static int check(const char *what, unsigned int index,
+		 const unsigned char *key, const unsigned char *digest,
+		 const unsigned char *signature, int expected)
+{
+	if (p256_ecdsa_verify(key, digest, signature) == expected)
+		return 0;
+
+	printf("FAIL %s %u: %s, expected %s\n", what, index,
+	       expected ? "good" : "bad", expected ? "bad" : "good");
+	return 1;
+}
+
+/* A good signature, then every field altered in turn */
+static int check_vector(unsigned int index, const unsigned char *key,
+			const unsigned char *digest,
+			const unsigned char *signature)
+{
+	unsigned char k[P256_KEY_SIZE], d[SHA256_DIGEST_SIZE];
+	unsigned char s[P256_SIGNATURE_SIZE];
+	int fails;
+
+	fails = check("good", index, key, digest, signature, 0);
+
+	memcpy(d, digest, sizeof(d));
+	d[index % sizeof(d)] ^= 0x10;
+	fails += check("digest", index, key, d, signature, -1);
+
+	memcpy(k, key, sizeof(k));
+	k[index % sizeof(k)] ^= 0x01;
+	fails += check("key", index, k, digest, signature, -1);
+
+	memcpy(s, signature, sizeof(s));
+	s[index % P256_BYTES] ^= 0x80;
+	fails += check("r", index, key, digest, s, -1);
+
+	memcpy(s, signature, sizeof(s));
+	s[P256_BYTES + index % P256_BYTES] ^= 0x04;
+	fails += check("s", index, key, digest, s, -1);
+
+	/* r and s swapped */
+	memcpy(s, signature + P256_BYTES, P256_BYTES);
+	memcpy(s + P256_BYTES, signature, P256_BYTES);
+	fails += check("swapped", index, key, digest, s, -1);
+
+	/* out of range */
+	memcpy(s, signature, sizeof(s));
+	memset(s, 0, P256_BYTES);
+	fails += check("r = 0", index, key, digest, s, -1);
+
+	memcpy(s, signature, sizeof(s));
+	from_hex(s + P256_BYTES, order, P256_BYTES);
+	fails += check("s = n", index, key, digest, s, -1);
+
+	return fails;
+}
+
+static int check_vectors(void)
+{
+	unsigned char key[P256_KEY_SIZE], digest[SHA256_DIGEST_SIZE];
+	unsigned char signature[P256_SIGNATURE_SIZE];
+	struct sha256_ctx ctx;
+	unsigned int i;
+	int fails = 0;
+
+	from_hex(key, rfc6979_key, sizeof(key));
+	for (i = 0; i < sizeof(rfc6979_vectors) / sizeof(rfc6979_vectors[0]); i++) {
+		sha256_init(&ctx);
+		sha256_update(&ctx, rfc6979_vectors[i].message,
+			      strlen(rfc6979_vectors[i].message));
+		sha256_final(&ctx, digest);
+		from_hex(signature, rfc6979_vectors[i].signature,
+			 sizeof(signature));
+		fails += check_vector(i, key, digest, signature);
+	}
+
+	for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+		from_hex(key, vectors[i].key, sizeof(key));
+		from_hex(digest, vectors[i].digest, sizeof(digest));
+		from_hex(signature, vectors[i].signature, sizeof(signature));
+		fails += check_vector(i + 2, key, digest, signature);
+	}
+
+	return fails;
+}
+
+static double elapsed(struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (now.tv_sec - start->tv_sec)
+		+ (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void bench(void)
+{
+	unsigned char key[P256_KEY_SIZE], digest[SHA256_DIGEST_SIZE];
+	unsigned char signature[P256_SIGNATURE_SIZE];
+	struct timespec start;
+	int i, ret = 0;
+
+	from_hex(key, vectors[0].key, sizeof(key));
+	from_hex(digest, vectors[0].digest, sizeof(digest));
+	from_hex(signature, vectors[0].signature, sizeof(signature));
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < BENCH_ROUNDS; i++)
+		ret |= p256_ecdsa_verify(key, digest, signature);
+	printf("  %-12s %8.1f us\n", "verify",
+	       elapsed(&start) / BENCH_ROUNDS * 1e6);
+
+	if (ret)
+		printf("FAIL bench\n");
+}
+
+int main(void)
+{
+	int fails;
+
+	fails = check_vectors();
+	if (fails) {
+		printf("P-256: %d failures\n", fails);
+		return 1;
+	}
+	printf("P-256: test vectors passed\n");
+
+	bench();
+
+	return 0;
+}
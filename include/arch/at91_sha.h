@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __AT91_SHA_H__
+#define __AT91_SHA_H__
+
+/**** Register offset in AT91_SHA structure ***/
+#define SHA_CR		0x00	/* Control Register */
+#define SHA_MR		0x04	/* Mode Register */
+#define SHA_IER		0x10	/* Interrupt Enable Register */
+#define SHA_IDR		0x14	/* Interrupt Disable Register */
+#define SHA_IMR		0x18	/* Interrupt Mask Register */
+#define SHA_ISR		0x1C	/* Interrupt Status Register */
+#define SHA_IDATAR0	0x40	/* Input Data Register 0 */
+#define SHA_ODATAR0	0x80	/* Output Data Register 0 */
+
+/*-------- SHA_CR : (SHA Offset: 0x00) Control Register --------*/
+#define SHA_CR_START		(0x1UL << 0)
+#define SHA_CR_FIRST		(0x1UL << 4)
+#define SHA_CR_SWRST		(0x1UL << 8)
+
+/*-------- SHA_MR : (SHA Offset: 0x04) Mode Register --------*/
+#define SHA_MR_SMOD_MANUAL	(0x0UL << 0)
+#define SHA_MR_SMOD_AUTO	(0x1UL << 0)
+#define SHA_MR_SMOD_IDATAR0	(0x2UL << 0)	/* for the DMA */
+#define SHA_MR_PROCDLY		(0x1UL << 4)
+#define SHA_MR_ALGO_SHA1	(0x0UL << 8)
+#define SHA_MR_ALGO_SHA256	(0x1UL << 8)
+
+/*-------- SHA_ISR : (SHA Offset: 0x1C) Interrupt Status Register --------*/
+#define SHA_ISR_DATRDY		(0x1UL << 0)
+
+#endif /* #ifndef __AT91_SHA_H__ */
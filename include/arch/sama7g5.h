@@ -64,6 +64,7 @@
 #define AT91C_BASE_SHDWC	0xe001d010
 #define AT91C_BASE_WDTS		0xe001d180
 #define AT91C_BASE_SCKCR	0xe001d050
+#define AT91C_BASE_GPBR		0xe001d060
 
 #define AT91C_BASE_MATRIX	0xe0804000
 #define AT91C_BASE_HSMC		0xe0808000
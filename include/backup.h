@@ -11,6 +11,10 @@ extern unsigned long backup_mode_resume(void);
 
 #ifdef CONFIG_BACKUP_MODE
 	int backup_resume(void);
+#ifdef CONFIG_BACKUP_RESUME_LATENCY
+	void backup_latency_start(void);
+	unsigned int backup_latency_stop(void);
+#endif
 #ifdef CONFIG_PUBL
 	void backup_get_calibration_data(unsigned int *data, unsigned int len);
 #else
@@ -45,6 +45,10 @@
 
 #define HW_INFO_TOTAL_SIZE	0x20
 
+/* Device tree overlay ids of the CM, DM and EK boards, like "ek21-a" */
+#define BOARD_OVERLAY_IDS	3
+#define BOARD_OVERLAY_ID_LEN	8
+
 extern unsigned int get_cm_sn(void);
 extern char get_cm_rev(void);
 extern unsigned int get_cm_vendor(void);
@@ -54,6 +58,8 @@ extern unsigned int get_sys_rev(void);
 extern char get_ek_rev(void);
 extern unsigned int get_ek_sn(void);
 
+extern void get_board_overlay_ids(char ids[][BOARD_OVERLAY_ID_LEN]);
+
 extern void load_board_hw_info(void);
 
 #endif	/* #ifndef __BOARD_HW_INFO_H__ */
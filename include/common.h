@@ -30,8 +30,9 @@ enum {
 /* structure definition */
 struct image_info
 {
-#if defined(CONFIG_DATAFLASH) || defined(CONFIG_NANDFLASH) || defined(CONFIG_FLASH)
-	unsigned int offset;
+#if defined(CONFIG_DATAFLASH) || defined(CONFIG_NANDFLASH) || defined(CONFIG_FLASH) \
+	|| defined(CONFIG_SDCARD_RAW) || defined(CONFIG_BOOT_FALLBACK)
+	unsigned int offset;	/* raw SD: in blocks, NOR: address, else bytes */
 	unsigned int length;
 #endif
 #ifdef CONFIG_SDCARD
@@ -44,7 +45,8 @@ struct image_info
 	unsigned char *dest;
 
 #ifdef CONFIG_OF_LIBFDT
-#if defined(CONFIG_DATAFLASH) || defined(CONFIG_NANDFLASH) || defined(CONFIG_FLASH)
+#if defined(CONFIG_DATAFLASH) || defined(CONFIG_NANDFLASH) || defined(CONFIG_FLASH) \
+	|| defined(CONFIG_SDCARD_RAW) || defined(CONFIG_BOOT_FALLBACK)
 	unsigned int of_offset;
 	unsigned int of_length;
 #endif
@@ -53,6 +55,12 @@ struct image_info
 #endif
 	unsigned char *of_dest;
 #endif
+
+#ifdef CONFIG_LOAD_OPTEE
+	/* loaded first, in the same pass as the image */
+	char *optee_filename;
+	unsigned char *optee_dest;
+#endif
 };
 
 typedef int (*load_function)(struct image_info *image);
@@ -61,6 +69,13 @@ typedef int (*load_function)(struct image_info *image);
 
 load_function get_image_load_func(void);
 
+#ifdef CONFIG_AB_SLOTS
+/* The loader of the boot medium, which the A/B slots wrap */
+load_function get_media_load_func(void);
+
+extern int ab_load_image(struct image_info *image);
+#endif
+
 #if defined(CONFIG_DATAFLASH) || defined(CONFIG_NANDFLASH) || defined(CONFIG_FLASH)
 unsigned int get_image_load_offset(unsigned int addr);
 #endif
@@ -72,6 +87,13 @@ extern void init_load_image(struct image_info *image);
 extern int load_kernel(struct image_info *image);
 
 extern int kernel_size(unsigned char *addr);
+
+extern int kernel_check_data(unsigned char *addr);
+
+#ifdef CONFIG_BOOT_FALLBACK
+/* Wait, identifying the next boot media meanwhile */
+extern void boot_media_delay(unsigned int usec);
+#endif
 #endif
 
 extern void load_image_done(int retval);
@@ -0,0 +1,20 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __CRC32_H__
+#define __CRC32_H__
+
+/*
+ * CRC-32 as used by zlib and the uImage header (reflected 0xedb88320).
+ * Pass 0 as the first crc, and the previous result to continue.
+ */
+extern unsigned int crc32(unsigned int crc, const void *buf, unsigned int len);
+
+/* memcpy() computing the CRC of what it copies, in a single pass */
+extern unsigned int crc32_copy(unsigned int crc, void *dst, const void *src,
+			       unsigned int len);
+
+#endif /* #ifndef __CRC32_H__ */
@@ -9,6 +9,8 @@
 
 extern int load_dataflash(struct image_info *image);
 
+extern int dataflash_probe(void);
+
 extern int dataflash_page0_erase(void);
 
 #endif
@@ -0,0 +1,12 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __DDR_BENCH_H__
+#define __DDR_BENCH_H__
+
+extern void ddram_benchmark(void);
+
+#endif /* #ifndef __DDR_BENCH_H__ */
@@ -7,11 +7,54 @@
 #ifndef __FDT_H__
 #define __FDT_H__
 
+#define OF_MAX_FIXUPS	8
+
+/*
+ * Set a property of the first node matching a name (with or without unit
+ * address, "" is the root node). The value is read when the fixups are
+ * applied.
+ */
+struct of_fixup {
+	const char	*node;
+	const char	*property;
+	const void	*value;
+	int		len;
+
+	/* resolved by of_fixups_apply() */
+	int		node_offset;
+	int		prop_offset;
+	int		prop_len;
+	int		name_offset;
+};
+
+struct of_fixups {
+	unsigned int	count;
+	struct of_fixup	fixup[OF_MAX_FIXUPS];
+};
+
 extern unsigned int of_get_dt_total_size(void *blob);
 extern int check_dt_blob_valid(void *blob);
-extern int fixup_chosen_node(void *blob, char *bootargs);
-extern int fixup_memory_node(void *blob,
-				unsigned int *mem_bank,
-				unsigned int *mem_bank2,
-				unsigned int *mem_size);
+
+extern void of_fixups_init(struct of_fixups *fixups);
+extern int of_fixup_add(struct of_fixups *fixups,
+			const char *node,
+			const char *property,
+			const void *value,
+			int len);
+extern int of_fixups_apply(void *blob, struct of_fixups *fixups);
+
+#ifdef CONFIG_OF_OVERLAY
+/*
+ * The overlays are loaded one after the other right after the base blob,
+ * the list ends with the first word which is not a blob magic number.
+ */
+static inline void *of_next_blob(void *blob)
+{
+	return (char *)blob + OF_ALIGN(of_get_dt_total_size(blob));
+}
+
+extern int of_overlay_match(void *overlay, const char *board_id);
+extern int of_overlay_apply(void *blob, unsigned int size, void *overlay);
+#endif
+
 #endif /* #ifndef __FDT_H__ */
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __GPBR_H__
+#define __GPBR_H__
+
+/*
+ * General purpose backup registers with a fixed use, which the registers
+ * chosen in the configuration must not overlap.
+ */
+#define GPBR_RTT_TIME		0	/* Linux, RTT time base */
+#define GPBR_BOOT_MODE		1	/* SAMA5D3, BACKUP_REGISTER_BOOT_MODE_R4 */
+#define GPBR_HW_INFO_SN		2	/* board hardware information */
+#define GPBR_HW_INFO_REV	3
+
+#define GPBR_RESERVED(n)	(((n) == GPBR_RTT_TIME) || \
+				 ((n) == GPBR_BOOT_MODE) || \
+				 ((n) == GPBR_HW_INFO_SN) || \
+				 ((n) == GPBR_HW_INFO_REV))
+
+#ifdef CONFIG_SPI_NOR_PROBE_CACHE
+#if GPBR_RESERVED(CONFIG_SPI_NOR_PROBE_CACHE_GPBR) || \
+    GPBR_RESERVED(CONFIG_SPI_NOR_PROBE_CACHE_GPBR + 1) || \
+    GPBR_RESERVED(CONFIG_SPI_NOR_PROBE_CACHE_GPBR + 2)
+#error "CONFIG_SPI_NOR_PROBE_CACHE_GPBR: backup register used by the RTT, the boot mode or the hardware information"
+#endif
+#endif
+
+#ifdef CONFIG_AB_SLOTS
+#if GPBR_RESERVED(CONFIG_AB_GPBR)
+#error "CONFIG_AB_GPBR: backup register used by the RTT, the boot mode or the hardware information"
+#endif
+#if defined(CONFIG_SPI_NOR_PROBE_CACHE) && \
+    (CONFIG_AB_GPBR >= CONFIG_SPI_NOR_PROBE_CACHE_GPBR) && \
+    (CONFIG_AB_GPBR <= CONFIG_SPI_NOR_PROBE_CACHE_GPBR + 2)
+#error "CONFIG_AB_GPBR: backup register used by the SPI NOR probe cache"
+#endif
+#endif
+
+#endif /* #ifndef __GPBR_H__ */
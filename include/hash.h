@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __HASH_H__
+#define __HASH_H__
+
+#include "sha256.h"
+
+#define HASH_SIZE	SHA256_DIGEST_SIZE
+
+/*
+ * SHA-256 of one message at a time, fed as it arrives. It runs on the SHA
+ * peripheral when there is one, and hash_update() may return before its
+ * data is hashed when the DMA feeds it: the data must then stay in place
+ * until the next call.
+ */
+extern void hash_init(void);
+extern void hash_update(const void *data, unsigned int len);
+extern void hash_final(unsigned char *digest);
+
+#ifdef CONFIG_SHA
+extern void at91_sha_init(void);
+extern void at91_sha_update(const void *data, unsigned int len);
+extern void at91_sha_final(unsigned char *digest);
+#endif
+
+#endif /* #ifndef __HASH_H__ */
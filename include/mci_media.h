@@ -14,6 +14,7 @@
 #define SD_CMD_SWITCH_FUN		6
 #define SD_CMD_SELECT_CARD		7
 #define SD_CMD_SEND_IF_COND		8
+#define SD_CMD_VOLTAGE_SWITCH		11
 #define SD_CMD_SEND_CSD			9
 #define SD_CMD_SEND_CID			10
 #define SD_CMD_STOP_TRANSMISSION	12
@@ -21,6 +22,7 @@
 #define	SD_CMD_SET_BLOCKLEN		16
 #define SD_CMD_READ_SINGLE_BLOCK	17
 #define SD_CMD_READ_MULTIPLE_BLOCK	18
+#define SD_CMD_SEND_TUNING_BLOCK	19
 #define SD_CMD_SET_BLOCK_COUNT		23
 #define SD_CMD_APP_CMD			55
 
@@ -36,6 +38,7 @@
 #define MMC_CMD_SEND_EXT_CSD		8
 #define MMC_CMD_BUSTEST_R		14
 #define MMC_CMD_BUSTEST_W		19
+#define MMC_CMD_SEND_TUNING_BLOCK	21
 
 /* Card State */
 #define SD_STATE_INACTIVE		0
@@ -118,9 +121,20 @@ struct sd_command {
 	unsigned int resp[4];
 };
 
+/* Bus timing, the UHS-I values match the host UHS Mode Select field */
+#define	SD_TIMING_LEGACY	0x00
+#define	SD_TIMING_SDR25		0x01
+#define	SD_TIMING_SDR50		0x02
+#define	SD_TIMING_SDR104	0x03
+#define	SD_TIMING_DDR50		0x04
+#define	MMC_TIMING_HS200	0x10
+
 #define	SD_DATA_DIR_RD		0x11
 #define	SD_DATA_DIR_WR		0x22
 
+/* Blocks read with a single CMD18, 8 MiB of 512-byte blocks */
+#define	SD_READ_MAX_BLOCKS	16384
+
 struct sd_data {
 	unsigned char *buff;
 	unsigned int direction;
@@ -136,6 +150,9 @@ struct host_ops {
 	int (*set_clock)(struct sd_card *sdcard, unsigned int clock);
 	int (*set_bus_width)(struct sd_card *sdcard, unsigned int width);
 	int (*set_ddr)(struct sd_card *sdcard);
+	int (*set_signal_voltage_1v8)(struct sd_card *sdcard);
+	int (*set_timing)(struct sd_card *sdcard, unsigned int timing);
+	int (*execute_tuning)(struct sd_card *sdcard, unsigned int cmd);
 };
 
 #define	BUS_WIDTH_1_BIT		0x01
@@ -149,6 +166,10 @@ struct sd_host {
 	unsigned int caps_high_speed;
 	unsigned int caps_adma2;
 	unsigned int caps_ddr;
+	unsigned int caps_sdr50;
+	unsigned int caps_sdr104;
+	unsigned int caps_tune_sdr50;
+	unsigned int caps_1v8;
 	unsigned int caps_clk_mult;
 	unsigned int caps_max_clock;
 	unsigned int caps_min_clock;
@@ -175,8 +196,14 @@ struct sd_card {
 	unsigned int	highspeed_card; /* is this card a HS according to CARDTYPE */
 	unsigned int	ddr; /* is this card running in DDR mode */
 	unsigned int	ddr_support; /* is this card a DDR according to CARDTYPE */
+	unsigned int	hs200_support; /* is this card HS200 1.8V according to CARDTYPE */
+	unsigned int	uhs_support; /* has this card accepted 1.8V signaling */
+	unsigned int	timing; /* bus timing we configured */
 	unsigned int	read_bl_len;
 	unsigned int	configured_bus_w; /* bus width which we configured */
+	unsigned int	ext_csd_rev; /* EXT_CSD fields read at identification */
+	unsigned int	sec_count;
+	unsigned int	partition_config;
 
 	struct sd_host	*host;
 
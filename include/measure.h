@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __MEASURE_H__
+#define __MEASURE_H__
+
+/*
+ * The loaders hash each image as it is read, between measure_begin() and
+ * measure_end(), by chunks small enough to be hashed while they are still
+ * in the data cache.
+ */
+#define MEASURE_CHUNK_SIZE	0x4000
+
+#define MEASURE_IMAGE		0
+#define MEASURE_DTB		1
+#define MEASURE_OPTEE		2
+#define MEASURE_COUNT		3
+
+#ifdef CONFIG_MEASURED_BOOT
+extern void measure_begin(unsigned int id);
+extern void measure_update(const void *data, unsigned int len);
+extern void measure_end(void);
+
+/* The log passed in the device tree, returns its size in bytes */
+extern unsigned int measure_get_log(const void **log);
+#else
+static inline void measure_begin(unsigned int id) {}
+static inline void measure_update(const void *data, unsigned int len) {}
+static inline void measure_end(void) {}
+#endif
+
+#endif /* #ifndef __MEASURE_H__ */
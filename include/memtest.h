@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __MEMTEST_H__
+#define __MEMTEST_H__
+
+/*
+ * Memory test pattern engine. It only touches the memory it is given and
+ * has no hardware dependency, the DRAM test stage drives it block by block.
+ */
+
+struct memtest_result {
+	unsigned int errors;
+	unsigned int first_addr;	/* first failing address */
+	unsigned int expected;
+	unsigned int actual;
+};
+
+extern void memtest_fill(unsigned int *start, unsigned int words,
+			 unsigned int pattern);
+
+extern void memtest_verify(const unsigned int *start, unsigned int words,
+			   unsigned int pattern, struct memtest_result *res);
+
+/* Verify pattern and write its inverse, ascending then descending */
+extern void memtest_invert_up(unsigned int *start, unsigned int words,
+			      unsigned int pattern, struct memtest_result *res);
+extern void memtest_invert_down(unsigned int *start, unsigned int words,
+				unsigned int pattern, struct memtest_result *res);
+
+/* Address-in-address: every word holds its own address (or its inverse) */
+extern void memtest_addr_fill(unsigned int *start, unsigned int words);
+extern void memtest_addr_invert(unsigned int *start, unsigned int words,
+				struct memtest_result *res);
+extern void memtest_addr_verify_inv(const unsigned int *start,
+				    unsigned int words,
+				    struct memtest_result *res);
+
+/* Walking ones on the data bus, and on the address lines of the window */
+extern void memtest_walking_ones(volatile unsigned int *addr,
+				 struct memtest_result *res);
+extern void memtest_addr_lines(volatile unsigned int *start,
+			       unsigned int size,
+			       struct memtest_result *res);
+
+#ifdef CONFIG_DDR_MEMTEST
+extern int ddram_memtest(void);
+#endif
+
+#endif /* #ifndef __MEMTEST_H__ */
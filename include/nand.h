@@ -86,9 +86,25 @@ struct nand_info {
 #define STATUS_READY			(0x01 << 6)   /* Status code for Ready */
 #define STATUS_ERROR			(0x01 << 0)   /* Status code for Error */
 
+/*
+ * On-Die ECC result of a page read (Micron). The 4-bit parts report an
+ * uncorrectable page as STATUS_ERROR, and a page to rewrite, with an
+ * unknown number of corrected bits, as bit 3. The 8-bit parts report
+ * uncorrectable as bit 1 and the corrected bits in bits 4:3.
+ */
+#define STATUS_ECC_4_REWRITE		(0x01 << 3)
+
+#define STATUS_ECC_8_MASK		((0x01 << 4) | (0x01 << 3) | (0x01 << 1))
+#define STATUS_ECC_8_UNCORRECTABLE	(0x01 << 1)
+#define STATUS_ECC_8_1_3_CORRECTED	(0x01 << 4)
+#define STATUS_ECC_8_4_6_CORRECTED	(0x01 << 3)
+#define STATUS_ECC_8_7_8_CORRECTED	((0x01 << 4) | (0x01 << 3))
+
 /* Nand flash commands */
 #define CMD_READ_1			0x00
 #define CMD_READ_2			0x30
+#define CMD_READ_CACHE_SEQ		0x31
+#define CMD_READ_CACHE_END		0x3F
 
 #define CMD_READID			0x90
 
@@ -118,4 +134,11 @@ struct nand_info {
 
 extern void nandflash_smc_conf(unsigned int mode, unsigned int cs);
 
+/*
+ * Decode the On-Die ECC status of a page read by a part correcting
+ * strength (4 or 8) bits: returns -1 when the page is uncorrectable,
+ * otherwise the upper bound of its corrected bits.
+ */
+extern int nand_ondie_ecc_status(unsigned char status, unsigned int strength);
+
 #endif /* #ifndef __NAND_H__ */
@@ -7,6 +7,26 @@
 #ifndef __OPTEE_H__
 #define __OPTEE_H__
 
+#include "types.h"
+
+struct optee_header {
+        u32 magic;
+        u8 version;
+        u8 arch;
+        u16 flags;
+        u32 init_size;
+        u32 init_load_addr_hi;
+        u32 init_load_addr_lo;
+        u32 init_mem_usage;
+        u32 paged_size;
+} __attribute__((packed));
+
+/*
+ * The loader reads the header apart from the payload, which goes straight
+ * to its run address: returns the payload size, or -1 for a bad header.
+ */
+int optee_header_check(struct optee_header *hdr, unsigned int file_size);
+
 void optee_load(void);
 void optee_init_nw_params(void *nw_addr, unsigned int r0,
 			  unsigned int r1, unsigned int r2);
@@ -0,0 +1,22 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __P256_H__
+#define __P256_H__
+
+#define P256_BYTES		32
+#define P256_KEY_SIZE		(2 * P256_BYTES)	/* x, y */
+#define P256_SIGNATURE_SIZE	(2 * P256_BYTES)	/* r, s */
+
+/*
+ * Check the ECDSA signature on the NIST P-256 curve of a SHA-256 digest.
+ * All numbers are big endian. Returns 0 when the signature is good.
+ */
+extern int p256_ecdsa_verify(const unsigned char *key,
+			     const unsigned char *digest,
+			     const unsigned char *signature);
+
+#endif /* #ifndef __P256_H__ */
@@ -7,6 +7,7 @@
 #ifndef __QSPI_FLASH_H__
 #define __QSPI_FLASH_H__
 
+int qspi_probe(void);
 int qspi_loadimage(struct image_info *image);
 
 #endif
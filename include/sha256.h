@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __SHA256_H__
+#define __SHA256_H__
+
+#define SHA256_DIGEST_SIZE	32
+#define SHA256_BLOCK_SIZE	64
+
+/* Portable SHA-256, fed in pieces of any size */
+struct sha256_ctx {
+	unsigned int	state[8];
+	unsigned int	count;		/* bytes hashed so far */
+	unsigned char	buf[SHA256_BLOCK_SIZE];
+};
+
+extern void sha256_init(struct sha256_ctx *ctx);
+extern void sha256_update(struct sha256_ctx *ctx,
+			  const void *data, unsigned int len);
+extern void sha256_final(struct sha256_ctx *ctx, unsigned char *digest);
+
+/* Append the padding and the length, big endian in bits, to the message */
+extern unsigned int sha256_pad(unsigned char *block, unsigned int used,
+			       unsigned int count);
+
+#endif /* #ifndef __SHA256_H__ */
@@ -33,6 +33,7 @@ struct spi_nor_info {
 };
 
 extern const struct spi_nor_info spi_nor_ids[];
+extern const unsigned int spi_nor_ids_count;
 
 int spansion_new_quad_enable(struct spi_flash *flash);
 int spansion_quad_enable(struct spi_flash *flash);
@@ -19,4 +19,16 @@ struct smc_args_t {
 	unsigned int	r7;
 };
 
+/* Highest SMC ID handled, plus one */
+#define SMC_ID_COUNT		0x63
+
+#ifdef CONFIG_SVC_MGR_STATS
+/* Query the call counters of a SMC, r1: the SMC ID, r2: the counter */
+#define SMC_ID_STATS		0x62
+
+#define SMC_STATS_CALLS		0
+#define SMC_STATS_CYCLES	1
+#define SMC_STATS_MAX_CYCLES	2
+#endif
+
 #endif
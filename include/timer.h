@@ -7,6 +7,8 @@
 #ifndef __PIT_TIMER_H__
 #define __PIT_TIMER_H__
 
+#include "div.h"
+
 extern int timer_init(void);
 
 extern void udelay(unsigned int usec);
@@ -15,4 +17,22 @@ extern void mdelay(unsigned int msec);
 extern int start_interval_timer(void);
 extern int wait_interval_timer(unsigned int usec);
 
+/*
+ * Free running counter for measuring elapsed time. The difference of two
+ * readings is valid as long as the interval does not exceed one wrap of
+ * the 32-bit counter (several tens of seconds on all supported devices).
+ */
+extern unsigned int timer_get_counter(void);
+extern unsigned int timer_get_rate(void);
+
+static inline unsigned int timer_ticks_to_usec(unsigned int ticks)
+{
+	unsigned int khz = div(timer_get_rate(), 1000);
+
+	if (ticks < 0xffffffff / 1000)
+		return div(ticks * 1000, khz);
+
+	return div(ticks, khz) * 1000;
+}
+
 #endif /* #ifndef __PIT_TIMER_H__ */
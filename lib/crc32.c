@@ -0,0 +1,123 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "crc32.h"
+
+#define CRC32_POLY	0xedb88320
+
+/*
+ * Slice-by-8 folds eight bytes per step through eight tables, where
+ * crc32_table[k][i] is the CRC of byte i followed by k zero bytes. The
+ * tables are built on the first call rather than stored.
+ */
+#ifdef CONFIG_CRC32_SLICE_BY_8
+#define CRC32_TABLES	8
+#else
+#define CRC32_TABLES	1
+#endif
+
+static unsigned int crc32_table[CRC32_TABLES][256];
+
+static void crc32_init(void)
+{
+	unsigned int i, j, c;
+
+	for (i = 0; i < 256; i++) {
+		c = i;
+		for (j = 0; j < 8; j++)
+			c = (c & 1) ? (c >> 1) ^ CRC32_POLY : c >> 1;
+		crc32_table[0][i] = c;
+	}
+
+	for (i = 0; i < 256; i++)
+		for (j = 1; j < CRC32_TABLES; j++)
+			crc32_table[j][i] = (crc32_table[j - 1][i] >> 8)
+				^ crc32_table[0][crc32_table[j - 1][i] & 0xff];
+}
+
+#define CRC32_BYTE(crc, b) \
+	(crc32_table[0][((crc) ^ (b)) & 0xff] ^ ((crc) >> 8))
+
+#ifdef CONFIG_CRC32_SLICE_BY_8
+/* Little endian: the first byte of a word is its low byte */
+static inline unsigned int crc32_slice8(unsigned int crc,
+					unsigned int one,
+					unsigned int two)
+{
+	one ^= crc;
+
+	return crc32_table[7][one & 0xff]
+		^ crc32_table[6][(one >> 8) & 0xff]
+		^ crc32_table[5][(one >> 16) & 0xff]
+		^ crc32_table[4][one >> 24]
+		^ crc32_table[3][two & 0xff]
+		^ crc32_table[2][(two >> 8) & 0xff]
+		^ crc32_table[1][(two >> 16) & 0xff]
+		^ crc32_table[0][two >> 24];
+}
+#endif
+
+unsigned int crc32(unsigned int crc, const void *buf, unsigned int len)
+{
+	const unsigned char *p = buf;
+
+	if (!crc32_table[0][1])
+		crc32_init();
+
+	crc = ~crc;
+
+#ifdef CONFIG_CRC32_SLICE_BY_8
+	while (len && ((unsigned long)p & 3)) {
+		crc = CRC32_BYTE(crc, *p++);
+		len--;
+	}
+
+	for (; len >= 8; len -= 8, p += 8)
+		crc = crc32_slice8(crc, ((const unsigned int *)p)[0],
+				   ((const unsigned int *)p)[1]);
+#endif
+
+	while (len--)
+		crc = CRC32_BYTE(crc, *p++);
+
+	return ~crc;
+}
+
+unsigned int crc32_copy(unsigned int crc, void *dst, const void *src,
+			unsigned int len)
+{
+	const unsigned char *s = src;
+	unsigned char *d = dst;
+
+	if (!crc32_table[0][1])
+		crc32_init();
+
+	crc = ~crc;
+
+#ifdef CONFIG_CRC32_SLICE_BY_8
+	if (!(((unsigned long)s ^ (unsigned long)d) & 3)) {
+		while (len && ((unsigned long)s & 3)) {
+			crc = CRC32_BYTE(crc, *s);
+			*d++ = *s++;
+			len--;
+		}
+
+		for (; len >= 8; len -= 8, s += 8, d += 8) {
+			unsigned int one = ((const unsigned int *)s)[0];
+			unsigned int two = ((const unsigned int *)s)[1];
+
+			((unsigned int *)d)[0] = one;
+			((unsigned int *)d)[1] = two;
+			crc = crc32_slice8(crc, one, two);
+		}
+	}
+#endif
+
+	while (len--) {
+		crc = CRC32_BYTE(crc, *s);
+		*d++ = *s++;
+	}
+
+	return ~crc;
+}
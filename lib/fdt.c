@@ -5,6 +5,7 @@
 #include "common.h"
 #include "string.h"
 #include "debug.h"
+#include "fdt.h"
 
 /* see linux document: ./Documentation/devicetree/booting-without-of.txt */
 #define OF_DT_MAGIC	0xd00dfeed
@@ -154,16 +155,9 @@ static int of_get_token_nextoffset(void *blob,
 	/* to get offset for the next token */
 	offset += 4;
 	if (tag  == OF_DT_TOKEN_NODE_BEGIN) {
-		/* node name */
+		/* node name, the \0 is part of it */
 		cell = (char *)of_dt_struct_offset(blob, offset);
-		do {
-			cell++;
-			offset++;
-		} while (*cell != '\0');
-		/* the \0 is part of the node name, hence offset must be updated to the 
-		* position past the \0.
-		*/
-		++offset;
+		offset += strlen(cell) + 1;
 	} else if (tag == OF_DT_TOKEN_PROP) {
 		/* the property value size */
 		plen = (unsigned int *)of_dt_struct_offset(blob, offset);
@@ -180,440 +174,1100 @@ static int of_get_token_nextoffset(void *blob,
 	return 0;
 }
 
-static int of_get_nextnode_offset(void *blob,
-				int start_offset,
-				int *offset,
-				int *nextoffset,
-				int *depth)
+/* -------------------------------------------------------- */
+
+/*
+ * Fixup transaction: the edits are collected first, then their nodes,
+ * properties and property names are resolved with a single walk of the
+ * dt struct and of the dt strings, and the blob is rewritten in place
+ * moving each byte at most once.
+ */
+
+struct of_edit {
+	int offset;	/* struct offset of the replaced property record */
+	int oldlen;	/* old record length, 0 to insert a property */
+	struct of_fixup *fixup;
+};
+
+void of_fixups_init(struct of_fixups *fixups)
 {
-	int next_offset = 0;
-	int nodeoffset = start_offset;
-	unsigned int token;
-	int ret;
+	memset(fixups, 0, sizeof(*fixups));
+}
 
-	if (!offset || !nextoffset || !depth)
+int of_fixup_add(struct of_fixups *fixups,
+			const char *node,
+			const char *property,
+			const void *value,
+			int len)
+{
+	struct of_fixup *fixup;
+	unsigned int i;
+
+	/* A property set twice keeps the last value */
+	for (i = 0; i < fixups->count; i++) {
+		fixup = &fixups->fixup[i];
+		if ((strcmp(fixup->node, node) == 0)
+			&& (strcmp(fixup->property, property) == 0))
+			break;
+	}
+
+	if (i == OF_MAX_FIXUPS) {
+		dbg_info("DT: too many fixups\n");
 		return -1;
+	}
+
+	fixup = &fixups->fixup[i];
+	fixup->node = node;
+	fixup->property = property;
+	fixup->value = value;
+	fixup->len = len;
+
+	if (i == fixups->count)
+		fixups->count++;
 
-	while(1) {
-		ret = of_get_token_nextoffset(blob, nodeoffset,
-						&next_offset, &token);
-		if (ret)
-			return ret;
+	return 0;
+}
+
+/* nodes are matched by name, with or without unit address */
+static int of_node_name_match(const char *nodename, const char *name)
+{
+	unsigned int namelen = strlen(name);
+
+	return (memcmp(nodename, name, namelen) == 0)
+		&& ((nodename[namelen] == '\0') || (nodename[namelen] == '@'));
+}
+
+/*
+ * Walk the dt struct once: the first node matching the name of a fixup
+ * is its target, and the properties of a target node are listed before
+ * its first subnode.
+ */
+static int of_fixups_resolve_nodes(void *blob, struct of_fixups *fixups)
+{
+	struct of_fixup *fixup;
+	unsigned int resolved = 0;
+	unsigned int token;
+	unsigned int *p;
+	int offset = 0;
+	int nextoffset;
+	int target = -1;
+	char *name;
+	unsigned int i;
+
+	for (i = 0; i < fixups->count; i++) {
+		fixups->fixup[i].node_offset = -1;
+		fixups->fixup[i].prop_offset = -1;
+	}
+
+	while (1) {
+		if (of_get_token_nextoffset(blob, offset, &nextoffset, &token))
+			return -1;
+
+		if (token == OF_DT_END)
+			break;
 
 		if (token == OF_DT_TOKEN_NODE_BEGIN) {
-			/* find the node start token */
-			(*depth)++;
+			name = (char *)of_dt_struct_offset(blob, offset + 4);
+			target = -1;
+			for (i = 0; i < fixups->count; i++) {
+				fixup = &fixups->fixup[i];
+				if ((fixup->node_offset < 0)
+					&& of_node_name_match(name, fixup->node)) {
+					fixup->node_offset = nextoffset;
+					target = nextoffset;
+					resolved++;
+				}
+			}
+		} else if ((token == OF_DT_TOKEN_PROP) && (target >= 0)) {
+			p = (unsigned int *)of_dt_struct_offset(blob, offset + 8);
+			name = of_get_string_by_offset(blob, swap_uint32(*p));
+			for (i = 0; i < fixups->count; i++) {
+				fixup = &fixups->fixup[i];
+				if ((fixup->node_offset == target)
+					&& (fixup->prop_offset < 0)
+					&& (strcmp(name, fixup->property) == 0)) {
+					fixup->prop_offset = offset;
+					fixup->prop_len = nextoffset - offset;
+				}
+			}
+		} else if (token == OF_DT_TOKEN_NODE_END) {
+			target = -1;
+		}
 
+		/* every node is found and its properties are scanned */
+		if ((resolved == fixups->count) && (target < 0))
 			break;
+
+		offset = nextoffset;
+	}
+
+	for (i = 0; i < fixups->count; i++) {
+		if (fixups->fixup[i].node_offset < 0) {
+			dbg_info("DT: doesn't support add node (%s)\n",
+				 fixups->fixup[i].node);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Find the offset of every property name in the dt strings, walking them
+ * string by string, the missing ones are given an offset past the end of
+ * the dt strings. Return the length of the strings to append.
+ */
+static unsigned int of_fixups_resolve_strings(void *blob,
+					struct of_fixups *fixups)
+{
+	char *dt_strings = (char *)blob + of_get_offset_dt_strings(blob);
+	unsigned int dt_stringslen = of_get_dt_strings_len(blob);
+	char *end = dt_strings + dt_stringslen;
+	struct of_fixup *fixup;
+	unsigned int missing = 0;
+	unsigned int added = 0;
+	unsigned int *p;
+	char *string;
+	unsigned int i, j;
+
+	for (i = 0; i < fixups->count; i++) {
+		fixup = &fixups->fixup[i];
+		if (fixup->prop_offset >= 0) {
+			p = (unsigned int *)of_dt_struct_offset(blob,
+						fixup->prop_offset + 8);
+			fixup->name_offset = swap_uint32(*p);
 		} else {
-			nodeoffset = next_offset;
-
-			if ((token == OF_DT_TOKEN_PROP)
-				|| (token == OF_DT_TOKEN_NOP))
-				continue;
-			else if (token == OF_DT_TOKEN_NODE_END) {
-				(*depth)--;
-
-				if ((*depth) < 0)
-					return -1; /* not found */
-			} else if (token == OF_DT_END)
-				return -1; /* not found*/
+			fixup->name_offset = -1;
+			missing++;
 		}
-	};
+	}
 
-	*offset = nodeoffset;
-	*nextoffset = next_offset;
+	for (string = dt_strings; missing && (string < end);
+	     string += strlen(string) + 1) {
+		for (i = 0; i < fixups->count; i++) {
+			fixup = &fixups->fixup[i];
+			if ((fixup->name_offset < 0)
+				&& (strcmp(string, fixup->property) == 0)) {
+				fixup->name_offset = string - dt_strings;
+				missing--;
+			}
+		}
+	}
 
-	return 0;
+	for (i = 0; missing && (i < fixups->count); i++) {
+		fixup = &fixups->fixup[i];
+		if (fixup->name_offset >= 0)
+			continue;
+
+		for (j = 0; j < i; j++) {
+			if ((fixups->fixup[j].name_offset
+				>= (int)dt_stringslen)
+				&& (strcmp(fixups->fixup[j].property,
+					   fixup->property) == 0))
+				break;
+		}
+
+		if (j < i) {
+			fixup->name_offset = fixups->fixup[j].name_offset;
+		} else {
+			fixup->name_offset = dt_stringslen + added;
+			added += strlen(fixup->property) + 1;
+		}
+		missing--;
+	}
+
+	return added;
 }
 
-static int of_get_node_offset(void *blob, const char *name, int *offset)
+/* sort by offset, an insertion goes before a replacement at its offset */
+static void of_fixups_sort_edits(struct of_edit *edit, unsigned int count)
 {
-	int start_offset = 0;
-	int nodeoffset = 0;
-	int nextoffset = 0;
-	int depth = 0;
-	unsigned int token;
-	unsigned int namelen = strlen(name);
-	char *nodename;
-	int ret;
+	struct of_edit tmp;
+	unsigned int i, j;
+
+	for (i = 1; i < count; i++) {
+		tmp = edit[i];
+		for (j = i; j > 0; j--) {
+			if ((edit[j - 1].offset < tmp.offset)
+				|| ((edit[j - 1].offset == tmp.offset)
+					&& (edit[j - 1].oldlen <= tmp.oldlen)))
+				break;
+			edit[j] = edit[j - 1];
+		}
+		edit[j] = tmp;
+	}
+}
 
-	/* find the root node*/
-	ret = of_get_token_nextoffset(blob, 0, &start_offset, &token);
-	if (ret)
-		return -1;
+static inline int of_edit_newlen(struct of_edit *edit)
+{
+	return 12 + OF_ALIGN(edit->fixup->len);
+}
 
-	while (1) {
-		ret = of_get_nextnode_offset(blob, start_offset,
-					&nodeoffset, &nextoffset, &depth);
-		if (ret)
-			return ret;
+/* rewrite the blob, once the nodes and the properties are resolved */
+static int of_fixups_commit(void *blob, struct of_fixups *fixups)
+{
+	struct of_edit edit[OF_MAX_FIXUPS];
+	int delta[OF_MAX_FIXUPS];
+	struct of_fixup *fixup;
+	unsigned int count = fixups->count;
+	unsigned int struct_start = of_get_offset_dt_struct(blob);
+	unsigned int data_size = of_blob_data_size(blob);
+	unsigned int dt_stringslen = of_get_dt_strings_len(blob);
+	unsigned int added;
+	unsigned int src, end;
+	unsigned int *p;
+	char *dt_strings;
+	int shift = 0;
+	unsigned int i;
+	int k;
+
+	added = of_fixups_resolve_strings(blob, fixups);
+
+	for (i = 0; i < count; i++) {
+		fixup = &fixups->fixup[i];
+		edit[i].fixup = fixup;
+		if (fixup->prop_offset >= 0) {
+			edit[i].offset = fixup->prop_offset;
+			edit[i].oldlen = fixup->prop_len;
+		} else {
+			edit[i].offset = fixup->node_offset;
+			edit[i].oldlen = 0;
+		}
+	}
 
-		if (depth < 0)
-			return -1;
+	of_fixups_sort_edits(edit, count);
 
-		nodename = (char *)of_dt_struct_offset(blob,(nodeoffset + 4));
-		if ((memcmp(nodename, name, namelen) == 0)
-			&& ((nodename[namelen] == '\0')
-				|| (nodename[namelen] == '@')))
-			break;
+	/*
+	 * The data between edit i and edit i + 1 (or the end of the data)
+	 * moves by delta[i]. Moving the data shifted up from the end, then
+	 * the data shifted down from the start, never overwrites data not
+	 * moved yet.
+	 */
+	for (i = 0; i < count; i++) {
+		shift += of_edit_newlen(&edit[i]) - edit[i].oldlen;
+		delta[i] = shift;
+	}
+
+	for (k = count - 1; k >= 0; k--) {
+		if (delta[k] <= 0)
+			continue;
 
-		start_offset = nextoffset;
+		src = struct_start + edit[k].offset + edit[k].oldlen;
+		end = (k == count - 1) ? data_size
+				: (struct_start + edit[k + 1].offset);
+		memmove((char *)blob + src + delta[k],
+			(char *)blob + src, end - src);
 	}
 
-	*offset = nextoffset;
+	for (i = 0; i < count; i++) {
+		if (delta[i] >= 0)
+			continue;
+
+		src = struct_start + edit[i].offset + edit[i].oldlen;
+		end = (i == count - 1) ? data_size
+				: (struct_start + edit[i + 1].offset);
+		memmove((char *)blob + src + delta[i],
+			(char *)blob + src, end - src);
+	}
+
+	/* set property records: token, value size, name offset, value */
+	for (i = 0; i < count; i++) {
+		fixup = edit[i].fixup;
+		p = (unsigned int *)((char *)blob + struct_start
+				+ edit[i].offset + (i ? delta[i - 1] : 0));
+
+		*p++ = swap_uint32(OF_DT_TOKEN_PROP);
+		*p++ = swap_uint32(fixup->len);
+		*p++ = swap_uint32(fixup->name_offset);
+		if (fixup->len & 3)
+			p[fixup->len >> 2] = 0;
+		memcpy((unsigned char *)p, fixup->value, fixup->len);
+	}
+
+	of_set_dt_struct_len(blob, of_get_dt_struct_len(blob) + shift);
+	of_set_offset_dt_strings(blob,
+				 of_get_offset_dt_strings(blob) + shift);
+
+	dt_strings = (char *)blob + of_get_offset_dt_strings(blob);
+	for (i = 0; i < count; i++) {
+		fixup = &fixups->fixup[i];
+		if (fixup->name_offset >= (int)dt_stringslen)
+			strcpy(dt_strings + fixup->name_offset,
+			       fixup->property);
+	}
+	of_set_dt_strings_len(blob, dt_stringslen + added);
+
+	data_size += shift + added;
+	if (data_size > of_get_dt_total_size(blob))
+		of_set_dt_total_size(blob, data_size);
 
 	return 0;
 }
 
+int of_fixups_apply(void *blob, struct of_fixups *fixups)
+{
+	if (!fixups->count)
+		return 0;
+
+	if (of_fixups_resolve_nodes(blob, fixups))
+		return -1;
+
+	return of_fixups_commit(blob, fixups);
+}
+
+#ifdef CONFIG_OF_OVERLAY
 /* -------------------------------------------------------- */
 
-static int of_blob_move_dt_struct(void *blob,
-					void *point,
-					int oldlen,
-					int newlen)
+/*
+ * Overlays, built with symbols (dtc -@) as the base blob: the phandles
+ * of the overlay are moved above the ones of the base blob, its
+ * references to the labels of the base blob are resolved, then each
+ * fragment is merged into its target node.
+ */
+
+#define OF_PHANDLE_PROP(name)	(!strcmp(name, "phandle") \
+					|| !strcmp(name, "linux,phandle"))
+
+/* the merge and the local fixups recurse once per level */
+#define OF_MAX_DEPTH		16
+
+static inline unsigned int *of_token(void *blob, int offset)
 {
-	void *dest = point + newlen;
-	void *src = point + oldlen;
-	unsigned int len = (char *)blob + of_blob_data_size(blob)
-					- (char *)point - oldlen;
+	return (unsigned int *)of_dt_struct_offset(blob, offset);
+}
 
-	int delta = newlen - oldlen;
-	unsigned int structlen = of_get_dt_struct_len(blob) + delta;
-	unsigned int stringsoffset = of_get_offset_dt_strings(blob) + delta;
+static inline char *of_prop_name(void *blob, unsigned int *prop)
+{
+	return of_get_string_by_offset(blob, swap_uint32(prop[2]));
+}
 
-	memmove(dest, src, len);
+static inline unsigned int of_read_cell(const void *p)
+{
+	return swap_uint32(*(const unsigned int *)p);
+}
 
-	of_set_dt_struct_len(blob, structlen);
-	of_set_offset_dt_strings(blob, stringsoffset);
+static inline void of_write_cell(void *p, unsigned int val)
+{
+	*(unsigned int *)p = swap_uint32(val);
+}
 
-	if (delta > 0)
-		of_set_dt_total_size(blob, of_get_dt_total_size(blob) + delta);
+/* skip the NOP tokens up to a property, a node begin or a node end */
+static int of_skip_nop(void *blob, int offset, unsigned int *token)
+{
+	int next;
 
-	return 0;
+	for (;;) {
+		if (of_get_token_nextoffset(blob, offset, &next, token))
+			return -1;
+		if ((*token == OF_DT_TOKEN_PROP)
+				|| (*token == OF_DT_TOKEN_NODE_BEGIN)
+				|| (*token == OF_DT_TOKEN_NODE_END))
+			return offset;
+		if (*token != OF_DT_TOKEN_NOP)
+			return -1;
+		offset = next;
+	}
 }
 
-static int of_blob_move_dt_string(void *blob, int newlen)
+/* return the offset past the end token of a node */
+static int of_node_end(void *blob, int node)
 {
-	void *point = (void *)((unsigned int)blob
-				+ of_get_offset_dt_strings(blob)
-				+ of_get_dt_strings_len(blob));
+	unsigned int token;
+	int depth = 0;
+	int next;
 
-	void *dest = point + newlen;
-	unsigned int len = (char *)blob + of_blob_data_size(blob)
-					- (char *)point;
-	unsigned int stringslen = of_get_dt_strings_len(blob) + newlen;
+	do {
+		if (of_get_token_nextoffset(blob, node, &next, &token))
+			return -1;
+		if (token == OF_DT_TOKEN_NODE_BEGIN)
+			depth++;
+		else if (token == OF_DT_TOKEN_NODE_END)
+			depth--;
+		else if (token == OF_DT_END)
+			return -1;
+		node = next;
+	} while (depth);
 
-	memmove(dest, point, len);
+	return node;
+}
 
-	of_set_dt_strings_len(blob, stringslen);
-	of_set_dt_total_size(blob, of_get_dt_total_size(blob) + newlen);
+/*
+ * Iterate the properties then the subnodes of a node, the token of each
+ * entry is returned, and the node end token after the last one.
+ */
+static int of_node_first(void *blob, int node, unsigned int *token)
+{
+	int next;
 
-	return 0;
+	if (of_get_token_nextoffset(blob, node, &next, token)
+			|| (*token != OF_DT_TOKEN_NODE_BEGIN))
+		return -1;
+
+	return of_skip_nop(blob, next, token);
 }
 
-static int of_get_next_property_offset(void *blob,
-				int startoffset,
-				int *offset,
-				int *nextproperty)
+static int of_node_next(void *blob, int offset, unsigned int *token)
+{
+	int next;
+
+	if (*token == OF_DT_TOKEN_NODE_BEGIN)
+		next = of_node_end(blob, offset);
+	else if (of_get_token_nextoffset(blob, offset, &next, token))
+		return -1;
+
+	if (next < 0)
+		return -1;
+
+	return of_skip_nop(blob, next, token);
+}
+
+static int of_root_node(void *blob)
 {
 	unsigned int token;
-	int nextoffset;
-	int ret = -1;
+	int offset;
 
-	while (1) {
-		ret = of_get_token_nextoffset(blob, startoffset,
-						&nextoffset, &token);
-		if (ret)
-			break;
+	offset = of_skip_nop(blob, 0, &token);
+	if ((offset < 0) || (token != OF_DT_TOKEN_NODE_BEGIN))
+		return -1;
 
-		if (token == OF_DT_TOKEN_PROP) {
-			*offset = startoffset;
-			*nextproperty = nextoffset;
-			ret = 0;
-			break;
-		} else if (token == OF_DT_TOKEN_NOP)
+	return offset;
+}
+
+/*
+ * A subnode matches the name, a path component without unit address
+ * also matches the subnode name with one.
+ */
+static int of_find_subnode(void *blob, int node,
+			   const char *name, int len, int exact)
+{
+	unsigned int token;
+	const char *nodename;
+	int offset;
+	int i;
+
+	if (!exact)
+		for (i = 0; i < len; i++)
+			if (name[i] == '@')
+				exact = 1;
+
+	for (offset = of_node_first(blob, node, &token);
+	     (offset >= 0) && (token != OF_DT_TOKEN_NODE_END);
+	     offset = of_node_next(blob, offset, &token)) {
+		if (token != OF_DT_TOKEN_NODE_BEGIN)
 			continue;
-		else {
-			ret = -1;
+
+		nodename = (char *)of_token(blob, offset + 4);
+		if ((memcmp(nodename, name, len) == 0)
+				&& ((nodename[len] == '\0')
+				|| (!exact && (nodename[len] == '@'))))
+			return offset;
+	}
+
+	return -1;
+}
+
+static int of_path_offset(void *blob, const char *path, int len)
+{
+	const char *end = path + len;
+	const char *name;
+	int node;
+
+	if ((len < 1) || (*path != '/'))
+		return -1;
+
+	node = of_root_node(blob);
+	while ((node >= 0) && (path < end)) {
+		while ((path < end) && (*path == '/'))
+			path++;
+		if (path == end)
 			break;
+
+		name = path;
+		while ((path < end) && (*path != '/'))
+			path++;
+
+		node = of_find_subnode(blob, node, name, path - name, 0);
+	}
+
+	return node;
+}
+
+/* return the value of a property of a node, NULL if there is none */
+static void *of_get_prop(void *blob, int node,
+			 const char *name, int namelen, int *len)
+{
+	unsigned int token;
+	unsigned int *p;
+	char *propname;
+	int offset;
+
+	for (offset = of_node_first(blob, node, &token);
+	     (offset >= 0) && (token == OF_DT_TOKEN_PROP);
+	     offset = of_node_next(blob, offset, &token)) {
+		p = of_token(blob, offset);
+		propname = of_prop_name(blob, p);
+		if ((memcmp(propname, name, namelen) == 0)
+				&& (propname[namelen] == '\0')) {
+			*len = swap_uint32(p[1]);
+			return p + 3;
 		}
+	}
 
-		startoffset = nextoffset;
-	};
+	return NULL;
+}
 
-	return ret;
+static void of_update_total_size(void *blob)
+{
+	unsigned int data_size = of_blob_data_size(blob);
+
+	if (data_size > of_get_dt_total_size(blob))
+		of_set_dt_total_size(blob, data_size);
 }
 
-static int of_get_property_offset_by_name(void *blob,
-					unsigned int nodeoffset,
-					const char *name,
-					int *offset)
+/*
+ * The dt strings of the overlay are appended once to the ones of the base
+ * blob, the property names of the nodes copied from the overlay then
+ * point there, without searching them. Return their offset.
+ */
+static int of_overlay_strings(void *blob, void *overlay, int *strings)
 {
-	unsigned int nameoffset;
+	char *dt_strings = (char *)blob + of_get_offset_dt_strings(blob);
+	unsigned int len = of_get_dt_strings_len(overlay);
+
+	if (*strings < 0) {
+		*strings = of_get_dt_strings_len(blob);
+		memcpy(dt_strings + *strings,
+		       (char *)overlay + of_get_offset_dt_strings(overlay), len);
+		of_set_dt_strings_len(blob, *strings + len);
+		of_update_total_size(blob);
+	}
+
+	return *strings;
+}
+
+/* a string property, terminated within its value */
+static inline int of_is_string(const char *value, int len)
+{
+	return value && (len > 0) && (value[len - 1] == '\0');
+}
+
+/*
+ * The overlays come from the boot media: check that the areas given by
+ * the header are in the blob, that every token, node name and property
+ * is in the dt struct, every property name in the dt strings, and that
+ * the nodes are balanced, before walking it.
+ */
+static int of_overlay_check(void *overlay)
+{
+	unsigned int total = of_get_dt_total_size(overlay);
+	unsigned int struct_off, struct_len;
+	unsigned int strings_off, strings_len;
+	unsigned int offset = 0;
+	unsigned int token, len;
 	unsigned int *p;
-	unsigned int namelen = strlen(name);
-	int startoffset = nodeoffset;
-	int property_offset = 0;
-	int nextoffset = 0;
-	char *string;
-	int ret;
+	char *name;
+	int depth = 0;
 
-	*offset = 0;
+	/* the header itself first */
+	if (total < sizeof(struct boot_param_header))
+		return -1;
 
-	while (1) {
-		ret = of_get_next_property_offset(blob, startoffset,
-					&property_offset, &nextoffset);
-		if (ret)
-			return ret;
-
-		p = (unsigned int *)of_dt_struct_offset(blob,
-						property_offset + 8);
-		nameoffset = swap_uint32(*p);
-		string = of_get_string_by_offset(blob, nameoffset);
-		if ((strlen(string) == namelen)
-			&& (memcmp(string, name, namelen) == 0)) {
-			*offset = property_offset;
-			return 0;
+	struct_off = of_get_offset_dt_struct(overlay);
+	struct_len = of_get_dt_struct_len(overlay);
+	strings_off = of_get_offset_dt_strings(overlay);
+	strings_len = of_get_dt_strings_len(overlay);
+	if ((struct_off % 4) || (struct_len % 4)
+			|| (struct_off > total)
+			|| (struct_len > total - struct_off)
+			|| (strings_off > total)
+			|| (strings_len > total - strings_off)
+			|| (strings_len && ((char *)overlay)[strings_off
+							+ strings_len - 1]))
+		return -1;
+
+	while (offset < struct_len) {
+		p = of_token(overlay, offset);
+		token = swap_uint32(p[0]);
+		offset += 4;
+
+		switch (token) {
+		case OF_DT_TOKEN_NODE_BEGIN:
+			if (++depth > OF_MAX_DEPTH)
+				return -1;
+			name = (char *)(p + 1);
+			for (len = 0; (offset + len < struct_len) && name[len];)
+				len++;
+			if (offset + len >= struct_len)
+				return -1;
+			offset += OF_ALIGN(len + 1);
+			break;
+
+		case OF_DT_TOKEN_NODE_END:
+			if (--depth < 0)
+				return -1;
+			break;
+
+		case OF_DT_TOKEN_PROP:
+			if (!depth || (struct_len - offset < 8))
+				return -1;
+			len = swap_uint32(p[1]);
+			if ((swap_uint32(p[2]) >= strings_len)
+					|| (len > struct_len - offset - 8)
+					|| (OF_ALIGN(len) > struct_len - offset - 8))
+				return -1;
+			offset += 8 + OF_ALIGN(len);
+			break;
+
+		case OF_DT_TOKEN_NOP:
+			break;
+
+		case OF_DT_END:
+			return depth ? -1 : 0;
+
+		default:
+			return -1;
 		}
-		startoffset = nextoffset;
 	}
 
 	return -1;
 }
 
-static int of_string_is_find_strings_blob(void *blob,
-				const char *string,
-				int *offset)
+/* resize the dt struct area [offset, offset + oldlen) to newlen bytes */
+static unsigned int *of_blob_splice(void *blob, int offset,
+				    int oldlen, int newlen)
 {
-	char *dt_strings = (char *)blob + of_get_offset_dt_strings(blob);
-	int dt_stringslen = of_get_dt_strings_len(blob);
-	int len = strlen(string) + 1;
-	char *lastpoint = dt_strings + dt_stringslen - len;
-	char *p;
-
-	for (p = dt_strings; p <= lastpoint; p++) {
-		if (memcmp(p, string, len) == 0) {
-			*offset = p - dt_strings;
-			return 0;
-		}
+	char *point = (char *)of_token(blob, offset);
+	char *end = (char *)blob + of_blob_data_size(blob);
+	int delta = newlen - oldlen;
+
+	if (delta) {
+		memmove(point + newlen, point + oldlen, end - point - oldlen);
+		of_set_dt_struct_len(blob, of_get_dt_struct_len(blob) + delta);
+		of_set_offset_dt_strings(blob,
+					 of_get_offset_dt_strings(blob) + delta);
+		of_update_total_size(blob);
 	}
 
-	return -1;
+	return (unsigned int *)point;
 }
 
-static int of_add_string_strings_blob(void *blob,
-			const char *string,
-			int *name_offset)
+/* resolve the properties of the fixups in a node given by its offset */
+static int of_fixups_resolve_props(void *blob, int node,
+				   struct of_fixups *fixups)
 {
-	char *dt_strings = (char *)blob + of_get_offset_dt_strings(blob);
-	int dt_stringslen = of_get_dt_strings_len(blob);
-	char *new_string;
-	int len = strlen(string) + 1;
-	int ret;
+	struct of_fixup *fixup;
+	unsigned int token;
+	unsigned int *p;
+	char *name;
+	int offset, next;
+	unsigned int i;
 
-	new_string = dt_strings + dt_stringslen;
-	ret = of_blob_move_dt_string(blob, len);
-	if (ret)
-		return ret;
+	if (of_get_token_nextoffset(blob, node, &next, &token))
+		return -1;
 
-	memcpy(new_string, string, len);
+	for (i = 0; i < fixups->count; i++) {
+		fixups->fixup[i].node_offset = next;
+		fixups->fixup[i].prop_offset = -1;
+	}
 
-	*name_offset = new_string - dt_strings;
+	for (offset = of_node_first(blob, node, &token);
+	     (offset >= 0) && (token == OF_DT_TOKEN_PROP);
+	     offset = of_node_next(blob, offset, &token)) {
+		p = of_token(blob, offset);
+		name = of_prop_name(blob, p);
+		for (i = 0; i < fixups->count; i++) {
+			fixup = &fixups->fixup[i];
+			if ((fixup->prop_offset < 0)
+					&& !strcmp(name, fixup->property)) {
+				fixup->prop_offset = offset;
+				fixup->prop_len = 12 + OF_ALIGN(swap_uint32(p[1]));
+			}
+		}
+	}
 
-	return 0;
+	return (offset < 0) ? -1 : 0;
 }
 
-static int of_add_property(void *blob,
-				int nextoffset,
-				const char *property_name,
-				const void *value,
-				int valuelen)
+/*
+ * Set the properties of an overlay node in the target node, by batches
+ * of OF_MAX_FIXUPS: the blob is moved once per batch, not per property.
+ */
+static int of_merge_props(void *blob, int target, void *overlay, int node)
 {
-	int string_offset;
+	struct of_fixups fixups;
+	unsigned int token;
 	unsigned int *p;
-	unsigned int addr;
-	int len;
-	int ret;
+	int offset;
+
+	offset = of_node_first(overlay, node, &token);
+	while ((offset >= 0) && (token == OF_DT_TOKEN_PROP)) {
+		of_fixups_init(&fixups);
+		for (; (offset >= 0) && (token == OF_DT_TOKEN_PROP)
+				&& (fixups.count < OF_MAX_FIXUPS);
+		     offset = of_node_next(overlay, offset, &token)) {
+			p = of_token(overlay, offset);
+			of_fixup_add(&fixups, "", of_prop_name(overlay, p),
+				     p + 3, swap_uint32(p[1]));
+		}
 
-	/* check if the property name in the dt_strings,
-	 * else add the string in dt strings
-	 */
-	ret = of_string_is_find_strings_blob(blob,
-				property_name, &string_offset);
-	if (ret) {
-		ret = of_add_string_strings_blob(blob,
-				property_name, &string_offset);
-		if (ret)
-			return ret;
-	}
-
-	/* add the property node in dt struct */
-	len = 12 + OF_ALIGN(valuelen);
-	addr = of_dt_struct_offset(blob, nextoffset);
-	ret = of_blob_move_dt_struct(blob, (void *)addr, 0, len);
-	if (ret)
-		return ret;
-
-	p = (unsigned int *)addr;
-
-	/* set property node: token, value size, name offset, value */
-	*p++ = swap_uint32(OF_DT_TOKEN_PROP);
-	*p++ = swap_uint32(valuelen);
-	*p++ = swap_uint32(string_offset);
-	memcpy((unsigned char *)p, value, valuelen);
+		if (of_fixups_resolve_props(blob, target, &fixups)
+				|| of_fixups_commit(blob, &fixups))
+			return -1;
+	}
 
-	return 0;
+	return (offset < 0) ? -1 : 0;
 }
 
-static int of_update_property_value(void *blob,
-				int property_offset,
-				const void *value,
-				int valuelen)
+/* copy a node of the overlay with its subnodes at the end of the parent */
+static int of_copy_node(void *blob, int parent,
+			void *overlay, int node, int *strings)
 {
-	int oldlen;
-	unsigned int *plen;
-	unsigned char *pvalue;
-	void *point;
-	int ret;
+	unsigned int token;
+	unsigned int *p;
+	int end, dest, size;
+	int offset, next;
+	int names;
 
-	plen = (unsigned int *)of_dt_struct_offset(blob, property_offset + 4);
-	pvalue = (unsigned char *)of_dt_struct_offset(blob,
-						property_offset + 12);
-	point = (void *)pvalue;
+	end = of_node_end(overlay, node);
+	dest = of_node_end(blob, parent);
+	if ((end < 0) || (dest < 0))
+		return -1;
 
-	/* get the old len of value */
-	oldlen = swap_uint32(*plen);
+	/* before the end token of the parent */
+	dest -= 4;
+	size = end - node;
+	memcpy(of_blob_splice(blob, dest, 0, size),
+	       of_token(overlay, node), size);
 
-	ret = of_blob_move_dt_struct(blob, point,
-			OF_ALIGN(oldlen), OF_ALIGN(valuelen));
-	if (ret)
-		return ret;
+	/* the property names move to the dt strings of the base blob */
+	names = of_overlay_strings(blob, overlay, strings);
+	for (offset = dest; offset < dest + size; offset = next) {
+		if (of_get_token_nextoffset(blob, offset, &next, &token))
+			return -1;
+		if (token != OF_DT_TOKEN_PROP)
+			continue;
 
-	/* set the new len and value */
-	*plen = swap_uint32(valuelen);
-	memcpy(pvalue, value, valuelen);
+		p = of_token(blob, offset);
+		p[2] = swap_uint32(names + swap_uint32(p[2]));
+	}
 
 	return 0;
 }
 
-static int of_set_property(void *blob,
-				int nodeoffset,
-				const char *property_name,
-				void *value,
-				int valuelen)
+static int of_merge_node(void *blob, int target,
+			 void *overlay, int node, int *strings)
 {
-	int property_offset;
-	int ret;
+	unsigned int token;
+	unsigned int *p;
+	char *name;
+	int offset, sub;
 
-	/* If find the property name in the dt blob, update its value,
-	 * else to add this property
-	 */
-	ret = of_get_property_offset_by_name(blob, nodeoffset,
-					property_name, &property_offset);
-	if (ret) {
-		ret = of_add_property(blob, nodeoffset,
-				property_name, value, valuelen);
-		if (ret)
-			dbg_info("DT: fail to add property\n");
+	if (of_merge_props(blob, target, overlay, node))
+		return -1;
 
-		return ret;
-	}
+	for (offset = of_node_first(overlay, node, &token);
+	     (offset >= 0) && (token != OF_DT_TOKEN_NODE_END);
+	     offset = of_node_next(overlay, offset, &token)) {
+		if (token != OF_DT_TOKEN_NODE_BEGIN)
+			continue;
 
-	ret = of_update_property_value(blob, property_offset, value, valuelen);
-	if (ret) {
-		dbg_info("DT: fail to update property\n");
-		return ret;
+		p = of_token(overlay, offset);
+		name = (char *)(p + 1);
+		sub = of_find_subnode(blob, target, name, strlen(name), 1);
+		if (sub >= 0) {
+			if (of_merge_node(blob, sub, overlay, offset, strings))
+				return -1;
+		} else if (of_copy_node(blob, target,
+					overlay, offset, strings)) {
+			return -1;
+		}
 	}
 
-	return 0;
+	return (offset < 0) ? -1 : 0;
 }
 
-/* ---------------------------------------------------- */
+/*
+ * Walk the whole dt struct: return the highest phandle, or move each
+ * phandle up by delta if it is not zero.
+ */
+static unsigned int of_walk_phandles(void *blob, unsigned int delta)
+{
+	unsigned int max = 0;
+	unsigned int token;
+	unsigned int *p;
+	int offset = 0;
+	int nextoffset;
 
-int check_dt_blob_valid(void *blob)
+	while (!of_get_token_nextoffset(blob, offset, &nextoffset, &token)) {
+		if (token == OF_DT_END)
+			break;
+
+		p = of_token(blob, offset);
+		if ((token == OF_DT_TOKEN_PROP)
+				&& (swap_uint32(p[1]) == 4)
+				&& OF_PHANDLE_PROP(of_prop_name(blob, p))) {
+			if (delta)
+				of_write_cell(p + 3, of_read_cell(p + 3) + delta);
+			if (of_read_cell(p + 3) > max)
+				max = of_read_cell(p + 3);
+		}
+		offset = nextoffset;
+	}
+
+	return max;
+}
+
+static int of_find_phandle(void *blob, unsigned int phandle)
 {
-	return ((of_get_magic_number(blob) == OF_DT_MAGIC)
-			&& (of_get_format_version(blob) >= 17)) ? 0 : 1;
+	unsigned int token;
+	unsigned int *p;
+	int offset = 0;
+	int nextoffset;
+	int node = -1;
+
+	while (!of_get_token_nextoffset(blob, offset, &nextoffset, &token)) {
+		if (token == OF_DT_END)
+			break;
+
+		p = of_token(blob, offset);
+		if (token == OF_DT_TOKEN_NODE_BEGIN)
+			node = offset;
+		else if ((token == OF_DT_TOKEN_PROP)
+				&& (swap_uint32(p[1]) == 4)
+				&& (of_read_cell(p + 3) == phandle)
+				&& OF_PHANDLE_PROP(of_prop_name(blob, p)))
+			return node;
+		offset = nextoffset;
+	}
+
+	return -1;
 }
 
-/* The /chosen node
- * property "bootargs": This zero-terminated string is passed
- * as the kernel command line.
+/*
+ * The __local_fixups__ tree mirrors the overlay tree, each property
+ * lists the offsets of the phandle cells in the matching property.
  */
-int fixup_chosen_node(void *blob, char *bootargs)
+static int of_overlay_local_fixups(void *overlay, int fixups,
+				   int node, unsigned int delta)
 {
-	int nodeoffset;
-	char *value = bootargs;
-	int valuelen = strlen(value) + 1;
-	int ret;
+	unsigned int token;
+	unsigned int *p;
+	char *name, *value;
+	unsigned int cell;
+	int offset, sub;
+	int len, vlen, i;
+
+	for (offset = of_node_first(overlay, fixups, &token);
+	     (offset >= 0) && (token != OF_DT_TOKEN_NODE_END);
+	     offset = of_node_next(overlay, offset, &token)) {
+		p = of_token(overlay, offset);
+		if (token == OF_DT_TOKEN_NODE_BEGIN) {
+			name = (char *)(p + 1);
+			sub = of_find_subnode(overlay, node,
+					      name, strlen(name), 1);
+			if ((sub < 0) || of_overlay_local_fixups(overlay,
+							offset, sub, delta))
+				return -1;
+			continue;
+		}
 
-	ret = of_get_node_offset(blob, "chosen", &nodeoffset);
-	if (ret) {
-		dbg_info("DT: doesn't support add node (chosen)\n");
-		return ret;
-	}
+		name = of_prop_name(overlay, p);
+		value = of_get_prop(overlay, node, name, strlen(name), &vlen);
+		if (!value)
+			return -1;
 
-	/*
-	 * if the property doesn't exit, add it
-	 * if the property exists, update it.
-	 */
-	ret = of_set_property(blob, nodeoffset, "bootargs", value, valuelen);
-	if (ret) {
-		dbg_info("fail to set bootargs property\n");
-		return ret;
+		len = swap_uint32(p[1]);
+		for (i = 0; i + 4 <= len; i += 4) {
+			cell = of_read_cell((char *)(p + 3) + i);
+			if ((cell % 4) || (vlen < 4)
+					|| (cell > (unsigned int)vlen - 4))
+				return -1;
+			of_write_cell(value + cell,
+				      of_read_cell(value + cell) + delta);
+		}
 	}
 
-	return 0;
+	return (offset < 0) ? -1 : 0;
 }
 
-/* The /memory node
- * Required properties:
- * - device_type: has to be "memory".
- * - reg: this property contains all the physical memory ranges of your boards.
+/*
+ * Each property of __fixups__ is a label of the base blob, its value
+ * lists the "path:property:offset" of the cells referencing it.
  */
-int fixup_memory_node(void *blob,
-			unsigned int *mem_bank,
-			unsigned int *mem_bank2,
-			unsigned int *mem_size)
+static int of_overlay_fixups(void *blob, void *overlay, int fixups)
 {
-	int nodeoffset;
-	unsigned int data[4];
-	int valuelen;
-	int ret;
+	unsigned int token;
+	unsigned int *p;
+	unsigned int phandle;
+	char *label, *path, *entry, *end;
+	char *prop, *sep, *cell;
+	char *value;
+	int symbols, node;
+	int offset;
+	int len, vlen;
+	unsigned int off;
+
+	symbols = of_path_offset(blob, "/__symbols__", 12);
+	if (symbols < 0) {
+		dbg_info("DT: overlay: no __symbols__ in the base blob\n");
+		return -1;
+	}
+
+	for (offset = of_node_first(overlay, fixups, &token);
+	     (offset >= 0) && (token == OF_DT_TOKEN_PROP);
+	     offset = of_node_next(overlay, offset, &token)) {
+		p = of_token(overlay, offset);
+		label = of_prop_name(overlay, p);
+
+		path = of_get_prop(blob, symbols, label, strlen(label), &len);
+		node = of_is_string(path, len) ?
+			of_path_offset(blob, path, strlen(path)) : -1;
+		value = (node >= 0) ?
+			of_get_prop(blob, node, "phandle", 7, &len) : NULL;
+		if (!value) {
+			dbg_info("DT: overlay: label %s not found\n", label);
+			return -1;
+		}
+		phandle = of_read_cell(value);
+
+		entry = (char *)(p + 3);
+		end = entry + swap_uint32(p[1]);
+		if (!of_is_string(entry, end - entry))
+			return -1;
 
-	ret = of_get_node_offset(blob, "memory", &nodeoffset);
-	if (ret) {
-		dbg_info("DT: doesn't support add node (memory)\n");
-		return ret;
+		for (; entry < end; entry += strlen(entry) + 1) {
+			prop = strchr(entry, ':');
+			sep = prop ? strchr(prop + 1, ':') : NULL;
+			if (!sep)
+				return -1;
+
+			off = 0;
+			for (cell = sep + 1; (*cell >= '0') && (*cell <= '9'); cell++)
+				off = off * 10 + (*cell - '0');
+
+			node = of_path_offset(overlay, entry, prop - entry);
+			value = (node >= 0) ? of_get_prop(overlay, node, prop + 1,
+						sep - prop - 1, &vlen) : NULL;
+			if (!value || (off % 4) || (vlen < 4)
+					|| (off > (unsigned int)vlen - 4))
+				return -1;
+			of_write_cell(value + off, phandle);
+		}
+	}
+
+	return (offset < 0) ? -1 : 0;
+}
+
+/* an overlay with a "board-id" property only applies to this board */
+int of_overlay_match(void *overlay, const char *board_id)
+{
+	char *value;
+	int root;
+	int len;
+
+	if (check_dt_blob_valid(overlay) || of_overlay_check(overlay))
+		return 0;
+
+	root = of_root_node(overlay);
+	if (root < 0)
+		return 0;
+
+	value = of_get_prop(overlay, root, "board-id", 8, &len);
+	if (!value)
+		return 1;
+
+	return board_id && (strlen(board_id) + 1 == len)
+		&& !strcmp(value, board_id);
+}
+
+int of_overlay_apply(void *blob, unsigned int size, void *overlay)
+{
+	unsigned int token;
+	unsigned int delta;
+	char *value;
+	int root, fixups;
+	int offset, node, target;
+	int strings = -1;
+	int len;
+
+	if (check_dt_blob_valid(overlay) || of_overlay_check(overlay)) {
+		dbg_info("DT: overlay: malformed blob\n");
+		return -1;
 	}
 
 	/*
-	 * if the property doesn't exit, add it
-	 * if the property exists, update it.
+	 * The blob grows at most by the dt struct of the overlay, and twice
+	 * its dt strings: the names of the properties set, and the names of
+	 * the nodes copied.
 	 */
-	/* set "device_type" property */
-	ret = of_set_property(blob, nodeoffset,
-			"device_type", "memory", sizeof("memory"));
-	if (ret) {
-		dbg_info("DT: could not set device_type property\n");
-		return ret;
+	if (of_blob_data_size(blob) + of_get_dt_struct_len(overlay)
+			+ 2 * of_get_dt_strings_len(overlay) > size) {
+		dbg_info("DT: overlay: no room left for the blob to grow\n");
+		return -1;
 	}
 
-	/* set "reg" property */
-	data[0] = swap_uint32(*mem_bank);
-	data[1] = swap_uint32(*mem_size);
-	valuelen = 8;
-	if (*mem_bank2) {
-		data[2] = swap_uint32(*mem_bank2);
-		data[3] = swap_uint32(*mem_size);
-		valuelen = 16;
+	root = of_root_node(overlay);
+	if (root < 0)
+		return -1;
+
+	delta = of_walk_phandles(blob, 0);
+	if (delta)
+		of_walk_phandles(overlay, delta);
+
+	fixups = of_find_subnode(overlay, root, "__local_fixups__", 16, 1);
+	if ((fixups >= 0) && delta
+			&& of_overlay_local_fixups(overlay, fixups, root, delta)) {
+		dbg_info("DT: overlay: bad __local_fixups__\n");
+		return -1;
 	}
-	ret = of_set_property(blob, nodeoffset, "reg", data, valuelen);
-	if (ret) {
-		dbg_info("DT: could not set reg property\n");
-		return ret;
+
+	fixups = of_find_subnode(overlay, root, "__fixups__", 10, 1);
+	if ((fixups >= 0) && of_overlay_fixups(blob, overlay, fixups)) {
+		dbg_info("DT: overlay: bad __fixups__\n");
+		return -1;
 	}
 
-	return 0;
+	/* the fragments are the subnodes with an __overlay__ node */
+	for (offset = of_node_first(overlay, root, &token);
+	     (offset >= 0) && (token != OF_DT_TOKEN_NODE_END);
+	     offset = of_node_next(overlay, offset, &token)) {
+		if (token != OF_DT_TOKEN_NODE_BEGIN)
+			continue;
+
+		node = of_find_subnode(overlay, offset, "__overlay__", 11, 1);
+		if (node < 0)
+			continue;
+
+		target = -1;
+		value = of_get_prop(overlay, offset, "target", 6, &len);
+		if (value && (len == 4)) {
+			target = of_find_phandle(blob, of_read_cell(value));
+		} else {
+			value = of_get_prop(overlay, offset,
+					    "target-path", 11, &len);
+			if (of_is_string(value, len))
+				target = of_path_offset(blob,
+							value, strlen(value));
+		}
+
+		if (target < 0) {
+			dbg_info("DT: overlay: %s: target not found\n",
+				 (char *)of_token(overlay, offset + 4));
+			return -1;
+		}
+
+		if (of_merge_node(blob, target, overlay, node, &strings))
+			return -1;
+	}
+
+	return (offset < 0) ? -1 : 0;
+}
+#endif /* #ifdef CONFIG_OF_OVERLAY */
+
+/* ---------------------------------------------------- */
+
+int check_dt_blob_valid(void *blob)
+{
+	return ((of_get_magic_number(blob) == OF_DT_MAGIC)
+			&& (of_get_format_version(blob) >= 17)) ? 0 : 1;
 }
@@ -13,4 +13,10 @@ COBJS-y		+= $(LIB)/div.o
 COBJS-y		+= $(LIB)/consttime_memequal.o
 
 COBJS-$(CONFIG_CRC32)	+= $(LIB)/crc32.o
+COBJS-$(CONFIG_SHA256)	+= $(LIB)/sha256.o
+COBJS-$(CONFIG_P256)	+= $(LIB)/p256.o
+COBJS-$(CONFIG_P256)	+= $(LIB)/p256_mont.o
 COBJS-$(CONFIG_OF_LIBFDT) += $(LIB)/fdt.o
+COBJS-$(CONFIG_DDR_MEMTEST) += $(LIB)/memtest.o
+
+HOTOBJS-y	+= $(LIB)/string.o
@@ -0,0 +1,171 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "memtest.h"
+
+#define PATTERN		0xaaaaaaaa
+#define ANTIPATTERN	0x55555555
+
+static void memtest_error(struct memtest_result *res,
+			  const volatile unsigned int *addr,
+			  unsigned int expected,
+			  unsigned int actual)
+{
+	if (!res->errors) {
+		res->first_addr = (unsigned int)addr;
+		res->expected = expected;
+		res->actual = actual;
+	}
+	res->errors++;
+}
+
+void memtest_fill(unsigned int *start, unsigned int words,
+		  unsigned int pattern)
+{
+	volatile unsigned int *p = start;
+	volatile unsigned int *end = start + words;
+
+	while (p < end) {
+		p[0] = pattern;
+		p[1] = pattern;
+		p[2] = pattern;
+		p[3] = pattern;
+		p += 4;
+	}
+}
+
+void memtest_verify(const unsigned int *start, unsigned int words,
+		    unsigned int pattern, struct memtest_result *res)
+{
+	const volatile unsigned int *p = start;
+	const volatile unsigned int *end = start + words;
+	unsigned int val;
+
+	while (p < end) {
+		val = *p;
+		if (val != pattern)
+			memtest_error(res, p, pattern, val);
+		p++;
+	}
+}
+
+void memtest_invert_up(unsigned int *start, unsigned int words,
+		       unsigned int pattern, struct memtest_result *res)
+{
+	volatile unsigned int *p = start;
+	volatile unsigned int *end = start + words;
+	unsigned int val;
+
+	while (p < end) {
+		val = *p;
+		if (val != pattern)
+			memtest_error(res, p, pattern, val);
+		*p++ = ~pattern;
+	}
+}
+
+void memtest_invert_down(unsigned int *start, unsigned int words,
+			 unsigned int pattern, struct memtest_result *res)
+{
+	volatile unsigned int *p = start + words;
+	unsigned int val;
+
+	while (p > start) {
+		val = *--p;
+		if (val != pattern)
+			memtest_error(res, p, pattern, val);
+		*p = ~pattern;
+	}
+}
+
+void memtest_addr_fill(unsigned int *start, unsigned int words)
+{
+	volatile unsigned int *p = start;
+	volatile unsigned int *end = start + words;
+
+	while (p < end) {
+		*p = (unsigned int)p;
+		p++;
+	}
+}
+
+void memtest_addr_invert(unsigned int *start, unsigned int words,
+			 struct memtest_result *res)
+{
+	volatile unsigned int *p = start;
+	volatile unsigned int *end = start + words;
+	unsigned int val;
+
+	while (p < end) {
+		val = *p;
+		if (val != (unsigned int)p)
+			memtest_error(res, p, (unsigned int)p, val);
+		*p = ~(unsigned int)p;
+		p++;
+	}
+}
+
+void memtest_addr_verify_inv(const unsigned int *start, unsigned int words,
+			     struct memtest_result *res)
+{
+	const volatile unsigned int *p = start;
+	const volatile unsigned int *end = start + words;
+	unsigned int val;
+
+	while (p < end) {
+		val = *p;
+		if (val != ~(unsigned int)p)
+			memtest_error(res, p, ~(unsigned int)p, val);
+		p++;
+	}
+}
+
+void memtest_walking_ones(volatile unsigned int *addr,
+			  struct memtest_result *res)
+{
+	unsigned int pattern;
+
+	for (pattern = 1; pattern; pattern <<= 1) {
+		*addr = pattern;
+		if (*addr != pattern)
+			memtest_error(res, addr, pattern, *addr);
+	}
+}
+
+/*
+ * Write a distinct value at each power of two offset, so a shorted or
+ * stuck address line shows up as an aliased location.
+ */
+void memtest_addr_lines(volatile unsigned int *start, unsigned int size,
+			struct memtest_result *res)
+{
+	unsigned int words = size / sizeof(unsigned int);
+	unsigned int offset, test;
+
+	for (offset = 1; offset < words; offset <<= 1)
+		start[offset] = PATTERN;
+
+	/* Address lines stuck high */
+	start[0] = ANTIPATTERN;
+	for (offset = 1; offset < words; offset <<= 1)
+		if (start[offset] != PATTERN)
+			memtest_error(res, &start[offset],
+				      PATTERN, start[offset]);
+	start[0] = PATTERN;
+
+	/* Address lines stuck low or shorted */
+	for (test = 1; test < words; test <<= 1) {
+		start[test] = ANTIPATTERN;
+
+		if (start[0] != PATTERN)
+			memtest_error(res, &start[0], PATTERN, start[0]);
+
+		for (offset = 1; offset < words; offset <<= 1)
+			if ((offset != test) && (start[offset] != PATTERN))
+				memtest_error(res, &start[offset],
+					      PATTERN, start[offset]);
+
+		start[test] = PATTERN;
+	}
+}
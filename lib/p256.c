@@ -0,0 +1,732 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "p256.h"
+#include "string.h"
+
+/*
+ * ECDSA verification on NIST P-256, for the secure boot.
+ *
+ * The numbers are 8 little endian words. Field elements are kept in the
+ * Montgomery form, a * 2^256 mod p, and the points in Jacobian
+ * coordinates, x = X / Z^2 and y = Y / Z^3, the point at infinity having
+ * Z = 0. Everything checked is public, so nothing needs to run in
+ * constant time.
+ *
+ * u1 * G + u2 * Q costs:
+ * - u1 * G: a comb over two precomputed tables, 32 doublings and up to
+ *   64 mixed additions,
+ * - u2 * Q: windows of 4 bits, 256 doublings and up to 64 additions,
+ * which is some 4000 multiplications modulo p. These go through
+ * p256_mont_mul(), in assembly on ARM.
+ */
+
+#define P256_WORDS	8
+
+struct p256_point {
+	unsigned int	x[P256_WORDS];
+	unsigned int	y[P256_WORDS];
+	unsigned int	z[P256_WORDS];
+};
+
+struct p256_affine {
+	unsigned int	x[P256_WORDS];
+	unsigned int	y[P256_WORDS];
+};
+
+static const unsigned int p256_p[P256_WORDS] = {
+	0xffffffff, 0xffffffff, 0xffffffff, 0x00000000,
+	0x00000000, 0x00000000, 0x00000001, 0xffffffff,
+};
+
+static const unsigned int p256_n[P256_WORDS] = {
+	0xfc632551, 0xf3b9cac2, 0xa7179e84, 0xbce6faad,
+	0xffffffff, 0xffffffff, 0x00000000, 0xffffffff,
+};
+
+/* -1 / n mod 2^32, for the Montgomery reduction modulo n */
+#define P256_N0		0xee00bc4f
+
+/* 2^256 mod p, the Montgomery form of 1 */
+static const unsigned int p256_one[P256_WORDS] = {
+	0x00000001, 0x00000000, 0x00000000, 0xffffffff,
+	0xffffffff, 0xffffffff, 0xfffffffe, 0x00000000,
+};
+
+/* 2^512 mod p, to bring numbers to the Montgomery form */
+static const unsigned int p256_rr_p[P256_WORDS] = {
+	0x00000003, 0x00000000, 0xffffffff, 0xfffffffb,
+	0xfffffffe, 0xffffffff, 0xfffffffd, 0x00000004,
+};
+
+/* 2^512 mod n, to bring Montgomery products modulo n back */
+static const unsigned int p256_rr_n[P256_WORDS] = {
+	0xbe79eea2, 0x83244c95, 0x49bd6fa6, 0x4699799c,
+	0x2b6bec59, 0x2845b239, 0xf3d95620, 0x66e12d94,
+};
+
+/* b of y^2 = x^3 - 3x + b, in the Montgomery form */
+static const unsigned int p256_b[P256_WORDS] = {
+	0x29c4bddf, 0xd89cdf62, 0x78843090, 0xacf005cd,
+	0xf7212ed6, 0xe5a220ab, 0x04874834, 0xdc30061d,
+};
+
+/*
+ * Comb of G, in the Montgomery form: entry j - 1 of table t is the sum
+ * of 2^(32k + 128t) * G for the bits k of j set, for j from 1 to 15.
+ */
+static const struct p256_affine p256_comb[2][15] = {
+	{
+		{	/* 1 */
+			{ 0x18a9143c, 0x79e730d4, 0x5fedb601, 0x75ba95fc,
+			  0x77622510, 0x79fb732b, 0xa53755c6, 0x18905f76 },
+			{ 0xce95560a, 0xddf25357, 0xba19e45c, 0x8b4ab8e4,
+			  0xdd21f325, 0xd2e88688, 0x25885d85, 0x8571ff18 },
+		},
+		{	/* 2 */
+			{ 0x4147519a, 0x20288602, 0x26b372f0, 0xd0981eac,
+			  0xa785ebc8, 0xa9d4a7ca, 0xdbdf58e9, 0xd953c50d },
+			{ 0xfd590f8f, 0x9d6361cc, 0x44e6c917, 0x72e9626b,
+			  0x22eb64cf, 0x7fd96110, 0x9eb288f3, 0x863ebb7e },
+		},
+		{	/* 3 */
+			{ 0x5cdb6485, 0x7856b623, 0x2f0a2f97, 0x808f0ea2,
+			  0x4f7e300b, 0x3e68d954, 0xb5ff80a0, 0x00076055 },
+			{ 0x838d2010, 0x7634eb9b, 0x3243708a, 0x54014fbb,
+			  0x842a6606, 0xe0e47d39, 0x34373ee0, 0x83087761 },
+		},
+		{	/* 4 */
+			{ 0x16a0d2bb, 0x4f922fc5, 0x1a623499, 0x0d5cc16c,
+			  0x57c62c8b, 0x9241cf3a, 0xfd1b667f, 0x2f5e6961 },
+			{ 0xf5a01797, 0x5c15c70b, 0x60956192, 0x3d20b44d,
+			  0x071fdb52, 0x04911b37, 0x8d6f0f7b, 0xf648f916 },
+		},
+		{	/* 5 */
+			{ 0xe137bbbc, 0x9e566847, 0x8a6a0bec, 0xe434469e,
+			  0x79d73463, 0xb1c42761, 0x133d0015, 0x5abe0285 },
+			{ 0xc04c7dab, 0x92aa837c, 0x43260c07, 0x573d9f4c,
+			  0x78e6cc37, 0x0c931562, 0x6b6f7383, 0x94bb725b },
+		},
+		{	/* 6 */
+			{ 0x720f141c, 0xbbf9b48f, 0x2df5bc74, 0x6199b3cd,
+			  0x411045c4, 0xdc3f6129, 0x2f7dc4ef, 0xcdd6bbcb },
+			{ 0xeaf436fd, 0xcca6700b, 0xb99326be, 0x6f647f6d,
+			  0x014f2522, 0x0c0fa792, 0x4bdae5f6, 0xa361bebd },
+		},
+		{	/* 7 */
+			{ 0x597c13c7, 0x28aa2558, 0x50b7c3e1, 0xc38d635f,
+			  0xf3c09d1d, 0x07039aec, 0xc4b5292c, 0xba12ca09 },
+			{ 0x59f91dfd, 0x9e408fa4, 0xceea07fb, 0x3af43b66,
+			  0x9d780b29, 0x1eceb089, 0x701fef4b, 0x53ebb99d },
+		},
+		{	/* 8 */
+			{ 0xb0e63d34, 0x4fe7ee31, 0xa9e54fab, 0xf4600572,
+			  0xd5e7b5a4, 0xc0493334, 0x06d54831, 0x8589fb92 },
+			{ 0x6583553a, 0xaa70f5cc, 0xe25649e5, 0x0879094a,
+			  0x10044652, 0xcc904507, 0x02541c4f, 0xebb0696d },
+		},
+		{	/* 9 */
+			{ 0xac1647c5, 0x4616ca15, 0xc4cf5799, 0xb8127d47,
+			  0x764dfbac, 0xdc666aa3, 0xd1b27da3, 0xeb2820cb },
+			{ 0x6a87e008, 0x9406f8d8, 0x922378f3, 0xd87dfa9d,
+			  0x80ccecb2, 0x56ed2e42, 0x55a7da1d, 0x1f28289b },
+		},
+		{	/* 10 */
+			{ 0x3b89da99, 0xabbaa0c0, 0xb8284022, 0xa6f2d79e,
+			  0xb81c05e8, 0x27847862, 0x05e54d63, 0x337a4b59 },
+			{ 0x21f7794a, 0x3c67500d, 0x7d6d7f61, 0x207005b7,
+			  0x04cfd6e8, 0x0a5a3781, 0xf4c2fbd6, 0x0d65e0d5 },
+		},
+		{	/* 11 */
+			{ 0xb5275d38, 0xd9d09bbe, 0x0be0a358, 0x4268a745,
+			  0x973eb265, 0xf0762ff4, 0x52f4a232, 0xc23da242 },
+			{ 0x0b94520c, 0x5da1b84f, 0xb05bd78e, 0x09666763,
+			  0x94d29ea1, 0x3a4dcb86, 0xc790cff1, 0x19de3b8c },
+		},
+		{	/* 12 */
+			{ 0x26c5fe04, 0x183a716c, 0x3bba1bdb, 0x3b28de0b,
+			  0xa4cb712c, 0x7432c586, 0x91fccbfd, 0xe34dcbd4 },
+			{ 0xaaa58403, 0xb408d46b, 0x82e97a53, 0x9a697486,
+			  0x36aaa8af, 0x9e390127, 0x7b4e0f7f, 0xe7641f44 },
+		},
+		{	/* 13 */
+			{ 0xdf64ba59, 0x7d753941, 0x0b0242fc, 0xd33f10ec,
+			  0xa1581859, 0x4f06dfc6, 0x052a57bf, 0x4a12df57 },
+			{ 0x9439dbd0, 0xbfa6338f, 0xbde53e1f, 0xd3c24bd4,
+			  0x21f1b314, 0xfd5e4ffa, 0xbb5bea46, 0x6af5aa93 },
+		},
+		{	/* 14 */
+			{ 0x10c91999, 0xda10b699, 0x2a580491, 0x0a24b440,
+			  0xb8cc2090, 0x3e0094b4, 0x66a44013, 0x5fe3475a },
+			{ 0xf93e7b4b, 0xb0f8cabd, 0x7c23f91a, 0x292b501a,
+			  0xcd1e6263, 0x42e889ae, 0xecfea916, 0xb544e308 },
+		},
+		{	/* 15 */
+			{ 0x16ddfdce, 0x6478c6e9, 0xf89179e6, 0x2c329166,
+			  0x4d4e67e1, 0x4e8d6e76, 0xa6b0c20b, 0xe0b6b2bd },
+			{ 0xbb7efb57, 0x0d312df2, 0x790c4007, 0x1aac0dde,
+			  0x679bc944, 0xf90336ad, 0x25a63774, 0x71c023de },
+		},
+	},
+	{
+		{	/* 1 */
+			{ 0xbfe20925, 0x62a8c244, 0x8fdce867, 0x91c19ac3,
+			  0xdd387063, 0x5a96a5d5, 0x21d324f6, 0x61d587d4 },
+			{ 0xa37173ea, 0xe87673a2, 0x53778b65, 0x23848008,
+			  0x05bab43e, 0x10f8441e, 0x4621efbe, 0xfa11fe12 },
+		},
+		{	/* 2 */
+			{ 0x6d3549cf, 0xd433e50f, 0xfacd665e, 0x6f33696f,
+			  0xce11fcb4, 0x695bfdac, 0xaf7c9860, 0x810ee252 },
+			{ 0x7159bb2c, 0x65450fe1, 0x758b357b, 0xf7dfbebe,
+			  0xd69fea72, 0x2b057e74, 0x92731745, 0xd485717a },
+		},
+		{	/* 3 */
+			{ 0xfc9877ee, 0xd11d47dc, 0x801d0002, 0xc8b36210,
+			  0x54c260b6, 0xd002c117, 0x6962f046, 0x04c17cd8 },
+			{ 0xb0daddf5, 0x6d9bd094, 0x24ce55c0, 0xbea23575,
+			  0x72da03b5, 0x663356e6, 0xfed97474, 0xf7ba4de9 },
+		},
+		{	/* 4 */
+			{ 0xf4f8b16a, 0x56f8410e, 0xc47b266a, 0x97241afe,
+			  0x6d9c87c1, 0x0a406b8e, 0xcd42ab1b, 0x803f3e02 },
+			{ 0x04dbec69, 0x7f0309a8, 0x3bbad05f, 0xa83b85f7,
+			  0xad8e197f, 0xc6097273, 0x5067adc1, 0xc097440e },
+		},
+		{	/* 5 */
+			{ 0x80ec21fe, 0x5fe14bfe, 0xc255be82, 0xf6ce116a,
+			  0x2f4a5d67, 0x98bc5a07, 0xdb7e63af, 0xfad27148 },
+			{ 0x29ab05b3, 0x90c0b6ac, 0x4e251ae6, 0x37a9a83c,
+			  0xc2aade7d, 0x0a7dc875, 0x9f0e1a84, 0x77387de3 },
+		},
+		{	/* 6 */
+			{ 0x927dafc6, 0x84a9521d, 0x5c09cd19, 0x52c1fb69,
+			  0xf9366dde, 0x9d9581a0, 0xa16d7e64, 0x9abe210b },
+			{ 0x48915220, 0x480af84a, 0x4dd816c6, 0xfa73176a,
+			  0x1681ca5a, 0xc7d53987, 0x87f344b0, 0x7881c257 },
+		},
+		{	/* 7 */
+			{ 0x05058880, 0xd75a3e65, 0x643943f2, 0x7da365ef,
+			  0xfab24925, 0x4147861c, 0xfdb808ff, 0xc5c4bdb0 },
+			{ 0xb272b56b, 0x73513e34, 0x11b9043a, 0xc8327e95,
+			  0xf8844969, 0xfd8ce37d, 0x46c2b6b5, 0x2d56db94 },
+		},
+		{	/* 8 */
+			{ 0x35d0b34a, 0xe3417bc0, 0x8327c0a7, 0x440b386b,
+			  0xac0362d1, 0x8fb7262d, 0xe0cdf943, 0x2c41114c },
+			{ 0xad95a0b1, 0x2ba5cef1, 0x67d54362, 0xc09b37a8,
+			  0x01e486c9, 0x26d6cdd2, 0x42ff9297, 0x20477abf },
+		},
+		{	/* 9 */
+			{ 0xa7bf9b7c, 0xf4f80824, 0x3fbe30d0, 0x365d2320,
+			  0x97cf9ce3, 0xbfbe5320, 0xb3055526, 0xe3604700 },
+			{ 0x6cc6c2c7, 0x4dcb9911, 0xba4cbee6, 0x72683708,
+			  0x637ad9ec, 0xdcded434, 0xa3dee15f, 0x6542d677 },
+		},
+		{	/* 10 */
+			{ 0x15339848, 0x231c210e, 0x70778c8d, 0xe87a28e8,
+			  0x6956e170, 0x9d1de661, 0x2bb09c0b, 0x4ac3c938 },
+			{ 0x6998987d, 0x19be0551, 0xae09f4d6, 0x8b2376c4,
+			  0x1a3f933d, 0x1de0b765, 0xe39705f4, 0x380d94c7 },
+		},
+		{	/* 11 */
+			{ 0xa16bd00a, 0xeb54ea74, 0xf5c0bcc1, 0xd839e9ad,
+			  0x1f9bfc06, 0x092bb7f1, 0x1163dc4e, 0x318f97b3 },
+			{ 0xc30d7138, 0xecc0c5be, 0xabc30220, 0x44e8df23,
+			  0xb0223606, 0x2bb7972f, 0x9a84ff4d, 0xfa41faa1 },
+		},
+		{	/* 12 */
+			{ 0xf67d04c3, 0x2e80937c, 0x89eeb811, 0x1e312be2,
+			  0x92594d60, 0x56b5d887, 0x187fbd3d, 0x0224da14 },
+			{ 0x0c5fe36f, 0x87abb863, 0x4ef51f5f, 0x580f3c60,
+			  0xb3b429ec, 0x964fb1bf, 0x42bfff33, 0x60838ef0 },
+		},
+		{	/* 13 */
+			{ 0x20c26def, 0xf0f58f66, 0x582b2d1e, 0x025585ea,
+			  0x01ce3881, 0xfbe7d79b, 0x303f1730, 0x28ccea01 },
+			{ 0x79644ba5, 0xd1dabcd1, 0x06fff0b8, 0x1fc643e8,
+			  0x66b3e17b, 0xa60a76fc, 0xa1d013bf, 0xc18baf48 },
+		},
+		{	/* 14 */
+			{ 0xaddb7d07, 0x396ef794, 0x24455500, 0x0b4fc742,
+			  0xc78aa3ce, 0xfaff8eac, 0xe8d4d97d, 0x14e9ada5 },
+			{ 0x2f7079e2, 0xdaa480a1, 0xe4b0800e, 0x45baa3cd,
+			  0x7838157d, 0x01765e2d, 0x8e9d9ae8, 0xa0ad4fab },
+		},
+		{	/* 15 */
+			{ 0x0bfc8ff3, 0xc9a1dc0e, 0xe936f42f, 0x14efd82b,
+			  0xcca381ef, 0x67016f7c, 0xed8aee96, 0x1432c1ca },
+			{ 0x70b23c26, 0xec684829, 0x0735b273, 0xa64fe873,
+			  0xeaef0f5a, 0xe389f6e5, 0x5ac8d2c6, 0xcaef480b },
+		},
+	},
+};
+
+static unsigned int bn_add(unsigned int *r, const unsigned int *a,
+			   const unsigned int *b)
+{
+	unsigned long long acc = 0;
+	unsigned int i;
+
+	for (i = 0; i < P256_WORDS; i++) {
+		acc += (unsigned long long)a[i] + b[i];
+		r[i] = acc;
+		acc >>= 32;
+	}
+
+	return acc;
+}
+
+static unsigned int bn_sub(unsigned int *r, const unsigned int *a,
+			   const unsigned int *b)
+{
+	unsigned int borrow = 0;
+	unsigned int i, ai;
+
+	for (i = 0; i < P256_WORDS; i++) {
+		ai = a[i];
+		r[i] = ai - b[i] - borrow;
+		borrow = (ai < b[i]) || (borrow && (ai == b[i]));
+	}
+
+	return borrow;
+}
+
+static int bn_cmp(const unsigned int *a, const unsigned int *b)
+{
+	int i;
+
+	for (i = P256_WORDS - 1; i >= 0; i--)
+		if (a[i] != b[i])
+			return (a[i] > b[i]) ? 1 : -1;
+
+	return 0;
+}
+
+static int bn_is_zero(const unsigned int *a)
+{
+	unsigned int i, acc = 0;
+
+	for (i = 0; i < P256_WORDS; i++)
+		acc |= a[i];
+
+	return !acc;
+}
+
+static void bn_shift_right(unsigned int *a, unsigned int top)
+{
+	unsigned int i;
+
+	for (i = 0; i < P256_WORDS - 1; i++)
+		a[i] = (a[i] >> 1) | (a[i + 1] << 31);
+	a[i] = (a[i] >> 1) | (top << 31);
+}
+
+static void bn_from_bytes(unsigned int *r, const unsigned char *p)
+{
+	unsigned int i;
+
+	for (i = 0; i < P256_WORDS; i++, p += 4)
+		r[P256_WORDS - 1 - i] = ((unsigned int)p[0] << 24)
+			| (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+/*
+ * r = a * b / 2^256 mod m, with a, b < m, word by word of b. Used modulo
+ * n, and modulo p where the assembly is not.
+ */
+static void mont_mul(unsigned int *r, const unsigned int *a,
+		     const unsigned int *b, const unsigned int *m,
+		     unsigned int m0)
+{
+	unsigned int t[P256_WORDS + 2];
+	unsigned long long acc;
+	unsigned int q, i, j;
+
+	memset(t, 0, sizeof(t));
+
+	for (i = 0; i < P256_WORDS; i++) {
+		acc = 0;
+		for (j = 0; j < P256_WORDS; j++) {
+			acc += (unsigned long long)a[j] * b[i] + t[j];
+			t[j] = acc;
+			acc >>= 32;
+		}
+		acc += t[P256_WORDS];
+		t[P256_WORDS] = acc;
+		t[P256_WORDS + 1] = acc >> 32;
+
+		q = t[0] * m0;
+		acc = ((unsigned long long)q * m[0] + t[0]) >> 32;
+		for (j = 1; j < P256_WORDS; j++) {
+			acc += (unsigned long long)q * m[j] + t[j];
+			t[j - 1] = acc;
+			acc >>= 32;
+		}
+		acc += t[P256_WORDS];
+		t[P256_WORDS - 1] = acc;
+		t[P256_WORDS] = t[P256_WORDS + 1] + (acc >> 32);
+	}
+
+	/* t < 2m */
+	if (t[P256_WORDS] || (bn_cmp(t, m) >= 0))
+		bn_sub(t, t, m);
+
+	memcpy(r, t, P256_WORDS * 4);
+}
+
+#ifdef __arm__
+extern void p256_mont_mul(unsigned int *r, const unsigned int *a,
+			  const unsigned int *b);
+
+#define fe_mul(r, a, b)	p256_mont_mul(r, a, b)
+#else
+static void fe_mul(unsigned int *r, const unsigned int *a,
+		   const unsigned int *b)
+{
+	mont_mul(r, a, b, p256_p, 1);
+}
+#endif
+
+#define fe_sqr(r, a)	fe_mul(r, a, a)
+
+static void fe_add(unsigned int *r, const unsigned int *a,
+		   const unsigned int *b)
+{
+	if (bn_add(r, a, b) || (bn_cmp(r, p256_p) >= 0))
+		bn_sub(r, r, p256_p);
+}
+
+static void fe_sub(unsigned int *r, const unsigned int *a,
+		   const unsigned int *b)
+{
+	if (bn_sub(r, a, b))
+		bn_add(r, r, p256_p);
+}
+
+/* dbl-2001-b, for a = -3 */
+static void point_double(struct p256_point *r, const struct p256_point *a)
+{
+	unsigned int delta[P256_WORDS], gamma[P256_WORDS], beta[P256_WORDS];
+	unsigned int alpha[P256_WORDS], t[P256_WORDS], u[P256_WORDS];
+
+	fe_sqr(delta, a->z);
+	fe_sqr(gamma, a->y);
+	fe_mul(beta, a->x, gamma);
+
+	fe_sub(t, a->x, delta);
+	fe_add(u, a->x, delta);
+	fe_mul(t, t, u);
+	fe_add(alpha, t, t);
+	fe_add(alpha, alpha, t);
+
+	fe_add(t, a->y, a->z);
+	fe_sqr(t, t);
+	fe_sub(t, t, gamma);
+	fe_sub(r->z, t, delta);
+
+	fe_add(beta, beta, beta);
+	fe_add(beta, beta, beta);
+	fe_sqr(t, alpha);
+	fe_sub(t, t, beta);
+	fe_sub(r->x, t, beta);
+
+	fe_sub(t, beta, r->x);
+	fe_mul(t, alpha, t);
+	fe_sqr(gamma, gamma);
+	fe_add(gamma, gamma, gamma);
+	fe_add(gamma, gamma, gamma);
+	fe_add(gamma, gamma, gamma);
+	fe_sub(r->y, t, gamma);
+}
+
+/*
+ * r = a + b, from h = u2 - u1 and s = s2 - s1 of the Jacobian addition,
+ * with z the Z of the result before its multiplication by h.
+ */
+static void point_add_finish(struct p256_point *r, const unsigned int *u1,
+			     const unsigned int *s1, const unsigned int *h,
+			     const unsigned int *s, const unsigned int *z)
+{
+	unsigned int hh[P256_WORDS], hhh[P256_WORDS], v[P256_WORDS];
+	unsigned int t[P256_WORDS];
+
+	fe_sqr(hh, h);
+	fe_mul(hhh, h, hh);
+	fe_mul(v, u1, hh);
+
+	fe_sqr(t, s);
+	fe_sub(t, t, hhh);
+	fe_sub(t, t, v);
+	fe_sub(r->x, t, v);
+
+	fe_mul(hhh, s1, hhh);
+	fe_sub(t, v, r->x);
+	fe_mul(t, s, t);
+	fe_sub(r->y, t, hhh);
+
+	fe_mul(r->z, z, h);
+}
+
+/* r = a + b, b not at infinity */
+static void point_add_affine(struct p256_point *r, const struct p256_point *a,
+			     const struct p256_affine *b)
+{
+	unsigned int u1[P256_WORDS], s1[P256_WORDS], z[P256_WORDS];
+	unsigned int h[P256_WORDS], s[P256_WORDS];
+
+	if (bn_is_zero(a->z)) {
+		memcpy(r->x, b->x, sizeof(b->x));
+		memcpy(r->y, b->y, sizeof(b->y));
+		memcpy(r->z, p256_one, sizeof(p256_one));
+		return;
+	}
+
+	fe_sqr(h, a->z);
+	fe_mul(s, a->z, h);
+	fe_mul(h, b->x, h);
+	fe_mul(s, b->y, s);
+	fe_sub(h, h, a->x);
+	fe_sub(s, s, a->y);
+
+	if (bn_is_zero(h)) {
+		if (bn_is_zero(s))
+			point_double(r, a);
+		else
+			memset(r->z, 0, sizeof(r->z));
+		return;
+	}
+
+	memcpy(u1, a->x, sizeof(u1));
+	memcpy(s1, a->y, sizeof(s1));
+	memcpy(z, a->z, sizeof(z));
+	point_add_finish(r, u1, s1, h, s, z);
+}
+
+/* r = a + b */
+static void point_add(struct p256_point *r, const struct p256_point *a,
+		      const struct p256_point *b)
+{
+	unsigned int u1[P256_WORDS], s1[P256_WORDS], z[P256_WORDS];
+	unsigned int h[P256_WORDS], s[P256_WORDS], t[P256_WORDS];
+
+	if (bn_is_zero(a->z)) {
+		memcpy(r, b, sizeof(*r));
+		return;
+	}
+	if (bn_is_zero(b->z)) {
+		memcpy(r, a, sizeof(*r));
+		return;
+	}
+
+	fe_sqr(t, b->z);
+	fe_mul(u1, a->x, t);
+	fe_mul(t, b->z, t);
+	fe_mul(s1, a->y, t);
+
+	fe_sqr(t, a->z);
+	fe_mul(h, b->x, t);
+	fe_mul(t, a->z, t);
+	fe_mul(s, b->y, t);
+
+	fe_sub(h, h, u1);
+	fe_sub(s, s, s1);
+
+	if (bn_is_zero(h)) {
+		if (bn_is_zero(s))
+			point_double(r, a);
+		else
+			memset(r->z, 0, sizeof(r->z));
+		return;
+	}
+
+	fe_mul(z, a->z, b->z);
+	point_add_finish(r, u1, s1, h, s, z);
+}
+
+static unsigned int bn_bit(const unsigned int *k, unsigned int bit)
+{
+	return (k[bit / 32] >> (bit % 32)) & 1;
+}
+
+/* r = k * G: bit c of the 4 blocks of 32 bits of each half of k at once */
+static void point_mul_g(struct p256_point *r, const unsigned int *k)
+{
+	unsigned int t, i, j;
+	int c;
+
+	memset(r, 0, sizeof(*r));
+
+	for (c = 31; c >= 0; c--) {
+		point_double(r, r);
+
+		for (t = 0; t < 2; t++) {
+			j = 0;
+			for (i = 0; i < 4; i++)
+				j |= bn_bit(k, c + 32 * i + 128 * t) << i;
+			if (j)
+				point_add_affine(r, r, &p256_comb[t][j - 1]);
+		}
+	}
+}
+
+/* r = k * q, by windows of 4 bits */
+static void point_mul(struct p256_point *r, const struct p256_affine *q,
+		      const unsigned int *k)
+{
+	static struct p256_point table[15];
+	unsigned int i, j;
+	int w;
+
+	memcpy(table[0].x, q->x, sizeof(q->x));
+	memcpy(table[0].y, q->y, sizeof(q->y));
+	memcpy(table[0].z, p256_one, sizeof(p256_one));
+	point_double(&table[1], &table[0]);
+	for (i = 2; i < 15; i++)
+		point_add_affine(&table[i], &table[i - 1], q);
+
+	memset(r, 0, sizeof(*r));
+
+	for (w = 63; w >= 0; w--) {
+		for (i = 0; i < 4; i++)
+			point_double(r, r);
+
+		j = (k[w / 8] >> (4 * (w % 8))) & 0xf;
+		if (j)
+			point_add(r, r, &table[j - 1]);
+	}
+}
+
+/* r = a / 2 mod n */
+static void scalar_half(unsigned int *a)
+{
+	unsigned int carry = 0;
+
+	if (a[0] & 1)
+		carry = bn_add(a, a, p256_n);
+	bn_shift_right(a, carry);
+}
+
+/* r = 1 / a mod n, 0 < a < n, by the binary extended Euclid algorithm */
+static void scalar_inv(unsigned int *r, const unsigned int *a)
+{
+	unsigned int u[P256_WORDS], v[P256_WORDS];
+	unsigned int x1[P256_WORDS], x2[P256_WORDS];
+	static const unsigned int one[P256_WORDS] = { 1 };
+
+	memcpy(u, a, sizeof(u));
+	memcpy(v, p256_n, sizeof(v));
+	memcpy(x1, one, sizeof(x1));
+	memset(x2, 0, sizeof(x2));
+
+	while (bn_cmp(u, one) && bn_cmp(v, one)) {
+		while (!(u[0] & 1)) {
+			bn_shift_right(u, 0);
+			scalar_half(x1);
+		}
+		while (!(v[0] & 1)) {
+			bn_shift_right(v, 0);
+			scalar_half(x2);
+		}
+
+		if (bn_cmp(u, v) >= 0) {
+			bn_sub(u, u, v);
+			if (bn_sub(x1, x1, x2))
+				bn_add(x1, x1, p256_n);
+		} else {
+			bn_sub(v, v, u);
+			if (bn_sub(x2, x2, x1))
+				bn_add(x2, x2, p256_n);
+		}
+	}
+
+	memcpy(r, bn_cmp(u, one) ? x2 : x1, sizeof(x1));
+}
+
+/* r = a * b mod n */
+static void scalar_mul(unsigned int *r, const unsigned int *a,
+		       const unsigned int *b)
+{
+	mont_mul(r, a, b, p256_n, P256_N0);
+	mont_mul(r, r, p256_rr_n, p256_n, P256_N0);
+}
+
+/* 0 < a < n */
+static int scalar_check(const unsigned int *a)
+{
+	return !bn_is_zero(a) && (bn_cmp(a, p256_n) < 0);
+}
+
+/* Takes x and y below p, and returns q in the Montgomery form */
+static int point_check(struct p256_affine *q)
+{
+	unsigned int lhs[P256_WORDS], rhs[P256_WORDS], t[P256_WORDS];
+
+	if ((bn_cmp(q->x, p256_p) >= 0) || (bn_cmp(q->y, p256_p) >= 0))
+		return -1;
+
+	fe_mul(q->x, q->x, p256_rr_p);
+	fe_mul(q->y, q->y, p256_rr_p);
+
+	/* y^2 = x^3 - 3x + b */
+	fe_sqr(lhs, q->y);
+	fe_sqr(rhs, q->x);
+	fe_mul(rhs, rhs, q->x);
+	fe_add(t, q->x, q->x);
+	fe_add(t, t, q->x);
+	fe_sub(rhs, rhs, t);
+	fe_add(rhs, rhs, p256_b);
+
+	return bn_cmp(lhs, rhs) ? -1 : 0;
+}
+
+int p256_ecdsa_verify(const unsigned char *key,
+		      const unsigned char *digest,
+		      const unsigned char *signature)
+{
+	struct p256_affine q;
+	struct p256_point x, y;
+	unsigned int e[P256_WORDS], r[P256_WORDS], s[P256_WORDS];
+	unsigned int u1[P256_WORDS], u2[P256_WORDS], t[P256_WORDS];
+
+	bn_from_bytes(q.x, key);
+	bn_from_bytes(q.y, key + P256_BYTES);
+	if (point_check(&q))
+		return -1;
+
+	bn_from_bytes(r, signature);
+	bn_from_bytes(s, signature + P256_BYTES);
+	if (!scalar_check(r) || !scalar_check(s))
+		return -1;
+
+	/* 2^256 < 2n */
+	bn_from_bytes(e, digest);
+	if (bn_cmp(e, p256_n) >= 0)
+		bn_sub(e, e, p256_n);
+
+	scalar_inv(t, s);
+	scalar_mul(u1, e, t);
+	scalar_mul(u2, r, t);
+
+	point_mul_g(&x, u1);
+	point_mul(&y, &q, u2);
+	point_add(&x, &x, &y);
+	if (bn_is_zero(x.z))
+		return -1;
+
+	/*
+	 * The x of the sum, below p, is r or r + n modulo n: compare r Z^2
+	 * with X rather than inverting Z.
+	 */
+	fe_sqr(u1, x.z);
+	memcpy(t, r, sizeof(t));
+	do {
+		fe_mul(u2, t, p256_rr_p);
+		fe_mul(u2, u2, u1);
+		if (!bn_cmp(u2, x.x))
+			return 0;
+	} while (!bn_add(t, t, p256_n) && (bn_cmp(t, p256_p) < 0));
+
+	return -1;
+}
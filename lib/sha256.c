@@ -0,0 +1,143 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "sha256.h"
+#include "string.h"
+
+#define ROR(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+
+static const unsigned int sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const unsigned int sha256_iv[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static void sha256_block(unsigned int *state, const unsigned char *p)
+{
+	unsigned int w[16];
+	unsigned int a, b, c, d, e, f, g, h, t1, t2;
+	unsigned int i;
+
+	a = state[0]; b = state[1]; c = state[2]; d = state[3];
+	e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+	/* The schedule is kept as a window of 16 words */
+	for (i = 0; i < 64; i++) {
+		if (i < 16) {
+			w[i] = ((unsigned int)p[0] << 24) | (p[1] << 16)
+				| (p[2] << 8) | p[3];
+			p += 4;
+		} else {
+			unsigned int w1 = w[(i - 15) & 15];
+			unsigned int w14 = w[(i - 2) & 15];
+
+			w[i & 15] += (ROR(w1, 7) ^ ROR(w1, 18) ^ (w1 >> 3))
+				+ w[(i - 7) & 15]
+				+ (ROR(w14, 17) ^ ROR(w14, 19) ^ (w14 >> 10));
+		}
+
+		t1 = h + (ROR(e, 6) ^ ROR(e, 11) ^ ROR(e, 25))
+			+ ((e & f) ^ (~e & g)) + sha256_k[i] + w[i & 15];
+		t2 = (ROR(a, 2) ^ ROR(a, 13) ^ ROR(a, 22))
+			+ ((a & b) ^ (a & c) ^ (b & c));
+		h = g; g = f; f = e; e = d + t1;
+		d = c; c = b; b = a; a = t1 + t2;
+	}
+
+	state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+	state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+void sha256_init(struct sha256_ctx *ctx)
+{
+	memcpy(ctx->state, sha256_iv, sizeof(sha256_iv));
+	ctx->count = 0;
+}
+
+void sha256_update(struct sha256_ctx *ctx, const void *data, unsigned int len)
+{
+	const unsigned char *p = data;
+	unsigned int used = ctx->count & (SHA256_BLOCK_SIZE - 1);
+	unsigned int n;
+
+	ctx->count += len;
+
+	if (used) {
+		n = SHA256_BLOCK_SIZE - used;
+		if (n > len)
+			n = len;
+		memcpy(ctx->buf + used, p, n);
+		p += n;
+		len -= n;
+		if (used + n < SHA256_BLOCK_SIZE)
+			return;
+		sha256_block(ctx->state, ctx->buf);
+	}
+
+	for (; len >= SHA256_BLOCK_SIZE; len -= SHA256_BLOCK_SIZE) {
+		sha256_block(ctx->state, p);
+		p += SHA256_BLOCK_SIZE;
+	}
+
+	memcpy(ctx->buf, p, len);
+}
+
+/*
+ * The block holds the last used bytes of the message, the padding may
+ * need a second block: returns the number of blocks to process.
+ */
+unsigned int sha256_pad(unsigned char *block, unsigned int used,
+			unsigned int count)
+{
+	unsigned int blocks = (used < SHA256_BLOCK_SIZE - 8) ? 1 : 2;
+	unsigned char *end = block + blocks * SHA256_BLOCK_SIZE;
+
+	block[used] = 0x80;
+	memset(block + used + 1, 0, blocks * SHA256_BLOCK_SIZE - used - 1);
+
+	end[-5] = count >> 29;
+	end[-4] = count >> 21;
+	end[-3] = count >> 13;
+	end[-2] = count >> 5;
+	end[-1] = count << 3;
+
+	return blocks;
+}
+
+void sha256_final(struct sha256_ctx *ctx, unsigned char *digest)
+{
+	unsigned char pad[2 * SHA256_BLOCK_SIZE];
+	unsigned int used = ctx->count & (SHA256_BLOCK_SIZE - 1);
+	unsigned int blocks, i;
+
+	memcpy(pad, ctx->buf, used);
+	blocks = sha256_pad(pad, used, ctx->count);
+	for (i = 0; i < blocks; i++)
+		sha256_block(ctx->state, pad + i * SHA256_BLOCK_SIZE);
+
+	for (i = 0; i < 8; i++) {
+		digest[4 * i] = ctx->state[i] >> 24;
+		digest[4 * i + 1] = ctx->state[i] >> 16;
+		digest[4 * i + 2] = ctx->state[i] >> 8;
+		digest[4 * i + 3] = ctx->state[i];
+	}
+}
@@ -16,6 +16,9 @@
 #include "autoconf.h"
 #include "optee.h"
 #include "sfr_aicredir.h"
+#include "ddr_bench.h"
+#include "memtest.h"
+#include "debug.h"
 
 #ifdef CONFIG_CACHES
 #include "l1cache.h"
@@ -40,6 +43,10 @@ int main(void)
 #endif
 	int ret = 0;
 
+#ifdef CONFIG_BACKUP_RESUME_LATENCY
+	backup_latency_start();
+#endif
+
 	hw_init();
 
 #ifdef CONFIG_OCMS_STATIC
@@ -64,9 +71,16 @@ int main(void)
 #endif
 		slowclk_switch_osc32();
 
+#ifdef CONFIG_BACKUP_RESUME_LATENCY
+		dbg_info("BKP: resume took %d us\n", backup_latency_stop());
+#endif
+
 		/* ...jump to Linux here */
 		return ret;
 	}
+#ifdef CONFIG_BACKUP_RESUME_LATENCY
+	backup_latency_stop();
+#endif
 	usart_puts("Backup mode enabled\n");
 #endif
 
@@ -100,6 +114,17 @@ int main(void)
 	hw_postinit();
 #endif
 
+#ifdef CONFIG_DDR_BENCHMARK
+	ddram_benchmark();
+#endif
+
+#ifdef CONFIG_DDR_MEMTEST
+	if (ddram_memtest()) {
+		usart_puts("DRAM test failed\n");
+		while (1);
+	}
+#endif
+
 #ifdef CONFIG_LOAD_SW
 	init_load_image(&image);
 
@@ -126,8 +151,11 @@ int main(void)
 #endif
 
 #if defined(CONFIG_SECURE)
+#ifndef CONFIG_AB_SLOTS
+	/* the A/B slots check the image as it is loaded */
 	if (!ret)
 		ret = secure_check(image.dest);
+#endif
 	image.dest += sizeof(at91_secure_header_t);
 #endif
 
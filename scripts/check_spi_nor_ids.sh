@@ -0,0 +1,17 @@
+#!/bin/sh
+
+# Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+#
+# SPDX-License-Identifier: MIT
+
+# spi_nor_read_id() binary searches spi_nor_ids[]: fail the build when the
+# table is not sorted by JEDEC ID.
+#
+#	check_spi_nor_ids.sh <spi_nor_ids.c>
+
+sed -n '/spi_nor_ids\[\] = {/,/^};/p' "$1" \
+	| sed -n 's/^[[:space:]]*{ *[A-Z0-9_]*("[^"]*", *0x\([0-9a-fA-F]*\).*/\1/p' \
+	| tr 'A-F' 'a-f' | LC_ALL=C sort -c 2>/dev/null && exit 0
+
+echo "[Failed***] $1: spi_nor_ids[] is not sorted by JEDEC ID"
+exit 1
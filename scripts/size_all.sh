@@ -0,0 +1,39 @@
+#!/bin/sh
+
+# Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+#
+# SPDX-License-Identifier: MIT
+
+# Build every defconfig given (all of configs/ by default) in its own build
+# directory, and print the size of each against its budget. The .config of
+# the tree is kept. Exits non zero when a build fails or is over budget.
+
+top=`dirname $0`/..
+cd $top || exit 1
+
+[ $# -eq 0 ] && set -- `ls configs | grep '_defconfig$'`
+
+[ -f .config ] && cp .config .config.size-all
+mkdir -p build/size
+status=0
+
+for defconfig in "$@"; do
+	name=`basename $defconfig _defconfig`
+	builddir=build/size/$name
+
+	if ! make $defconfig > /dev/null 2>&1 || \
+	   ! make BUILDDIR=$builddir > $builddir.log 2>&1; then
+		echo "$name: build failed, see $builddir.log"
+		status=1
+		continue
+	fi
+
+	budget=`sed -n 's/^CONFIG_SIZE_BUDGET=//p' .config`
+	map=`ls $builddir/binaries/*.map | head -1`
+	printf "%s: " $name
+	scripts/size_report.py --summary --budget ${budget:-0} $map || status=1
+done
+
+[ -f .config.size-all ] && mv .config.size-all .config
+
+exit $status
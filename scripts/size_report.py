@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+#
+# SPDX-License-Identifier: MIT
+
+"""
+Report the size each object adds to the binary, from the linker map file,
+and optionally fail when the image loaded by the ROM code exceeds a budget.
+That image is the binary of the map file, or the file given by --image when
+it is made from it, like the LZ4 packed one.
+
+	size_report.py [--budget BYTES] [--image FILE] [--summary] <map file>
+"""
+
+import os
+import re
+import sys
+
+SECTION_TYPES = (".text", ".data", ".bss")
+
+def parse_map(path):
+    objects = {}
+    symbols = {}
+    output = None
+    pending = None
+
+    with open(path) as f:
+        lines = f.read().split("\n")
+
+    try:
+        start = lines.index("Linker script and memory map")
+    except ValueError:
+        sys.exit("%s: not a linker map file" % path)
+
+    for line in lines[start + 1:]:
+        m = re.match(r"^(\.[\w.]+)\s", line + " ")
+        if m:
+            output = m.group(1)
+            pending = None
+            continue
+
+        m = re.match(r"^\s+0x([0-9a-f]+)\s+(_romsize|_sramsize)\s+=", line)
+        if m:
+            symbols[m.group(2)] = int(m.group(1), 16)
+            continue
+
+        # An input section, its name may be alone on the line before
+        m = re.match(r"^ (\.\S+|COMMON)\s*$", line)
+        if m:
+            pending = m.group(1)
+            continue
+        m = re.match(r"^ (\.\S+|COMMON)?\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S+\.o)\s*$",
+                     line)
+        if not m or not output or not (m.group(1) or pending):
+            pending = None
+            continue
+        pending = None
+
+        size = int(m.group(3), 16)
+        if not size or output not in SECTION_TYPES:
+            continue
+
+        sizes = objects.setdefault(m.group(4), dict.fromkeys(SECTION_TYPES, 0))
+        sizes[output] += size
+
+    return objects, symbols
+
+def main():
+    args = sys.argv[1:]
+    budget = 0
+    image = None
+    summary = False
+
+    while args and args[0].startswith("--"):
+        opt = args.pop(0)
+        if opt == "--budget":
+            budget = int(args.pop(0), 0)
+        elif opt == "--image":
+            image = args.pop(0)
+        elif opt == "--summary":
+            summary = True
+        else:
+            sys.exit(__doc__)
+    if len(args) != 1:
+        sys.exit(__doc__)
+
+    objects, symbols = parse_map(args[0])
+    totals = dict.fromkeys(SECTION_TYPES, 0)
+    for sizes in objects.values():
+        for sect in SECTION_TYPES:
+            totals[sect] += sizes[sect]
+
+    romsize = symbols.get("_romsize", totals[".text"] + totals[".data"])
+    sramsize = symbols.get("_sramsize", romsize + totals[".bss"])
+
+    if not summary:
+        print("%8s %8s %8s %6s  %s" % ("text", "data", "bss", "rom%", "object"))
+        for obj, sizes in sorted(objects.items(),
+                                 key=lambda o: -(o[1][".text"] + o[1][".data"])):
+            rom = sizes[".text"] + sizes[".data"]
+            print("%8d %8d %8d %5.1f%%  %s" % (sizes[".text"], sizes[".data"],
+                  sizes[".bss"], 100.0 * rom / romsize if romsize else 0, obj))
+        print("%8d %8d %8d %6s  %s" % (totals[".text"], totals[".data"],
+              totals[".bss"], "", "(total)"))
+
+    line = "rom %d bytes, sram %d bytes" % (romsize, sramsize)
+    loaded = romsize
+    if image:
+        loaded = os.path.getsize(image)
+        line += ", image %d bytes" % loaded
+    if budget:
+        line += ", budget %d bytes (%+d)" % (budget, loaded - budget)
+    print(line)
+
+    if budget and loaded > budget:
+        print("[Failed***] The binary is over its size budget")
+        return 2
+
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())